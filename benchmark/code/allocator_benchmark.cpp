@@ -0,0 +1,829 @@
+#include "benchmark.h"
+#include <bit/core/memory.h>
+#include <bit/core/memory/linear_allocator.h>
+#include <bit/core/memory/system/tlsf_allocator.h>
+#include <bit/core/memory/system/small_block_allocator.h>
+#include <bit/core/memory/system/page_allocator.h>
+#include <bit/core/memory/system/allocation_trace.h>
+#include <bit/core/os/virtual_memory.h>
+#include <bit/core/os/atomics.h>
+#include <bit/core/os/thread.h>
+#include <bit/core/os/os.h>
+#include <bit/container/array.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <malloc.h>
+#include <math.h>
+
+/* Compares the bit allocators against the C runtime malloc. Every workload is generated up front
+   as a trace of operations from a fixed seed, so all allocators replay exactly the same sequence.
+   Reports ns/op, p50/p99 latency of sampled operations, peak committed bytes reported by the
+   allocator and peak RSS growth of the process. Harness memory comes from malloc. */
+
+enum class TraceOpType : uint8_t
+{
+	TRACE_OP_ALLOCATE,
+	TRACE_OP_FREE,
+	TRACE_OP_REALLOCATE,
+	TRACE_OP_FREE_ALL /* Frees every live block. Allocators that can be reset do that instead. */
+};
+
+struct TraceOp
+{
+	TraceOpType Type;
+	uint32_t Slot;
+	uint32_t Size;
+	uint32_t Alignment;
+};
+
+struct AllocationTrace
+{
+	AllocationTrace(const char* Name, size_t MaxOpCount, uint32_t SlotCount) :
+		Name(Name),
+		Ops((TraceOp*)malloc(MaxOpCount * sizeof(TraceOp))),
+		OpCount(0),
+		MaxOpCount(MaxOpCount),
+		SlotCount(SlotCount),
+		bHasFrees(false)
+	{}
+
+	~AllocationTrace()
+	{
+		free(Ops);
+	}
+
+	void Push(TraceOpType Type, uint32_t Slot, uint32_t Size, uint32_t Alignment = (uint32_t)bit::DEFAULT_ALIGNMENT)
+	{
+		SlotCount = bit::Max(SlotCount, Slot + 1);
+		if (OpCount == MaxOpCount)
+		{
+			MaxOpCount *= 2;
+			Ops = (TraceOp*)realloc(Ops, MaxOpCount * sizeof(TraceOp));
+		}
+		Ops[OpCount++] = { Type, Slot, Size, Alignment };
+		// FREE_ALL doesn't count, LinearAllocator can replay it with Reset
+		bHasFrees |= Type == TraceOpType::TRACE_OP_FREE || Type == TraceOpType::TRACE_OP_REALLOCATE;
+	}
+
+	const char* Name;
+	TraceOp* Ops;
+	size_t OpCount;
+	size_t MaxOpCount;
+	uint32_t SlotCount;
+	bool bHasFrees;
+};
+
+/* xorshift64 */
+struct BenchRandom
+{
+	BenchRandom(uint64_t Seed) : State(Seed) {}
+	uint64_t Next() { State ^= State << 13; State ^= State >> 7; State ^= State << 17; return State; }
+	uint32_t NextRange(uint32_t Max) { return (uint32_t)(Next() % Max); }
+	double NextUnit() { return (double)((Next() >> 11) + 1) * (1.0 / 9007199254740992.0); } // (0, 1]
+	uint64_t State;
+};
+
+/* Pareto distributed sizes. Small sizes dominate but the tail still reaches MaxSize. */
+static uint32_t PowerLawSize(BenchRandom& Random, uint32_t MinSize, uint32_t MaxSize, double Alpha)
+{
+	double Size = (double)MinSize / pow(Random.NextUnit(), 1.0 / Alpha);
+	return Size >= (double)MaxSize ? MaxSize : (uint32_t)Size;
+}
+
+/* Picks a random slot every step. Empty slots get allocated and live ones freed
+   so about half of the slots stay live. */
+static void BuildChurnTrace(AllocationTrace& Trace, size_t StepCount, uint32_t MinSize, uint32_t MaxSize, double Alpha, uint64_t Seed)
+{
+	BenchRandom Random(Seed);
+	bool* Live = (bool*)calloc(Trace.SlotCount, sizeof(bool));
+	for (size_t Step = 0; Step < StepCount; ++Step)
+	{
+		uint32_t Slot = Random.NextRange(Trace.SlotCount);
+		if (Live[Slot])
+		{
+			Trace.Push(TraceOpType::TRACE_OP_FREE, Slot, 0);
+		}
+		else
+		{
+			uint32_t Size = MinSize == MaxSize ? MinSize : PowerLawSize(Random, MinSize, MaxSize, Alpha);
+			Trace.Push(TraceOpType::TRACE_OP_ALLOCATE, Slot, Size);
+		}
+		Live[Slot] = !Live[Slot];
+	}
+	Trace.Push(TraceOpType::TRACE_OP_FREE_ALL, 0, 0);
+	free(Live);
+}
+
+/* Buffers grow by 1.5x in random order and start over once they get past MaxSize */
+static void BuildReallocTrace(AllocationTrace& Trace, size_t StepCount, uint32_t MinSize, uint32_t MaxSize, uint64_t Seed)
+{
+	BenchRandom Random(Seed);
+	uint32_t* Sizes = (uint32_t*)calloc(Trace.SlotCount, sizeof(uint32_t));
+	for (size_t Step = 0; Step < StepCount; ++Step)
+	{
+		uint32_t Slot = Random.NextRange(Trace.SlotCount);
+		uint32_t Size = Sizes[Slot];
+		if (Size == 0)
+		{
+			Sizes[Slot] = MinSize;
+			Trace.Push(TraceOpType::TRACE_OP_ALLOCATE, Slot, MinSize);
+		}
+		else if (Size + Size / 2 > MaxSize)
+		{
+			Sizes[Slot] = 0;
+			Trace.Push(TraceOpType::TRACE_OP_FREE, Slot, 0);
+		}
+		else
+		{
+			Sizes[Slot] = Size + Size / 2;
+			Trace.Push(TraceOpType::TRACE_OP_REALLOCATE, Slot, Sizes[Slot]);
+		}
+	}
+	Trace.Push(TraceOpType::TRACE_OP_FREE_ALL, 0, 0);
+	free(Sizes);
+}
+
+/* Per frame scratch memory. Every slot is allocated once and all of them are released together. */
+static void BuildFrameTrace(AllocationTrace& Trace, size_t FrameCount, uint32_t MinSize, uint32_t MaxSize, uint64_t Seed)
+{
+	BenchRandom Random(Seed);
+	for (size_t Frame = 0; Frame < FrameCount; ++Frame)
+	{
+		for (uint32_t Slot = 0; Slot < Trace.SlotCount; ++Slot)
+		{
+			Trace.Push(TraceOpType::TRACE_OP_ALLOCATE, Slot, PowerLawSize(Random, MinSize, MaxSize, 1.2));
+		}
+		Trace.Push(TraceOpType::TRACE_OP_FREE_ALL, 0, 0);
+	}
+}
+
+/* Maps live block addresses of a recorded trace to replay slots. Open addressing with
+   linear probing and backward shift deletion. */
+struct AddressSlotMap
+{
+	static constexpr uint32_t INVALID_SLOT = 0xFFFFFFFF;
+
+	AddressSlotMap() :
+		Addresses(nullptr),
+		Slots(nullptr),
+		Capacity(0),
+		Count(0)
+	{
+		Grow(4096);
+	}
+
+	~AddressSlotMap()
+	{
+		free(Addresses);
+		free(Slots);
+	}
+
+	uint32_t Find(uint64_t Address) const
+	{
+		for (size_t Index = Hash(Address);; Index = (Index + 1) & (Capacity - 1))
+		{
+			if (Addresses[Index] == Address) return Slots[Index];
+			if (Addresses[Index] == 0) return INVALID_SLOT;
+		}
+	}
+
+	void Insert(uint64_t Address, uint32_t Slot)
+	{
+		if ((Count + 1) * 2 > Capacity) Grow(Capacity * 2);
+		size_t Index = Hash(Address);
+		while (Addresses[Index] != 0 && Addresses[Index] != Address) Index = (Index + 1) & (Capacity - 1);
+		Count += Addresses[Index] == 0 ? 1 : 0;
+		Addresses[Index] = Address;
+		Slots[Index] = Slot;
+	}
+
+	void Remove(uint64_t Address)
+	{
+		size_t Index = Hash(Address);
+		while (Addresses[Index] != Address)
+		{
+			if (Addresses[Index] == 0) return;
+			Index = (Index + 1) & (Capacity - 1);
+		}
+		// Pull back every following entry that would become unreachable through the hole
+		for (size_t Next = (Index + 1) & (Capacity - 1); Addresses[Next] != 0; Next = (Next + 1) & (Capacity - 1))
+		{
+			size_t Home = Hash(Addresses[Next]);
+			if (((Next - Home) & (Capacity - 1)) >= ((Next - Index) & (Capacity - 1)))
+			{
+				Addresses[Index] = Addresses[Next];
+				Slots[Index] = Slots[Next];
+				Index = Next;
+			}
+		}
+		Addresses[Index] = 0;
+		Count -= 1;
+	}
+
+private:
+	size_t Hash(uint64_t Address) const
+	{
+		return (size_t)((Address * 0x9E3779B97F4A7C15ULL) >> 32) & (Capacity - 1);
+	}
+
+	void Grow(size_t NewCapacity)
+	{
+		uint64_t* OldAddresses = Addresses;
+		uint32_t* OldSlots = Slots;
+		size_t OldCapacity = Capacity;
+		Addresses = (uint64_t*)calloc(NewCapacity, sizeof(uint64_t));
+		Slots = (uint32_t*)malloc(NewCapacity * sizeof(uint32_t));
+		Capacity = NewCapacity;
+		Count = 0;
+		for (size_t Index = 0; Index < OldCapacity; ++Index)
+		{
+			if (OldAddresses[Index] != 0) Insert(OldAddresses[Index], OldSlots[Index]);
+		}
+		free(OldAddresses);
+		free(OldSlots);
+	}
+
+	uint64_t* Addresses;
+	uint32_t* Slots;
+	size_t Capacity;
+	size_t Count;
+};
+
+/* Converts a trace file written by bit::StartAllocationTrace into replayable operations.
+   Addresses are turned into slots, frees of blocks allocated before recording started are
+   dropped and reallocations of unknown blocks become allocations. */
+static bool LoadTraceFile(AllocationTrace& Trace, const char* Path)
+{
+	bit::AllocationTraceReader Reader;
+	if (!Reader.Open(Path)) return false;
+	AddressSlotMap LiveSlots;
+	uint32_t* FreeSlots = (uint32_t*)malloc(sizeof(uint32_t));
+	uint32_t FreeSlotCount = 0;
+	uint32_t MaxFreeSlotCount = 1;
+	uint32_t NextSlot = 0;
+	auto ReleaseSlot = [&](uint64_t Address, uint32_t Slot)
+	{
+		LiveSlots.Remove(Address);
+		if (FreeSlotCount == MaxFreeSlotCount)
+		{
+			MaxFreeSlotCount *= 2;
+			FreeSlots = (uint32_t*)realloc(FreeSlots, MaxFreeSlotCount * sizeof(uint32_t));
+		}
+		FreeSlots[FreeSlotCount++] = Slot;
+	};
+	auto AcquireSlot = [&](uint64_t Address)
+	{
+		// Events of different threads can interleave around a reallocation, so the address
+		// may still be live in the trace. The old block is gone either way.
+		uint32_t StaleSlot = LiveSlots.Find(Address);
+		if (StaleSlot != AddressSlotMap::INVALID_SLOT)
+		{
+			Trace.Push(TraceOpType::TRACE_OP_FREE, StaleSlot, 0);
+			ReleaseSlot(Address, StaleSlot);
+		}
+		uint32_t Slot = FreeSlotCount > 0 ? FreeSlots[--FreeSlotCount] : NextSlot++;
+		LiveSlots.Insert(Address, Slot);
+		return Slot;
+	};
+
+	bit::AllocationEvent Event;
+	while (Reader.Read(Event))
+	{
+		uint32_t Alignment = 1u << Event.AlignmentShift;
+		if (Event.Type == bit::AllocationEventType::EVENT_ALLOCATE)
+		{
+			if (Event.Address == 0) continue;
+			Trace.Push(TraceOpType::TRACE_OP_ALLOCATE, AcquireSlot(Event.Address), (uint32_t)Event.Size, Alignment);
+		}
+		else if (Event.Type == bit::AllocationEventType::EVENT_FREE)
+		{
+			uint32_t Slot = LiveSlots.Find(Event.Address);
+			if (Slot == AddressSlotMap::INVALID_SLOT) continue;
+			Trace.Push(TraceOpType::TRACE_OP_FREE, Slot, 0);
+			ReleaseSlot(Event.Address, Slot);
+		}
+		else if (Event.Address != 0)
+		{
+			uint32_t Slot = Event.PrevAddress != 0 ? LiveSlots.Find(Event.PrevAddress) : AddressSlotMap::INVALID_SLOT;
+			if (Slot == AddressSlotMap::INVALID_SLOT)
+			{
+				Trace.Push(TraceOpType::TRACE_OP_ALLOCATE, AcquireSlot(Event.Address), (uint32_t)Event.Size, Alignment);
+			}
+			else if (Event.Address != Event.PrevAddress)
+			{
+				LiveSlots.Remove(Event.PrevAddress);
+				uint32_t StaleSlot = LiveSlots.Find(Event.Address);
+				if (StaleSlot != AddressSlotMap::INVALID_SLOT)
+				{
+					Trace.Push(TraceOpType::TRACE_OP_FREE, StaleSlot, 0);
+					ReleaseSlot(Event.Address, StaleSlot);
+				}
+				LiveSlots.Insert(Event.Address, Slot);
+				Trace.Push(TraceOpType::TRACE_OP_REALLOCATE, Slot, (uint32_t)Event.Size, Alignment);
+			}
+			else
+			{
+				Trace.Push(TraceOpType::TRACE_OP_REALLOCATE, Slot, (uint32_t)Event.Size, Alignment);
+			}
+		}
+	}
+	Trace.Push(TraceOpType::TRACE_OP_FREE_ALL, 0, 0);
+	free(FreeSlots);
+	return true;
+}
+
+/* Records the allocations of real container code on the global allocator: Arrays filled
+   one element at a time and destroyed in random order, like the sample program does. */
+static void RecordContainerTrace(AllocationTrace& Trace, size_t StepCount, uint64_t Seed)
+{
+	static constexpr uint32_t ARRAY_COUNT = 512;
+	static const char* TRACE_PATH = "allocator_benchmark.trace";
+	if (!bit::StartAllocationTrace(TRACE_PATH))
+	{
+		BENCH_LOG("Failed to start allocation trace %s", TRACE_PATH);
+		return;
+	}
+	BenchRandom Random(Seed);
+	bit::Array<uint8_t>* Arrays[ARRAY_COUNT] = {};
+	for (size_t Step = 0; Step < StepCount; ++Step)
+	{
+		uint32_t Index = Random.NextRange(ARRAY_COUNT);
+		if (Arrays[Index] == nullptr)
+		{
+			Arrays[Index] = bit::New<bit::Array<uint8_t>>();
+		}
+		else if (Random.NextRange(16) == 0)
+		{
+			bit::Delete(Arrays[Index]);
+			Arrays[Index] = nullptr;
+		}
+		else
+		{
+			uint32_t Count = PowerLawSize(Random, 1, 2048, 1.2);
+			for (uint32_t Element = 0; Element < Count; ++Element)
+			{
+				Arrays[Index]->Add((uint8_t)Element);
+			}
+		}
+	}
+	for (uint32_t Index = 0; Index < ARRAY_COUNT; ++Index)
+	{
+		if (Arrays[Index] != nullptr) bit::Delete(Arrays[Index]);
+	}
+	bit::StopAllocationTrace();
+	LoadTraceFile(Trace, TRACE_PATH);
+	remove(TRACE_PATH);
+}
+
+/* The C runtime doesn't report committed bytes so only RSS is available for it.
+   Traces never ask for more than the malloc alignment. */
+struct SystemMallocAdapter : public bit::IAllocator
+{
+	SystemMallocAdapter() : IAllocator("SystemMalloc") {}
+	void* Allocate(size_t Size, size_t) override { return malloc(Size); }
+	void* Reallocate(void* Pointer, size_t Size, size_t) override { return realloc(Pointer, Size); }
+	void Free(void* Pointer) override { free(Pointer); }
+#if BIT_PLATFORM_WINDOWS
+	size_t GetSize(void* Pointer) override { return _msize(Pointer); }
+#else
+	size_t GetSize(void* Pointer) override { return malloc_usable_size(Pointer); }
+#endif
+	bit::AllocatorMemoryInfo GetMemoryUsageInfo() override { return {}; }
+	bool CanAllocate(size_t, size_t) override { return true; }
+	bool OwnsAllocation(const void*) override { return true; }
+};
+
+struct TLSFAdapter : public bit::IAllocator
+{
+	TLSFAdapter() : IAllocator("TLSFAllocator") {}
+	void* Allocate(size_t Size, size_t Alignment) override { return Impl.Allocate(Size, Alignment); }
+	void* Reallocate(void* Pointer, size_t Size, size_t Alignment) override { return Impl.Reallocate(Pointer, Size, Alignment); }
+	void Free(void* Pointer) override { Impl.Free(Pointer); }
+	size_t GetSize(void* Pointer) override { return Impl.GetSize(Pointer); }
+	bit::AllocatorMemoryInfo GetMemoryUsageInfo() override { return Impl.GetMemoryUsageInfo(); }
+	bool CanAllocate(size_t Size, size_t Alignment) override { return Impl.CanAllocate(Size, Alignment); }
+	bool OwnsAllocation(const void* Ptr) override { return Impl.OwnsAllocation(Ptr); }
+	size_t Compact() override { return Impl.Compact(); }
+	bit::TLSFAllocator Impl;
+};
+
+/* Allocates through a heap owned by the benchmark thread, or through the locked shared heap
+   when bShared is set so any thread can use it. */
+struct SmallBlockAdapter : public bit::IAllocator
+{
+	SmallBlockAdapter(bool bShared) : IAllocator("SmallBlockAllocator"), Heap(nullptr), bShared(bShared) {}
+	~SmallBlockAdapter() { Impl.AbandonHeap(&Heap); }
+	void* Allocate(size_t Size, size_t Alignment) override { return bShared ? Impl.Allocate(Size, Alignment) : Impl.Allocate(&Heap, Size, Alignment); }
+	void Free(void* Pointer) override { Impl.Free(bShared ? nullptr : &Heap, Pointer); }
+	size_t GetSize(void* Pointer) override { return Impl.GetSize(Pointer); }
+	bit::AllocatorMemoryInfo GetMemoryUsageInfo() override { return Impl.GetMemoryUsageInfo(); }
+	bool CanAllocate(size_t Size, size_t Alignment) override { return Impl.CanAllocate(Size, Alignment); }
+	bool OwnsAllocation(const void* Ptr) override { return Impl.OwnsAllocation(Ptr); }
+	size_t Compact() override { Impl.CollectHeap(&Heap); return Impl.Compact(); }
+	bit::SmallBlockAllocator Impl;
+	bit::SmallBlockAllocator::ThreadHeap Heap;
+	bool bShared;
+};
+
+struct Contender
+{
+	const char* Name;
+	bit::IAllocator* Allocator;
+	void(*Reset)(bit::IAllocator* Allocator); // Replaces FREE_ALL when set
+	bool bFreesBlocks; // False when blocks can only be released all at once
+	bool bThreadSafe;
+};
+
+static void ResetLinearAllocator(bit::IAllocator* Allocator)
+{
+	static_cast<bit::LinearAllocator*>(Allocator)->Reset();
+}
+
+static bit::MemoryArena CommitArena(bit::VirtualMemoryBlock& Memory, size_t Size)
+{
+	bit::VirtualAllocateBlock(Size, Memory);
+	return bit::MemoryArena(Memory.CommitAll(), Size);
+}
+
+/* One fresh instance of every allocator under test. The global allocator is shared by the whole process. */
+struct ContenderSet
+{
+	static constexpr size_t LINEAR_ARENA_SIZE = 64 MiB;
+	static constexpr size_t PAGE_REGION_SIZE = 1 GiB;
+	static constexpr size_t CONTENDER_COUNT = 7;
+
+	ContenderSet() :
+		SmallBlock(false),
+		SharedSmallBlock(true),
+		Page("PageAllocator", nullptr, PAGE_REGION_SIZE),
+		Linear("LinearAllocator", CommitArena(LinearMemory, LINEAR_ARENA_SIZE)),
+		Entries{
+			{ "bit::Malloc", &bit::GetGlobalAllocator(), nullptr, true, true },
+			{ "malloc", &SystemMalloc, nullptr, true, true },
+			{ "TLSFAllocator", &TLSF, nullptr, true, false },
+			{ "SmallBlockAllocator", &SmallBlock, nullptr, true, false },
+			{ "SmallBlock (shared)", &SharedSmallBlock, nullptr, true, true },
+			{ "PageAllocator", &Page, nullptr, true, false },
+			{ "LinearAllocator", &Linear, &ResetLinearAllocator, false, false }
+		}
+	{}
+
+	~ContenderSet()
+	{
+		bit::VirtualFreeBlock(LinearMemory);
+	}
+
+	SystemMallocAdapter SystemMalloc;
+	TLSFAdapter TLSF;
+	SmallBlockAdapter SmallBlock;
+	SmallBlockAdapter SharedSmallBlock;
+	bit::PageAllocator Page;
+	bit::VirtualMemoryBlock LinearMemory;
+	bit::LinearAllocator Linear;
+	Contender Entries[CONTENDER_COUNT];
+};
+
+struct ReplayResult
+{
+	size_t OpCount;
+	double Seconds;
+	double P50Nanoseconds;
+	double P99Nanoseconds;
+	size_t PeakCommittedBytes;
+	size_t PeakResidentGrowth;
+};
+
+static constexpr size_t LATENCY_SAMPLE_INTERVAL = 16;
+static constexpr size_t COMMIT_SAMPLE_INTERVAL = 4096;
+static constexpr size_t RESIDENT_SAMPLE_INTERVAL = 65536; // Reading RSS goes through the OS, keep it rare
+
+static bool CanReplay(const Contender& Entry, const AllocationTrace& Trace)
+{
+	if (Trace.bHasFrees && !Entry.bFreesBlocks) return false;
+	for (size_t Index = 0; Index < Trace.OpCount; ++Index)
+	{
+		const TraceOp& Op = Trace.Ops[Index];
+		if (Op.Type != TraceOpType::TRACE_OP_ALLOCATE && Op.Type != TraceOpType::TRACE_OP_REALLOCATE) continue;
+		if (!Entry.Allocator->CanAllocate(Op.Size, Op.Alignment)) return false;
+	}
+	return true;
+}
+
+static BIT_FORCEINLINE void ReplayOp(const Contender& Entry, void** Slots, uint32_t SlotCount, const TraceOp& Op)
+{
+	bit::IAllocator& Allocator = *Entry.Allocator;
+	switch (Op.Type)
+	{
+	case TraceOpType::TRACE_OP_ALLOCATE:
+		Slots[Op.Slot] = Allocator.Allocate(Op.Size, Op.Alignment);
+		// Touch the block so lazily committed memory shows up in RSS
+		if (Slots[Op.Slot] != nullptr) *(volatile uint8_t*)Slots[Op.Slot] = 1;
+		break;
+	case TraceOpType::TRACE_OP_FREE:
+		if (Slots[Op.Slot] != nullptr) Allocator.Free(Slots[Op.Slot]);
+		Slots[Op.Slot] = nullptr;
+		break;
+	case TraceOpType::TRACE_OP_REALLOCATE:
+		Slots[Op.Slot] = Allocator.Reallocate(Slots[Op.Slot], Op.Size, Op.Alignment);
+		break;
+	case TraceOpType::TRACE_OP_FREE_ALL:
+		if (Entry.Reset != nullptr)
+		{
+			Entry.Reset(&Allocator);
+			bit::Memset(Slots, 0, SlotCount * sizeof(void*));
+			break;
+		}
+		for (uint32_t Slot = 0; Slot < SlotCount; ++Slot)
+		{
+			if (Slots[Slot] != nullptr) Allocator.Free(Slots[Slot]);
+			Slots[Slot] = nullptr;
+		}
+		break;
+	}
+}
+
+static size_t GetResidentBytes()
+{
+	return bit::GetOSProcessMemoryInfo().PhysicalUsedInBytes;
+}
+
+static void SampleMemory(bit::IAllocator& Allocator, size_t BaseResident, bool bResident, ReplayResult& Result)
+{
+	Result.PeakCommittedBytes = bit::Max(Result.PeakCommittedBytes, Allocator.GetMemoryUsageInfo().CommittedBytes);
+	if (bResident)
+	{
+		size_t Resident = GetResidentBytes();
+		if (Resident > BaseResident) Result.PeakResidentGrowth = bit::Max(Result.PeakResidentGrowth, Resident - BaseResident);
+	}
+}
+
+static int32_t CompareSeconds(const void* A, const void* B)
+{
+	double Left = *(const double*)A;
+	double Right = *(const double*)B;
+	return Left < Right ? -1 : (Left > Right ? 1 : 0);
+}
+
+static void ReadPercentiles(double* Samples, size_t SampleCount, ReplayResult& Result)
+{
+	if (SampleCount == 0) return;
+	qsort(Samples, SampleCount, sizeof(double), &CompareSeconds);
+	Result.P50Nanoseconds = Samples[SampleCount / 2] * 1e9;
+	Result.P99Nanoseconds = Samples[(SampleCount * 99) / 100] * 1e9;
+}
+
+/* The first pass starts from an empty allocator and samples latency and memory.
+   The second pass replays the trace again untimed per op to measure throughput. */
+static ReplayResult ReplayTrace(const Contender& Entry, const AllocationTrace& Trace)
+{
+	ReplayResult Result = {};
+	Result.OpCount = Trace.OpCount;
+	void** Slots = (void**)calloc(Trace.SlotCount, sizeof(void*));
+	double* Samples = (double*)malloc((Trace.OpCount / LATENCY_SAMPLE_INTERVAL + 1) * sizeof(double));
+	size_t SampleCount = 0;
+	size_t BaseResident = GetResidentBytes();
+
+	for (size_t Index = 0; Index < Trace.OpCount; ++Index)
+	{
+		const TraceOp& Op = Trace.Ops[Index];
+		if (Op.Type == TraceOpType::TRACE_OP_FREE_ALL)
+		{
+			// Everything is live right before a FREE_ALL, it's the most likely peak
+			SampleMemory(*Entry.Allocator, BaseResident, true, Result);
+			ReplayOp(Entry, Slots, Trace.SlotCount, Op);
+			continue;
+		}
+		if ((Index % LATENCY_SAMPLE_INTERVAL) == 0)
+		{
+			double Start = bit::GetSeconds();
+			ReplayOp(Entry, Slots, Trace.SlotCount, Op);
+			Samples[SampleCount++] = bit::GetSeconds() - Start;
+		}
+		else
+		{
+			ReplayOp(Entry, Slots, Trace.SlotCount, Op);
+		}
+		if ((Index % COMMIT_SAMPLE_INTERVAL) == 0)
+		{
+			SampleMemory(*Entry.Allocator, BaseResident, (Index % RESIDENT_SAMPLE_INTERVAL) == 0, Result);
+		}
+	}
+	ReadPercentiles(Samples, SampleCount, Result);
+
+	bit::ProfTimer Timer;
+	Timer.Begin();
+	for (size_t Index = 0; Index < Trace.OpCount; ++Index)
+	{
+		ReplayOp(Entry, Slots, Trace.SlotCount, Trace.Ops[Index]);
+	}
+	Result.Seconds = Timer.End();
+
+	// Traces end with FREE_ALL but a recorded trace may not
+	TraceOp FreeAll = { TraceOpType::TRACE_OP_FREE_ALL, 0, 0, 0 };
+	ReplayOp(Entry, Slots, Trace.SlotCount, FreeAll);
+	free(Samples);
+	free(Slots);
+	return Result;
+}
+
+static void PrintHeader()
+{
+	BENCH_LOG("%-22s %9s %9s %9s %14s %14s", "allocator", "ns/op", "p50 ns", "p99 ns", "peak commit", "peak rss");
+}
+
+static void PrintResult(const char* Name, const ReplayResult& Result)
+{
+	char Committed[32] = "n/a";
+	if (Result.PeakCommittedBytes > 0) snprintf(Committed, sizeof(Committed), "%.2lf MiB", bit::FromMiB(Result.PeakCommittedBytes));
+	BENCH_LOG("%-22s %9.2lf %9.1lf %9.1lf %14s %10.2lf MiB", Name, Result.Seconds * 1e9 / (double)Result.OpCount,
+		Result.P50Nanoseconds, Result.P99Nanoseconds, Committed, bit::FromMiB(Result.PeakResidentGrowth));
+}
+
+static void RunTrace(const AllocationTrace& Trace)
+{
+	ContenderSet* Set = bit::New<ContenderSet>();
+	BENCH_LOG("%s: %zu ops, %u slots", Trace.Name, Trace.OpCount, Trace.SlotCount);
+	PrintHeader();
+	for (size_t Index = 0; Index < ContenderSet::CONTENDER_COUNT; ++Index)
+	{
+		const Contender& Entry = Set->Entries[Index];
+		if (!CanReplay(Entry, Trace))
+		{
+			BENCH_LOG("%-22s skipped, can't serve this trace", Entry.Name);
+			continue;
+		}
+		ReplayResult Result = ReplayTrace(Entry, Trace);
+		Entry.Allocator->Compact();
+		PrintResult(Entry.Name, Result);
+	}
+	bit::Delete(Set);
+}
+
+BIT_BENCHMARK(AllocatorFixedChurn)
+{
+	AllocationTrace Trace("64B churn", 1000001, 1024);
+	BuildChurnTrace(Trace, 1000000, 64, 64, 0.0, 0x9E3779B97F4A7C15ULL);
+	RunTrace(Trace);
+}
+
+BIT_BENCHMARK(AllocatorPowerLaw)
+{
+	AllocationTrace Trace("power law 16B-32KiB", 1000001, 4096);
+	BuildChurnTrace(Trace, 1000000, 16, 32 KiB, 1.2, 0xC2B2AE3D27D4EB4FULL);
+	RunTrace(Trace);
+}
+
+BIT_BENCHMARK(AllocatorPageSizes)
+{
+	AllocationTrace Trace("power law 64KiB-2MiB", 50001, 256);
+	BuildChurnTrace(Trace, 50000, 64 KiB, 2 MiB, 1.0, 0x165667B19E3779F9ULL);
+	RunTrace(Trace);
+}
+
+BIT_BENCHMARK(AllocatorReallocGrowth)
+{
+	AllocationTrace Trace("realloc growth 64B-1MiB", 100001, 256);
+	BuildReallocTrace(Trace, 100000, 64, 1 MiB, 0x27D4EB2F165667C5ULL);
+	RunTrace(Trace);
+}
+
+BIT_BENCHMARK(AllocatorFrameScratch)
+{
+	static constexpr size_t FRAME_COUNT = 2000;
+	static constexpr uint32_t ALLOCATIONS_PER_FRAME = 512;
+	AllocationTrace Trace("frame scratch 16B-4KiB", FRAME_COUNT * (ALLOCATIONS_PER_FRAME + 1), ALLOCATIONS_PER_FRAME);
+	BuildFrameTrace(Trace, FRAME_COUNT, 16, 4 KiB, 0x85EBCA77C2B2AE63ULL);
+	RunTrace(Trace);
+}
+
+BIT_BENCHMARK(AllocatorRecordedTrace)
+{
+	AllocationTrace Trace("recorded Array<uint8_t> growth", 65536, 0);
+	RecordContainerTrace(Trace, 200000, 0xFF51AFD7ED558CCDULL);
+	if (Trace.OpCount > 0) RunTrace(Trace);
+}
+
+/* Replays a trace recorded by an application with bit::StartAllocationTrace */
+BIT_BENCHMARK(AllocatorTraceFile)
+{
+	const char* Path = getenv("BIT_ALLOCATION_TRACE");
+	if (Path == nullptr)
+	{
+		BENCH_LOG("Set BIT_ALLOCATION_TRACE to the path of a trace file to replay it");
+		return;
+	}
+	AllocationTrace Trace(Path, 65536, 0);
+	if (!LoadTraceFile(Trace, Path))
+	{
+		BENCH_LOG("Failed to read allocation trace %s", Path);
+		return;
+	}
+	RunTrace(Trace);
+}
+
+/* Single producer single consumer queue of blocks */
+struct HandoffRing
+{
+	static constexpr int64_t CAPACITY = 4096;
+	void* Blocks[CAPACITY];
+	int64_t Head; // Written by the producer
+	int64_t Tail; // Written by the consumer
+};
+
+struct HandoffJob
+{
+	bit::IAllocator* Allocator;
+	HandoffRing* Ring;
+	int64_t BlockCount;
+};
+
+/* Spins for a while and then sleeps so the other side gets to run on machines with few cores */
+static void WaitForRing(int64_t& SpinCount)
+{
+	if (++SpinCount < 4096)
+	{
+		bit::Thread::YieldThread();
+	}
+	else
+	{
+		bit::Thread::SleepThread(1);
+		SpinCount = 0;
+	}
+}
+
+static int32_t ConsumeBlocks(void* UserData)
+{
+	HandoffJob& Job = *(HandoffJob*)UserData;
+	int64_t SpinCount = 0;
+	for (int64_t Index = 0; Index < Job.BlockCount; ++Index)
+	{
+		while (bit::AtomicAdd(&Job.Ring->Head, 0) == Index) WaitForRing(SpinCount);
+		Job.Allocator->Free(Job.Ring->Blocks[Index % HandoffRing::CAPACITY]);
+		bit::AtomicExchange(&Job.Ring->Tail, Index + 1);
+	}
+	return 0;
+}
+
+/* The producer replays the allocations of the trace and hands every block over to a consumer
+   thread that frees it. Latency samples are producer allocations, ns/op is per block. */
+static ReplayResult ReplayHandoff(const Contender& Entry, const AllocationTrace& Trace)
+{
+	ReplayResult Result = {};
+	Result.OpCount = Trace.OpCount;
+	HandoffRing* Ring = (HandoffRing*)calloc(1, sizeof(HandoffRing));
+	double* Samples = (double*)malloc((Trace.OpCount / LATENCY_SAMPLE_INTERVAL + 1) * sizeof(double));
+	size_t SampleCount = 0;
+	size_t BaseResident = GetResidentBytes();
+	HandoffJob Job = { Entry.Allocator, Ring, (int64_t)Trace.OpCount };
+	int64_t SpinCount = 0;
+
+	bit::ProfTimer Timer;
+	Timer.Begin();
+	bit::Thread Consumer;
+	Consumer.Start(&ConsumeBlocks, 0, &Job);
+	for (int64_t Index = 0; Index < Job.BlockCount; ++Index)
+	{
+		const TraceOp& Op = Trace.Ops[Index];
+		double Start = bit::GetSeconds();
+		void* Block = Entry.Allocator->Allocate(Op.Size, Op.Alignment);
+		if ((Index % LATENCY_SAMPLE_INTERVAL) == 0) Samples[SampleCount++] = bit::GetSeconds() - Start;
+		*(volatile uint8_t*)Block = 1;
+		while (Index - bit::AtomicAdd(&Ring->Tail, 0) >= HandoffRing::CAPACITY) WaitForRing(SpinCount);
+		Ring->Blocks[Index % HandoffRing::CAPACITY] = Block;
+		bit::AtomicExchange(&Ring->Head, Index + 1);
+		if ((Index % COMMIT_SAMPLE_INTERVAL) == 0)
+		{
+			SampleMemory(*Entry.Allocator, BaseResident, (Index % RESIDENT_SAMPLE_INTERVAL) == 0, Result);
+		}
+	}
+	Consumer.Join();
+	Result.Seconds = Timer.End();
+	ReadPercentiles(Samples, SampleCount, Result);
+	free(Samples);
+	free(Ring);
+	return Result;
+}
+
+BIT_BENCHMARK(AllocatorCrossThread)
+{
+	static constexpr uint32_t BLOCK_COUNT = 500000;
+	AllocationTrace Trace("cross thread frees 16B-1KiB", BLOCK_COUNT, (uint32_t)HandoffRing::CAPACITY);
+	BenchRandom Random(0x94D049BB133111EBULL);
+	for (uint32_t Index = 0; Index < BLOCK_COUNT; ++Index)
+	{
+		Trace.Push(TraceOpType::TRACE_OP_ALLOCATE, Index % HandoffRing::CAPACITY, PowerLawSize(Random, 16, 1 KiB, 1.2));
+	}
+
+	ContenderSet* Set = bit::New<ContenderSet>();
+	BENCH_LOG("%s: %zu blocks", Trace.Name, Trace.OpCount);
+	PrintHeader();
+	for (size_t Index = 0; Index < ContenderSet::CONTENDER_COUNT; ++Index)
+	{
+		const Contender& Entry = Set->Entries[Index];
+		if (!Entry.bThreadSafe) continue;
+		ReplayResult Result = ReplayHandoff(Entry, Trace);
+		Entry.Allocator->Compact();
+		PrintResult(Entry.Name, Result);
+	}
+	bit::Delete(Set);
+}
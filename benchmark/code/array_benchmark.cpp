@@ -0,0 +1,167 @@
+#include "benchmark.h"
+#include <bit/container/array.h>
+#include <vector>
+
+/* Growth and unordered removal for element types that need a destructor. Handles of both
+   kinds are the same type, only the relocatable one is marked IsTriviallyRelocatable so
+   bit::Array moves it with Realloc and Memcpy instead of a move construct and destroy per
+   element. Add appends Count elements one at a time, RemoveAtSwap removes them again from
+   the front. */
+
+static int64_t GHandleSum = 0;
+
+template<bool bRelocatable>
+struct BenchHandle
+{
+	BenchHandle(int64_t InValue) : Value(InValue) {}
+	BenchHandle(BenchHandle&& Other) noexcept : Value(Other.Value) { Other.Value = 0; }
+	BenchHandle& operator=(BenchHandle&& Other) noexcept { GHandleSum += Value; Value = Other.Value; Other.Value = 0; return *this; }
+	~BenchHandle() { GHandleSum += Value; }
+	int64_t Value;
+};
+
+namespace bit
+{
+	template<> struct IsTriviallyRelocatable<BenchHandle<true>> : public ConstValue<bool, true> {};
+}
+
+struct ArrayTimes
+{
+	double Add;
+	double RemoveSwap;
+};
+
+template<typename T>
+static ArrayTimes RunBitArray(int32_t Count)
+{
+	ArrayTimes Times = {};
+	bit::ProfTimer Timer;
+	bit::Array<T> Array;
+
+	Timer.Begin();
+	for (int32_t Value = 0; Value < Count; ++Value) Array.Add(T(Value));
+	Times.Add = Timer.End();
+
+	Timer.Begin();
+	while (!Array.IsEmpty()) Array.RemoveAtSwap(0);
+	Times.RemoveSwap = Timer.End();
+	DoNotOptimize(GHandleSum);
+	return Times;
+}
+
+template<typename T>
+static ArrayTimes RunStdVector(int32_t Count)
+{
+	ArrayTimes Times = {};
+	bit::ProfTimer Timer;
+	std::vector<T> Vector;
+
+	Timer.Begin();
+	for (int32_t Value = 0; Value < Count; ++Value) Vector.push_back(T(Value));
+	Times.Add = Timer.End();
+
+	Timer.Begin();
+	while (!Vector.empty())
+	{
+		Vector.front() = std::move(Vector.back());
+		Vector.pop_back();
+	}
+	Times.RemoveSwap = Timer.End();
+	DoNotOptimize(GHandleSum);
+	return Times;
+}
+
+BIT_BENCHMARK(ArrayGrowth)
+{
+	static const int32_t COUNTS[] = { 1024, 64 * 1024, 1024 * 1024, 8 * 1024 * 1024 };
+	// The first run pays for mapping the allocator pools
+	RunBitArray<int64_t>(COUNTS[0]);
+	BENCH_LOG("%-10s %-28s %12s %14s", "count", "array", "add ns", "remove swap ns");
+	for (int32_t Count : COUNTS)
+	{
+		ArrayTimes AllTimes[] =
+		{
+			RunBitArray<int64_t>(Count),
+			RunStdVector<int64_t>(Count),
+			RunBitArray<BenchHandle<true>>(Count),
+			RunBitArray<BenchHandle<false>>(Count),
+			RunStdVector<BenchHandle<false>>(Count)
+		};
+		const char* NAMES[] = { "bit::Array int64", "std::vector int64", "bit::Array relocatable", "bit::Array movable", "std::vector movable" };
+		for (int32_t Index = 0; Index < 5; ++Index)
+		{
+			BENCH_LOG("%-10d %-28s %12.2lf %14.2lf", Count, NAMES[Index],
+				AllTimes[Index].Add * 1e9 / Count, AllTimes[Index].RemoveSwap * 1e9 / Count);
+		}
+	}
+}
+
+/* Fills an Array<uint8_t> from a source buffer in CHUNK_SIZE reads, the way a file or
+   socket is read. Add per byte is how ranges were appended before Append existed. */
+static constexpr int32_t CHUNK_SIZE = 4096;
+
+template<typename TFillFunc>
+static double TimeFill(const uint8_t* Source, int32_t Size, TFillFunc Fill)
+{
+	bit::ProfTimer Timer;
+	Timer.Begin();
+	int64_t Sum = Fill(Source, Size);
+	double Time = Timer.End();
+	DoNotOptimize(Sum);
+	return Time;
+}
+
+BIT_BENCHMARK(ArrayAppend)
+{
+	static const int32_t SIZES[] = { 64 * 1024, 1024 * 1024, 16 * 1024 * 1024 };
+	uint8_t* Source = (uint8_t*)bit::Malloc(SIZES[2]);
+	for (int32_t Index = 0; Index < SIZES[2]; ++Index) Source[Index] = (uint8_t)(Index * 31);
+
+	auto AddPerByte = [](const uint8_t* Source, int32_t Size) -> int64_t
+	{
+		bit::Array<uint8_t> Buffer;
+		for (int32_t Index = 0; Index < Size; ++Index) Buffer.Add(Source[Index]);
+		return Buffer.GetCount();
+	};
+	auto AppendChunks = [](const uint8_t* Source, int32_t Size) -> int64_t
+	{
+		bit::Array<uint8_t> Buffer;
+		for (int32_t Offset = 0; Offset < Size; Offset += CHUNK_SIZE) Buffer.Append(Source + Offset, CHUNK_SIZE);
+		return Buffer.GetCount();
+	};
+	auto AddUninitializedChunks = [](const uint8_t* Source, int32_t Size) -> int64_t
+	{
+		bit::Array<uint8_t> Buffer;
+		for (int32_t Offset = 0; Offset < Size; Offset += CHUNK_SIZE) bit::Memcpy(Buffer.AddUninitialized(CHUNK_SIZE), Source + Offset, CHUNK_SIZE);
+		return Buffer.GetCount();
+	};
+	auto SetCountOnce = [](const uint8_t* Source, int32_t Size) -> int64_t
+	{
+		bit::Array<uint8_t> Buffer;
+		Buffer.SetCountUninitialized(Size);
+		for (int32_t Offset = 0; Offset < Size; Offset += CHUNK_SIZE) bit::Memcpy(Buffer.GetData(Offset), Source + Offset, CHUNK_SIZE);
+		return Buffer.GetCount();
+	};
+	auto StdInsert = [](const uint8_t* Source, int32_t Size) -> int64_t
+	{
+		std::vector<uint8_t> Buffer;
+		for (int32_t Offset = 0; Offset < Size; Offset += CHUNK_SIZE) Buffer.insert(Buffer.end(), Source + Offset, Source + Offset + CHUNK_SIZE);
+		return (int64_t)Buffer.size();
+	};
+
+	BENCH_LOG("%-10s %14s %14s %14s %14s %14s", "bytes", "Add per byte", "Append", "AddUninit", "SetCount", "vector insert");
+	for (int32_t Size : SIZES)
+	{
+		double Times[] =
+		{
+			TimeFill(Source, Size, AddPerByte),
+			TimeFill(Source, Size, AppendChunks),
+			TimeFill(Source, Size, AddUninitializedChunks),
+			TimeFill(Source, Size, SetCountOnce),
+			TimeFill(Source, Size, StdInsert)
+		};
+		BENCH_LOG("%-10d %9.2lf GB/s %9.2lf GB/s %9.2lf GB/s %9.2lf GB/s %9.2lf GB/s", Size,
+			Size / Times[0] / 1e9, Size / Times[1] / 1e9, Size / Times[2] / 1e9, Size / Times[3] / 1e9, Size / Times[4] / 1e9);
+	}
+	bit::Free(Source);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <bit/core/types.h>
+#include <bit/core/os/debug.h>
+#include <bit/utility/prof_timer.h>
+
+/* Minimal benchmark registry. Every file defines its benchmarks with BIT_BENCHMARK
+   and main runs the ones whose name contains the filter passed on the command line. */
+
+struct BenchmarkEntry
+{
+	const char* Name;
+	void(*Function)();
+	BenchmarkEntry* Next;
+};
+
+struct BenchmarkRegistrar
+{
+	BenchmarkRegistrar(BenchmarkEntry* Entry);
+	static BenchmarkEntry* GetBenchmarks();
+};
+
+/* Keeps the optimizer from discarding the computation of Value */
+template<typename T>
+inline void DoNotOptimize(const T& Value)
+{
+#if BIT_PLATFORM_WINDOWS
+	volatile const T* Sink = &Value; (void)Sink;
+#else
+	asm volatile("" : : "g"(&Value) : "memory");
+#endif
+}
+
+#define BIT_BENCHMARK(Name) \
+	static void Name(); \
+	static BenchmarkEntry Name##Entry = { #Name, &Name, nullptr }; \
+	static BenchmarkRegistrar Name##Registrar(&Name##Entry); \
+	static void Name()
+
+#define BENCH_LOG(Fmt, ...) BIT_ALWAYS_LOG("  " Fmt, ##__VA_ARGS__)
@@ -0,0 +1,233 @@
+#include "benchmark.h"
+#include <bit/utility/hash.h>
+#include <bit/utility/utility.h>
+#include <bit/utility/murmur_hash.h>
+#include <bit/utility/wy_hash.h>
+#include <functional>
+#include <string_view>
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+/* Compares the bulk hashes and the integer mixers behind bit::Hash. Throughput is
+   measured per input size, quality as chi-square of the low and high bits over
+   1024 buckets and as the worst avalanche bias. */
+
+typedef size_t(*BytesHash_t)(const void* Data, size_t Len, size_t Seed);
+
+static size_t StdHash(const void* Data, size_t Len, size_t Seed)
+{
+	return std::hash<std::string_view>()(std::string_view((const char*)Data, Len)) ^ Seed;
+}
+
+struct BytesHashEntry
+{
+	const char* Name;
+	BytesHash_t Function;
+};
+
+static const BytesHashEntry BYTES_HASHES[] =
+{
+	{ "bit::MurmurHash", &bit::MurmurHash },
+	{ "bit::WyHash", &bit::WyHash },
+	{ "std::hash", &StdHash }
+};
+
+static uint64_t NextRandom(uint64_t& State)
+{
+	State ^= State << 13;
+	State ^= State >> 7;
+	State ^= State << 17;
+	return State;
+}
+
+BIT_BENCHMARK(HashFunctionThroughput)
+{
+	static const size_t SIZES[] = { 4, 8, 16, 32, 64, 256, 1024, 16 * 1024, 1024 * 1024 };
+	static constexpr size_t BYTES_PER_SIZE = 256 * 1024 * 1024;
+	static constexpr size_t BUFFER_SIZE = 2 * 1024 * 1024;
+	uint8_t* Buffer = (uint8_t*)malloc(BUFFER_SIZE);
+	uint64_t State = 0x9E3779B97F4A7C15ULL;
+	for (size_t Index = 0; Index < BUFFER_SIZE; ++Index) Buffer[Index] = (uint8_t)NextRandom(State);
+
+	BENCH_LOG("%-10s %18s %18s %18s", "bytes", BYTES_HASHES[0].Name, BYTES_HASHES[1].Name, BYTES_HASHES[2].Name);
+	for (size_t Size : SIZES)
+	{
+		char Line[128];
+		int32_t Length = snprintf(Line, sizeof(Line), "%-10zu", Size);
+		for (const BytesHashEntry& Entry : BYTES_HASHES)
+		{
+			// Every call starts at a different offset so the input isn't loop invariant
+			size_t Count = bit::Max(BYTES_PER_SIZE / Size, (size_t)1);
+			size_t OffsetMask = BUFFER_SIZE / 2 - 1;
+			size_t Sum = 0;
+			bit::ProfTimer Timer;
+			Timer.Begin();
+			for (size_t Index = 0; Index < Count; ++Index)
+			{
+				Sum += Entry.Function(Buffer + ((Index * 64 + (Sum & 7)) & OffsetMask), Size, bit::DEFAULT_HASH_SEED);
+			}
+			double Time = Timer.End();
+			DoNotOptimize(Sum);
+			double Bytes = (double)Count * (double)Size;
+			if (Size < 64)
+				Length += snprintf(Line + Length, sizeof(Line) - Length, " %9.2lf ns/hash", Time * 1e9 / (double)Count);
+			else
+				Length += snprintf(Line + Length, sizeof(Line) - Length, " %12.2lf GB/s", Bytes / Time / 1e9);
+		}
+		BENCH_LOG("%s", Line);
+	}
+	free(Buffer);
+}
+
+/* The HashTable default for int32_t keys used to hash the 4 bytes with MurmurHash */
+BIT_BENCHMARK(HashFunctionIntegers)
+{
+	static constexpr int32_t COUNT = 64 * 1024 * 1024;
+	bit::ProfTimer Timer;
+	size_t Sum = 0;
+
+	Timer.Begin();
+	for (int32_t Value = 0; Value < COUNT; ++Value) Sum += bit::MurmurHasher<int32_t>()(Value + (int32_t)(Sum & 1));
+	double MurmurTime = Timer.End();
+	Timer.Begin();
+	for (int32_t Value = 0; Value < COUNT; ++Value) Sum += bit::Hash<int32_t>()(Value + (int32_t)(Sum & 1));
+	double MixerTime = Timer.End();
+	Timer.Begin();
+	for (int32_t Value = 0; Value < COUNT; ++Value) Sum += std::hash<int32_t>()(Value + (int32_t)(Sum & 1));
+	double StdTime = Timer.End();
+	DoNotOptimize(Sum);
+
+	BENCH_LOG("int32_t keys, ns/hash");
+	BENCH_LOG("%-24s %9.2lf", "bit::MurmurHash", MurmurTime * 1e9 / COUNT);
+	BENCH_LOG("%-24s %9.2lf", "bit::Hash<int32_t>", MixerTime * 1e9 / COUNT);
+	BENCH_LOG("%-24s %9.2lf", "std::hash (identity)", StdTime * 1e9 / COUNT);
+}
+
+struct HashQuality
+{
+	double LowChiSquare; // Chi-square over 1024 buckets divided by the degrees of freedom, 1.0 is ideal
+	double HighChiSquare;
+	double AvalancheBias; // Largest distance from 0.5 of any output bit flipping, 0.0 is ideal
+};
+
+template<typename TFunc>
+static HashQuality MeasureQuality(TFunc Func, uint64_t(*MakeKey)(uint64_t Index), int32_t KeyBits)
+{
+	static constexpr int32_t KEY_COUNT = 1 << 20;
+	static constexpr int32_t BUCKET_COUNT = 1024;
+	static constexpr int32_t AVALANCHE_SAMPLES = 4096;
+	HashQuality Quality = {};
+	int32_t* LowBuckets = (int32_t*)calloc(BUCKET_COUNT, sizeof(int32_t));
+	int32_t* HighBuckets = (int32_t*)calloc(BUCKET_COUNT, sizeof(int32_t));
+	for (int32_t Index = 0; Index < KEY_COUNT; ++Index)
+	{
+		uint64_t Hash = (uint64_t)Func(MakeKey((uint64_t)Index));
+		LowBuckets[Hash & (BUCKET_COUNT - 1)] += 1;
+		HighBuckets[(Hash >> (sizeof(size_t) * 8 - 10)) & (BUCKET_COUNT - 1)] += 1;
+	}
+	double Expected = (double)KEY_COUNT / BUCKET_COUNT;
+	for (int32_t Bucket = 0; Bucket < BUCKET_COUNT; ++Bucket)
+	{
+		Quality.LowChiSquare += (LowBuckets[Bucket] - Expected) * (LowBuckets[Bucket] - Expected) / Expected;
+		Quality.HighChiSquare += (HighBuckets[Bucket] - Expected) * (HighBuckets[Bucket] - Expected) / Expected;
+	}
+	Quality.LowChiSquare /= BUCKET_COUNT - 1;
+	Quality.HighChiSquare /= BUCKET_COUNT - 1;
+
+	int32_t OutputBits = (int32_t)sizeof(size_t) * 8;
+	int32_t* Flips = (int32_t*)calloc((size_t)KeyBits * OutputBits, sizeof(int32_t));
+	uint64_t State = 0xD1B54A32D192ED03ULL;
+	for (int32_t Sample = 0; Sample < AVALANCHE_SAMPLES; ++Sample)
+	{
+		uint64_t Key = NextRandom(State) & (KeyBits == 64 ? ~0ULL : ((1ULL << KeyBits) - 1));
+		uint64_t Hash = (uint64_t)Func(Key);
+		for (int32_t InBit = 0; InBit < KeyBits; ++InBit)
+		{
+			uint64_t Diff = Hash ^ (uint64_t)Func(Key ^ (1ULL << InBit));
+			for (int32_t OutBit = 0; OutBit < OutputBits; ++OutBit) Flips[InBit * OutputBits + OutBit] += (int32_t)((Diff >> OutBit) & 1);
+		}
+	}
+	for (int32_t Index = 0; Index < KeyBits * OutputBits; ++Index)
+	{
+		Quality.AvalancheBias = bit::Max(Quality.AvalancheBias, fabs((double)Flips[Index] / AVALANCHE_SAMPLES - 0.5));
+	}
+	free(Flips);
+	free(LowBuckets);
+	free(HighBuckets);
+	return Quality;
+}
+
+static uint64_t SequentialKey(uint64_t Index) { return Index; }
+static uint64_t PageStrideKey(uint64_t Index) { return Index * 4096; }
+static uint64_t RandomKey(uint64_t Index) { uint64_t State = Index * 0x9E3779B97F4A7C15ULL + 1; return NextRandom(State); }
+
+BIT_BENCHMARK(HashFunctionQuality)
+{
+	struct KeySet { const char* Name; uint64_t(*MakeKey)(uint64_t); };
+	static const KeySet KEY_SETS[] =
+	{
+		{ "sequential", &SequentialKey },
+		{ "4096 stride", &PageStrideKey },
+		{ "random", &RandomKey }
+	};
+	BENCH_LOG("1048576 64-bit keys, chi-square / dof (1.0 ideal), worst avalanche bias (0.0 ideal)");
+	BENCH_LOG("%-12s %-24s %9s %9s %9s", "keys", "hash", "low bits", "high bits", "avalanche");
+	for (const KeySet& Set : KEY_SETS)
+	{
+		HashQuality Qualities[] =
+		{
+			MeasureQuality([](uint64_t Key) { return bit::MurmurHash(&Key, sizeof(Key), bit::DEFAULT_HASH_SEED); }, Set.MakeKey, 64),
+			MeasureQuality([](uint64_t Key) { return bit::WyHash(&Key, sizeof(Key), bit::DEFAULT_HASH_SEED); }, Set.MakeKey, 64),
+			MeasureQuality([](uint64_t Key) { return bit::Hash<uint64_t>()(Key); }, Set.MakeKey, 64),
+			MeasureQuality([](uint64_t Key) { return std::hash<uint64_t>()(Key); }, Set.MakeKey, 64)
+		};
+		static const char* NAMES[] = { "bit::MurmurHash", "bit::WyHash", "bit::Hash<uint64_t>", "std::hash" };
+		for (int32_t Index = 0; Index < 4; ++Index)
+		{
+			BENCH_LOG("%-12s %-24s %9.2lf %9.2lf %9.3lf", Set.Name, NAMES[Index], Qualities[Index].LowChiSquare, Qualities[Index].HighChiSquare, Qualities[Index].AvalancheBias);
+		}
+	}
+}
+
+/* bit::WyHasher over a 1 MiB buffer fed in chunks of different sizes, against one WyHash call */
+BIT_BENCHMARK(HashFunctionStreaming)
+{
+	static const size_t CHUNK_SIZES[] = { 7, 64, 1500, 4096, 64 * 1024 };
+	static constexpr size_t BUFFER_SIZE = 1024 * 1024;
+	static constexpr int32_t ROUNDS = 256;
+	uint8_t* Buffer = (uint8_t*)malloc(BUFFER_SIZE);
+	uint64_t State = 0x9E3779B97F4A7C15ULL;
+	for (size_t Index = 0; Index < BUFFER_SIZE; ++Index) Buffer[Index] = (uint8_t)NextRandom(State);
+
+	bit::ProfTimer Timer;
+	size_t Expected = bit::WyHash(Buffer, BUFFER_SIZE, bit::DEFAULT_HASH_SEED);
+	size_t Sum = 0;
+	Timer.Begin();
+	for (int32_t Round = 0; Round < ROUNDS; ++Round) Sum += bit::WyHash(Buffer, BUFFER_SIZE, bit::DEFAULT_HASH_SEED + (Sum & 1));
+	double Time = Timer.End();
+	DoNotOptimize(Sum);
+	BENCH_LOG("%-24s %12.2lf GB/s", "bit::WyHash", (double)BUFFER_SIZE * ROUNDS / Time / 1e9);
+
+	for (size_t ChunkSize : CHUNK_SIZES)
+	{
+		bit::WyHasher Hasher(bit::DEFAULT_HASH_SEED);
+		Timer.Begin();
+		for (int32_t Round = 0; Round < ROUNDS; ++Round)
+		{
+			Hasher.Init(bit::DEFAULT_HASH_SEED);
+			for (size_t Offset = 0; Offset < BUFFER_SIZE; Offset += ChunkSize)
+			{
+				Hasher.Update(Buffer + Offset, bit::Min(ChunkSize, BUFFER_SIZE - Offset));
+			}
+			Sum += Hasher.Final();
+		}
+		Time = Timer.End();
+		DoNotOptimize(Sum);
+		BIT_ASSERT(Hasher.Final() == Expected);
+		char Name[32];
+		snprintf(Name, sizeof(Name), "WyHasher %zu B chunks", ChunkSize);
+		BENCH_LOG("%-24s %12.2lf GB/s", Name, (double)BUFFER_SIZE * ROUNDS / Time / 1e9);
+	}
+	free(Buffer);
+}
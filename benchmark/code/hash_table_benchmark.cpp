@@ -0,0 +1,391 @@
+#include "benchmark.h"
+#include <bit/container/hash_table.h>
+#include <bit/container/concurrent_hash_table.h>
+#include <bit/container/string.h>
+#include <bit/core/memory.h>
+#include <bit/core/os/atomics.h>
+#include <bit/core/os/os.h>
+#include <bit/core/os/rw_lock.h>
+#include <bit/core/os/thread.h>
+#include <unordered_map>
+#include <string>
+#include <stdlib.h>
+#include <stdio.h>
+
+/* Compares bit::HashTable against std::unordered_map. Every table size is measured for
+   insert, lookup of present keys, lookup of missing keys and erase. Keys are shuffled so
+   lookups don't walk memory in insertion order. */
+
+static uint64_t NextRandom(uint64_t& State)
+{
+	State ^= State << 13;
+	State ^= State >> 7;
+	State ^= State << 17;
+	return State;
+}
+
+static void ShuffleKeys(int32_t* Keys, int32_t Count, uint64_t Seed)
+{
+	for (int32_t Index = Count - 1; Index > 0; --Index)
+	{
+		int32_t Other = (int32_t)(NextRandom(Seed) % (uint64_t)(Index + 1));
+		int32_t Key = Keys[Index];
+		Keys[Index] = Keys[Other];
+		Keys[Other] = Key;
+	}
+}
+
+/* Visits every key once in an order unrelated to insertion order, so node based tables
+   don't get their nodes back in allocation order. Count must be a power of two. */
+static int32_t GetLookupIndex(int32_t Index, int32_t Count)
+{
+	return (int32_t)(((uint32_t)Index * 2654435761u) & (uint32_t)(Count - 1));
+}
+
+struct HashTableTimings
+{
+	double Insert;
+	double Hit;
+	double Miss;
+	double Erase;
+};
+
+struct BitIntTable
+{
+	bit::HashTable<int32_t, int32_t> Table;
+	void Insert(int32_t Key) { Table.Insert(Key, Key); }
+	bool Contains(int32_t Key) { return Table.Contains(Key); }
+	void Erase(int32_t Key) { Table.Erase(Key); }
+	void SetMaxLoadFactor(float Factor) { Table.SetMaxLoadFactor(Factor); }
+};
+
+struct StdIntTable
+{
+	std::unordered_map<int32_t, int32_t> Table;
+	void Insert(int32_t Key) { Table[Key] = Key; }
+	bool Contains(int32_t Key) { return Table.find(Key) != Table.end(); }
+	void Erase(int32_t Key) { Table.erase(Key); }
+	void SetMaxLoadFactor(float Factor) { Table.max_load_factor(Factor); }
+};
+
+/* Present keys are even, missing keys are odd */
+template<typename TTable>
+static HashTableTimings TimeIntTable(const int32_t* Keys, int32_t Count, float MaxLoadFactor = 0.0f)
+{
+	HashTableTimings Timings = {};
+	TTable* Table = new TTable();
+	if (MaxLoadFactor > 0.0f) Table->SetMaxLoadFactor(MaxLoadFactor);
+	bit::ProfTimer Timer;
+
+	Timer.Begin();
+	for (int32_t Index = 0; Index < Count; ++Index) Table->Insert(Keys[Index] * 2);
+	Timings.Insert = Timer.End();
+
+	int32_t Found = 0;
+	Timer.Begin();
+	for (int32_t Index = 0; Index < Count; ++Index) Found += Table->Contains(Keys[GetLookupIndex(Index, Count)] * 2) ? 1 : 0;
+	Timings.Hit = Timer.End();
+	DoNotOptimize(Found);
+
+	Timer.Begin();
+	for (int32_t Index = 0; Index < Count; ++Index) Found += Table->Contains(Keys[Index] * 2 + 1) ? 1 : 0;
+	Timings.Miss = Timer.End();
+	DoNotOptimize(Found);
+
+	Timer.Begin();
+	for (int32_t Index = 0; Index < Count; ++Index) Table->Erase(Keys[Index] * 2);
+	Timings.Erase = Timer.End();
+
+	delete Table;
+	return Timings;
+}
+
+static void PrintTimings(const char* Name, const HashTableTimings& Timings, int32_t Count)
+{
+	double Scale = 1000000000.0 / (double)Count;
+	BENCH_LOG("%-20s %9.2lf %9.2lf %9.2lf %9.2lf", Name, Timings.Insert * Scale, Timings.Hit * Scale, Timings.Miss * Scale, Timings.Erase * Scale);
+}
+
+static void PrintHeader(const char* Title)
+{
+	BENCH_LOG("%s", Title);
+	BENCH_LOG("%-20s %9s %9s %9s %9s", "table", "insert", "hit", "miss", "erase");
+}
+
+BIT_BENCHMARK(HashTableIntKeys)
+{
+	static const int32_t COUNTS[] = { 1024, 64 * 1024, 1024 * 1024 };
+	for (int32_t Count : COUNTS)
+	{
+		int32_t* Keys = (int32_t*)malloc(sizeof(int32_t) * Count);
+		for (int32_t Index = 0; Index < Count; ++Index) Keys[Index] = Index;
+		ShuffleKeys(Keys, Count, 0x9E3779B97F4A7C15ULL);
+
+		// Small tables are repeated so the timer resolution doesn't matter
+		int32_t Repeat = bit::Max(1, (1024 * 1024) / Count);
+		HashTableTimings BitTotal = {};
+		HashTableTimings StdTotal = {};
+		for (int32_t Run = 0; Run < Repeat; ++Run)
+		{
+			HashTableTimings BitRun = TimeIntTable<BitIntTable>(Keys, Count);
+			HashTableTimings StdRun = TimeIntTable<StdIntTable>(Keys, Count);
+			BitTotal = { BitTotal.Insert + BitRun.Insert, BitTotal.Hit + BitRun.Hit, BitTotal.Miss + BitRun.Miss, BitTotal.Erase + BitRun.Erase };
+			StdTotal = { StdTotal.Insert + StdRun.Insert, StdTotal.Hit + StdRun.Hit, StdTotal.Miss + StdRun.Miss, StdTotal.Erase + StdRun.Erase };
+		}
+
+		char Title[64];
+		snprintf(Title, sizeof(Title), "%d int32_t keys, ns/op", Count);
+		PrintHeader(Title);
+		PrintTimings("bit::HashTable", BitTotal, Count * Repeat);
+		PrintTimings("std::unordered_map", StdTotal, Count * Repeat);
+		free(Keys);
+	}
+}
+
+/* Lower max load factors trade memory for shorter probe sequences */
+BIT_BENCHMARK(HashTableLoadFactor)
+{
+	static constexpr int32_t COUNT = 1024 * 1024;
+	static const float FACTORS[] = { 0.5f, 0.75f, 0.875f };
+	int32_t* Keys = (int32_t*)malloc(sizeof(int32_t) * COUNT);
+	for (int32_t Index = 0; Index < COUNT; ++Index) Keys[Index] = Index;
+	ShuffleKeys(Keys, COUNT, 0xC2B2AE3D27D4EB4FULL);
+
+	PrintHeader("1048576 int32_t keys by max load factor, ns/op");
+	for (float Factor : FACTORS)
+	{
+		char Name[32];
+		snprintf(Name, sizeof(Name), "bit::HashTable %.3f", Factor);
+		PrintTimings(Name, TimeIntTable<BitIntTable>(Keys, COUNT, Factor), COUNT);
+	}
+	free(Keys);
+}
+
+static int32_t CompareSeconds(const void* A, const void* B)
+{
+	double Left = *(const double*)A;
+	double Right = *(const double*)B;
+	return Left < Right ? -1 : (Left > Right ? 1 : 0);
+}
+
+/* Times every insert on its own. Growing the whole table at once shows up in the
+   tail, incremental rehashing spreads it over the inserts that follow. */
+BIT_BENCHMARK(HashTableInsertLatency)
+{
+	static constexpr int32_t COUNT = 4 * 1024 * 1024;
+	double* Samples = (double*)malloc(sizeof(double) * COUNT);
+	BENCH_LOG("4194304 int32_t inserts, ns/insert");
+	BENCH_LOG("%-20s %9s %9s %9s %9s %9s", "table", "p50", "p99", "p99.99", "max", "total ms");
+	for (int32_t Mode = 0; Mode < 2; ++Mode)
+	{
+		bit::HashTable<int32_t, int32_t>* Table = new bit::HashTable<int32_t, int32_t>();
+		Table->SetIncrementalReHash(Mode == 1);
+		double Total = 0.0;
+		for (int32_t Key = 0; Key < COUNT; ++Key)
+		{
+			double Start = bit::GetSeconds();
+			Table->Insert(Key, Key);
+			Samples[Key] = bit::GetSeconds() - Start;
+			Total += Samples[Key];
+		}
+		delete Table;
+		qsort(Samples, COUNT, sizeof(double), &CompareSeconds);
+		BENCH_LOG("%-20s %9.0lf %9.0lf %9.0lf %9.0lf %9.2lf", Mode == 1 ? "incremental rehash" : "full rehash",
+			Samples[COUNT / 2] * 1e9, Samples[(int64_t)COUNT * 99 / 100] * 1e9, Samples[(int64_t)COUNT * 9999 / 10000] * 1e9, Samples[COUNT - 1] * 1e9, Total * 1e3);
+	}
+	free(Samples);
+}
+
+template<typename TTable, typename TKey>
+static HashTableTimings TimeStringTable(const TKey* Keys, int32_t Count)
+{
+	// Keys past Count are never inserted
+	HashTableTimings Timings = {};
+	TTable* Table = new TTable();
+	bit::ProfTimer Timer;
+
+	Timer.Begin();
+	for (int32_t Index = 0; Index < Count; ++Index) (*Table)[Keys[Index]] = Index;
+	Timings.Insert = Timer.End();
+
+	int32_t Found = 0;
+	Timer.Begin();
+	for (int32_t Index = 0; Index < Count; ++Index) Found += Table->Contains(Keys[GetLookupIndex(Index, Count)]) ? 1 : 0;
+	Timings.Hit = Timer.End();
+	Timer.Begin();
+	for (int32_t Index = Count; Index < Count * 2; ++Index) Found += Table->Contains(Keys[Index]) ? 1 : 0;
+	Timings.Miss = Timer.End();
+	DoNotOptimize(Found);
+
+	Timer.Begin();
+	for (int32_t Index = 0; Index < Count; ++Index) Table->Erase(Keys[Index]);
+	Timings.Erase = Timer.End();
+
+	delete Table;
+	return Timings;
+}
+
+struct StdStringTable : public std::unordered_map<std::string, int32_t>
+{
+	bool Contains(const std::string& Key) { return find(Key) != end(); }
+	void Erase(const std::string& Key) { erase(Key); }
+};
+
+BIT_BENCHMARK(HashTableStringKeys)
+{
+	static constexpr int32_t COUNT = 256 * 1024;
+	bit::String* BitKeys = new bit::String[COUNT * 2];
+	std::string* StdKeys = new std::string[COUNT * 2];
+	for (int32_t Index = 0; Index < COUNT * 2; ++Index)
+	{
+		char Name[64];
+		snprintf(Name, sizeof(Name), "asset/texture/%08x.png", (uint32_t)Index * 2654435761u);
+		BitKeys[Index] = Name;
+		StdKeys[Index] = Name;
+	}
+
+	PrintHeader("262144 string keys, ns/op");
+	PrintTimings("bit::HashTable", TimeStringTable<bit::HashTable<bit::String, int32_t>>(BitKeys, COUNT), COUNT);
+	PrintTimings("std::unordered_map", TimeStringTable<StdStringTable>(StdKeys, COUNT), COUNT);
+	delete[] BitKeys;
+	delete[] StdKeys;
+}
+
+/* Looks up String keys from raw character data the way a parser or asset loader would.
+   Building a String for the lookup heap allocates once the name is past the small
+   string buffer. A StringView doesn't, and passing the hash skips rehashing too. */
+BIT_BENCHMARK(HashTableStringLookup)
+{
+	static constexpr int32_t COUNT = 256 * 1024;
+	static constexpr int32_t NAME_SIZE = 32;
+	char* Names = (char*)malloc((size_t)COUNT * NAME_SIZE);
+	bit::SizeType_t* Lengths = (bit::SizeType_t*)malloc(sizeof(bit::SizeType_t) * COUNT);
+	size_t* Hashes = (size_t*)malloc(sizeof(size_t) * COUNT);
+	bit::HashTable<bit::String, int32_t> Table;
+	for (int32_t Index = 0; Index < COUNT; ++Index)
+	{
+		char* Name = &Names[Index * NAME_SIZE];
+		Lengths[Index] = snprintf(Name, NAME_SIZE, "asset/texture/%08x.png", (uint32_t)Index * 2654435761u);
+		Table.Insert(bit::String(Name, Lengths[Index]), Index);
+		Hashes[Index] = Table.GetHash(bit::StringView(Name, Lengths[Index]));
+	}
+
+	bit::ProfTimer Timer;
+	int32_t Found = 0;
+	Timer.Begin();
+	for (int32_t Index = 0; Index < COUNT; ++Index)
+	{
+		int32_t Key = GetLookupIndex(Index, COUNT);
+		Found += Table.Contains(bit::String(&Names[Key * NAME_SIZE], Lengths[Key])) ? 1 : 0;
+	}
+	double StringTime = Timer.End();
+	Timer.Begin();
+	for (int32_t Index = 0; Index < COUNT; ++Index)
+	{
+		int32_t Key = GetLookupIndex(Index, COUNT);
+		Found += Table.Contains(bit::StringView(&Names[Key * NAME_SIZE], Lengths[Key])) ? 1 : 0;
+	}
+	double ViewTime = Timer.End();
+	Timer.Begin();
+	for (int32_t Index = 0; Index < COUNT; ++Index)
+	{
+		int32_t Key = GetLookupIndex(Index, COUNT);
+		Found += Table.Contains(bit::StringView(&Names[Key * NAME_SIZE], Lengths[Key]), Hashes[Key]) ? 1 : 0;
+	}
+	double HashedTime = Timer.End();
+	DoNotOptimize(Found);
+
+	double Scale = 1000000000.0 / (double)COUNT;
+	BENCH_LOG("262144 string keys, ns/lookup");
+	BENCH_LOG("%-28s %9.2lf", "String temporary", StringTime * Scale);
+	BENCH_LOG("%-28s %9.2lf", "StringView", ViewTime * Scale);
+	BENCH_LOG("%-28s %9.2lf", "StringView + hash", HashedTime * Scale);
+	free(Names);
+	free(Lengths);
+	free(Hashes);
+}
+
+struct LockedIntTable
+{
+	bit::HashTable<int32_t, int32_t> Table;
+	bit::RWLock Lock;
+	void Insert(int32_t Key) { bit::ScopedWriteLock Scope(&Lock); Table.Insert(Key, Key); }
+	bool Contains(int32_t Key) { bit::ScopedReadLock Scope(&Lock); return Table.Contains(Key); }
+};
+
+struct ConcurrentIntTable
+{
+	bit::ConcurrentHashTable<int32_t, int32_t> Table;
+	void Insert(int32_t Key) { Table.Insert(Key, Key); }
+	bool Contains(int32_t Key) { return Table.Contains(Key); }
+};
+
+template<typename TTable>
+struct SharedTableRun
+{
+	static constexpr int32_t KEY_COUNT = 64 * 1024;
+	static constexpr int32_t LOOKUPS_PER_READER = 1024 * 1024;
+
+	TTable Table;
+	int32_t bReadersDone;
+	int32_t ReadersLeft;
+
+	static int32_t ReaderMain(void* UserData)
+	{
+		SharedTableRun* Run = (SharedTableRun*)UserData;
+		uint64_t State = (uint64_t)(uintptr_t)&State | 1;
+		int32_t Found = 0;
+		for (int32_t Index = 0; Index < LOOKUPS_PER_READER; ++Index)
+		{
+			Found += Run->Table.Contains((int32_t)(NextRandom(State) % KEY_COUNT)) ? 1 : 0;
+		}
+		DoNotOptimize(Found);
+		if (bit::AtomicDecrement(&Run->ReadersLeft) == 0) bit::AtomicExchange(&Run->bReadersDone, 1);
+		return 0;
+	}
+
+	/* The writer keeps overwriting keys until every reader finished */
+	static int32_t WriterMain(void* UserData)
+	{
+		SharedTableRun* Run = (SharedTableRun*)UserData;
+		for (int32_t Key = 0; bit::AtomicLoad(&Run->bReadersDone) == 0; Key = (Key + 1) % KEY_COUNT)
+		{
+			Run->Table.Insert(Key);
+		}
+		return 0;
+	}
+};
+
+/* Returns ns per lookup with ReaderCount threads reading and one thread writing */
+template<typename TTable>
+static double TimeSharedTable(int32_t ReaderCount)
+{
+	typedef SharedTableRun<TTable> Run_t;
+	Run_t* Run = new Run_t();
+	for (int32_t Key = 0; Key < Run_t::KEY_COUNT; ++Key) Run->Table.Insert(Key);
+	Run->bReadersDone = 0;
+	Run->ReadersLeft = ReaderCount;
+
+	bit::Thread Threads[33];
+	bit::ProfTimer Timer;
+	Timer.Begin();
+	Threads[0].Start(&Run_t::WriterMain, 64 * 1024, Run);
+	for (int32_t Index = 1; Index <= ReaderCount; ++Index) Threads[Index].Start(&Run_t::ReaderMain, 64 * 1024, Run);
+	for (int32_t Index = 0; Index <= ReaderCount; ++Index) Threads[Index].Join();
+	double Time = Timer.End();
+	delete Run;
+	return Time * 1000000000.0 / ((double)Run_t::LOOKUPS_PER_READER * ReaderCount);
+}
+
+/* Read-mostly table shared by many threads. A HashTable behind an RWLock against
+   ConcurrentHashTable, whose lookups take no lock. */
+BIT_BENCHMARK(HashTableSharedReads)
+{
+	static const int32_t READER_COUNTS[] = { 1, 4, 16, 32 };
+	BENCH_LOG("65536 int32_t keys, 1 writer, ns/lookup");
+	BENCH_LOG("%-8s %20s %20s", "readers", "HashTable+RWLock", "ConcurrentHashTable");
+	for (int32_t ReaderCount : READER_COUNTS)
+	{
+		BENCH_LOG("%-8d %20.2lf %20.2lf", ReaderCount, TimeSharedTable<LockedIntTable>(ReaderCount), TimeSharedTable<ConcurrentIntTable>(ReaderCount));
+	}
+}
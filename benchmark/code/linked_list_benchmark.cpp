@@ -0,0 +1,145 @@
+#include "benchmark.h"
+#include <bit/container/linked_list.h>
+#include <bit/container/unrolled_linked_list.h>
+#include <list>
+#include <stdio.h>
+
+/* Compares bit::LinkedList and bit::UnrolledLinkedList against std::list. Insert appends Count elements, Traverse sums
+   them, Churn erases the older half from the front and appends as many again so freed
+   nodes get reused, Traverse after churn walks the list that results. */
+
+struct LinkedListTimes
+{
+	double Insert;
+	double Traverse;
+	double Churn;
+	double TraverseAfterChurn;
+};
+
+template<typename TList>
+static int64_t SumList(const TList& List)
+{
+	int64_t Sum = 0;
+	for (const int32_t& Value : List) Sum += Value;
+	return Sum;
+}
+
+template<typename TList>
+static LinkedListTimes RunBitList(int32_t Count)
+{
+	LinkedListTimes Times = {};
+	bit::ProfTimer Timer;
+	TList List;
+
+	Timer.Begin();
+	for (int32_t Value = 0; Value < Count; ++Value) List.Insert(Value);
+	Times.Insert = Timer.End();
+
+	Timer.Begin();
+	int64_t Sum = SumList(List);
+	Times.Traverse = Timer.End();
+
+	Timer.Begin();
+	for (int32_t Value = 0; Value < Count / 2; ++Value)
+	{
+		List.Erase(Value);
+		List.Insert(Count + Value);
+	}
+	Times.Churn = Timer.End();
+
+	Timer.Begin();
+	Sum += SumList(List);
+	Times.TraverseAfterChurn = Timer.End();
+	DoNotOptimize(Sum);
+	return Times;
+}
+
+static LinkedListTimes RunStdList(int32_t Count)
+{
+	LinkedListTimes Times = {};
+	bit::ProfTimer Timer;
+	std::list<int32_t> List;
+
+	Timer.Begin();
+	for (int32_t Value = 0; Value < Count; ++Value) List.push_back(Value);
+	Times.Insert = Timer.End();
+
+	Timer.Begin();
+	int64_t Sum = SumList(List);
+	Times.Traverse = Timer.End();
+
+	Timer.Begin();
+	for (int32_t Value = 0; Value < Count / 2; ++Value)
+	{
+		List.pop_front();
+		List.push_back(Count + Value);
+	}
+	Times.Churn = Timer.End();
+
+	Timer.Begin();
+	Sum += SumList(List);
+	Times.TraverseAfterChurn = Timer.End();
+	DoNotOptimize(Sum);
+	return Times;
+}
+
+BIT_BENCHMARK(LinkedList)
+{
+	static const int32_t COUNTS[] = { 1024, 64 * 1024, 1024 * 1024 };
+	BENCH_LOG("%-10s %-18s %12s %12s %12s %12s", "count", "list", "insert ns", "traverse ns", "churn ns", "traverse ns");
+	for (int32_t Count : COUNTS)
+	{
+		LinkedListTimes BitTimes = RunBitList<bit::LinkedList<int32_t>>(Count);
+		LinkedListTimes UnrolledTimes = RunBitList<bit::UnrolledLinkedList<int32_t>>(Count);
+		LinkedListTimes StdTimes = RunStdList(Count);
+		const LinkedListTimes* AllTimes[] = { &BitTimes, &UnrolledTimes, &StdTimes };
+		const char* NAMES[] = { "bit::LinkedList", "UnrolledLinkedList", "std::list" };
+		for (int32_t Index = 0; Index < 3; ++Index)
+		{
+			const LinkedListTimes& Times = *AllTimes[Index];
+			BENCH_LOG("%-10d %-18s %12.2lf %12.2lf %12.2lf %12.2lf", Count, NAMES[Index],
+				Times.Insert * 1e9 / Count, Times.Traverse * 1e9 / Count,
+				Times.Churn * 1e9 / (Count / 2), Times.TraverseAfterChurn * 1e9 / Count);
+		}
+	}
+}
+
+template<typename TList>
+static void RunIndexed(const char* Name, int32_t Count, int32_t RandomLookups)
+{
+	TList List;
+	for (int32_t Value = 0; Value < Count; ++Value) List.Insert(Value);
+	bit::ProfTimer Timer;
+	int64_t Sum = 0;
+
+	Timer.Begin();
+	for (int32_t Index = 0; Index < Count; ++Index) Sum += List[Index];
+	double SequentialTime = Timer.End();
+
+	uint64_t State = 0x9E3779B97F4A7C15ULL;
+	Timer.Begin();
+	for (int32_t Lookup = 0; Lookup < RandomLookups; ++Lookup)
+	{
+		State ^= State << 13;
+		State ^= State >> 7;
+		State ^= State << 17;
+		Sum += List[(bit::SizeType_t)(State % (uint64_t)Count)];
+	}
+	double RandomTime = Timer.End();
+	DoNotOptimize(Sum);
+	BENCH_LOG("%-10d %-18s %14.2lf %14.2lf", Count, Name, SequentialTime * 1e9 / Count, RandomTime * 1e9 / RandomLookups);
+}
+
+/* List[Index] in order and at random indices. LinkedList walks from the head every time so
+   it only runs on the smaller lists. */
+BIT_BENCHMARK(LinkedListIndexed)
+{
+	static const int32_t COUNTS[] = { 1024, 16 * 1024, 256 * 1024 };
+	BENCH_LOG("%-10s %-18s %14s %14s", "count", "list", "sequential ns", "random ns");
+	for (int32_t Count : COUNTS)
+	{
+		int32_t RandomLookups = bit::Max(4 * 1024 * 1024 / Count, 16);
+		if (Count <= 16 * 1024) RunIndexed<bit::LinkedList<int32_t>>("bit::LinkedList", Count, RandomLookups);
+		RunIndexed<bit::UnrolledLinkedList<int32_t>>("UnrolledLinkedList", Count, RandomLookups);
+	}
+}
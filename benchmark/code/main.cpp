@@ -0,0 +1,33 @@
+#include "benchmark.h"
+#include <bit/core/memory.h>
+#include <string.h>
+
+static BenchmarkEntry* GBenchmarks = nullptr;
+
+BenchmarkRegistrar::BenchmarkRegistrar(BenchmarkEntry* Entry)
+{
+	// Keep registration order stable so runs are comparable
+	BenchmarkEntry** Tail = &GBenchmarks;
+	while (*Tail != nullptr) Tail = &(*Tail)->Next;
+	*Tail = Entry;
+}
+
+BenchmarkEntry* BenchmarkRegistrar::GetBenchmarks()
+{
+	return GBenchmarks;
+}
+
+int main(int32_t Argc, const char* Argv[])
+{
+	const char* Filter = Argc > 1 ? Argv[1] : nullptr;
+	for (BenchmarkEntry* Entry = BenchmarkRegistrar::GetBenchmarks(); Entry != nullptr; Entry = Entry->Next)
+	{
+		if (Filter != nullptr && strstr(Entry->Name, Filter) == nullptr) continue;
+		BIT_ALWAYS_LOG("[%s]", Entry->Name);
+		bit::ProfTimer Timer;
+		Timer.Begin();
+		Entry->Function();
+		BIT_ALWAYS_LOG("  total %.3lf secs\n", Timer.End());
+	}
+	return 0;
+}
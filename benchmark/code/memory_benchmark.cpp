@@ -0,0 +1,159 @@
+#include "benchmark.h"
+#include <bit/core/memory.h>
+#include <bit/core/os/os.h>
+#include <bit/core/os/virtual_memory.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+/* Compares bit::Memcpy, Memset and Memcmp against the C runtime over a size sweep.
+   Small sizes cycle through offsets inside a 64 KiB window so the data stays in L1/L2,
+   large sizes walk a window twice their size. */
+
+static constexpr size_t BUFFER_SIZE = 200 * 1024 * 1024; // Largest window plus the largest size
+static constexpr size_t BYTES_PER_SIZE = 1024 * 1024 * 1024;
+
+enum class MemoryOp
+{
+	COPY,
+	SET,
+	COMPARE
+};
+
+template<MemoryOp Op, bool bUseBit>
+static double RunMemoryOp(uint8_t* Dst, const uint8_t* Src, size_t Size)
+{
+	size_t Window = bit::Max(bit::NextPow2(Size * 2), (size_t)64 * 1024);
+	size_t Count = bit::Max(BYTES_PER_SIZE / Size, (size_t)4);
+	size_t Sum = 0;
+	bit::ProfTimer Timer;
+	Timer.Begin();
+	for (size_t Index = 0; Index < Count; ++Index)
+	{
+		// Offsets step by an odd amount so every alignment gets hit
+		size_t Offset = (Index * 4099) & (Window - 1);
+		uint8_t* To = Dst + Offset;
+		const uint8_t* From = Src + Offset + 1536; // Keeps loads and stores out of 4 KiB aliasing
+		switch (Op)
+		{
+		case MemoryOp::COPY:
+			if (bUseBit) bit::Memcpy(To, From, Size);
+			else memcpy(To, From, Size);
+			break;
+		case MemoryOp::SET:
+			if (bUseBit) bit::Memset(To, (int32_t)Index, Size);
+			else memset(To, (int32_t)Index, Size);
+			break;
+		case MemoryOp::COMPARE:
+			if (bUseBit) Sum += bit::Memcmp(To, From, Size);
+			else Sum += memcmp(To, From, Size) == 0;
+			break;
+		}
+		DoNotOptimize(To);
+	}
+	double Time = Timer.End();
+	DoNotOptimize(Sum);
+	return (double)Count * (double)Size / Time / 1e9;
+}
+
+BIT_BENCHMARK(MemoryOps)
+{
+	static const size_t SIZES[] =
+	{
+		8, 16, 24, 32, 48, 64, 96, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 65536,
+		256 * 1024, 1024 * 1024, 4 * 1024 * 1024, 16 * 1024 * 1024, 64 * 1024 * 1024
+	};
+	uint8_t* Src = (uint8_t*)malloc(BUFFER_SIZE);
+	uint8_t* Dst = (uint8_t*)malloc(BUFFER_SIZE);
+	memset(Src, 0x5A, BUFFER_SIZE);
+	memset(Dst, 0x5A, BUFFER_SIZE);
+
+	const bit::ProcessorFeatures& Features = bit::GetOSProcessorFeatures();
+	BENCH_LOG("SSE2 %d, AVX2 %d, ERMS %d, FSRM %d, last level cache %.1lf MiB", Features.bSSE2, Features.bAVX2,
+		Features.bERMS, Features.bFSRM, bit::FromMiB(Features.LastLevelCacheSize));
+	BENCH_LOG("%-10s %12s %12s %12s %12s %12s %12s", "bytes", "bit::Memcpy", "memcpy", "bit::Memset", "memset", "bit::Memcmp", "memcmp");
+	for (size_t Size : SIZES)
+	{
+		BENCH_LOG("%-10zu %9.2lf GB/s %7.2lf GB/s %7.2lf GB/s %7.2lf GB/s %7.2lf GB/s %7.2lf GB/s", Size,
+			RunMemoryOp<MemoryOp::COPY, true>(Dst, Src, Size), RunMemoryOp<MemoryOp::COPY, false>(Dst, Src, Size),
+			RunMemoryOp<MemoryOp::SET, true>(Dst, Src, Size), RunMemoryOp<MemoryOp::SET, false>(Dst, Src, Size),
+			RunMemoryOp<MemoryOp::COMPARE, true>(Dst, Src, Size), RunMemoryOp<MemoryOp::COMPARE, false>(Dst, Src, Size));
+	}
+	free(Src);
+	free(Dst);
+}
+
+enum class ClearMethod
+{
+	MEMSET,
+	BIT_MEMSET,
+	STREAM_ZERO,
+	ZERO_PAGES
+};
+
+static constexpr size_t CLEAR_ARENA_SIZE = 64 MiB;
+static constexpr size_t CLEAR_HOT_SIZE = 1 MiB;
+static constexpr int32_t CLEAR_ROUNDS = 16;
+
+static uint64_t SumHotSet(const uint64_t* Hot)
+{
+	uint64_t Sum = 0;
+	for (size_t Index = 0; Index < CLEAR_HOT_SIZE / sizeof(uint64_t); Index += 8) Sum += Hot[Index];
+	return Sum;
+}
+
+/* A used arena is cleared while a small hot set is being worked on. Reports the time of
+   the clear, of the first pass over the hot set after it, and of the next fill of the
+   arena, which is where ZeroPages pays for its page faults. */
+static void RunClear(const char* Name, ClearMethod Method, bit::VirtualMemoryBlock& Arena, uint64_t* Hot)
+{
+	uint8_t* Base = (uint8_t*)Arena.GetBaseAddress();
+	double ClearTime = 0.0;
+	double HotTime = 0.0;
+	double FillTime = 0.0;
+	uint64_t Sum = 0;
+	memset(Base, 0x5A, CLEAR_ARENA_SIZE);
+	for (int32_t Round = 0; Round < CLEAR_ROUNDS; ++Round)
+	{
+		Sum += SumHotSet(Hot);
+		Sum += SumHotSet(Hot);
+		bit::ProfTimer Timer;
+		Timer.Begin();
+		switch (Method)
+		{
+		case ClearMethod::MEMSET: memset(Base, 0, CLEAR_ARENA_SIZE); break;
+		case ClearMethod::BIT_MEMSET: bit::Memset(Base, 0, CLEAR_ARENA_SIZE); break;
+		case ClearMethod::STREAM_ZERO: bit::StreamZero(Base, CLEAR_ARENA_SIZE); break;
+		case ClearMethod::ZERO_PAGES: Arena.ZeroPagesByAddress(Base, CLEAR_ARENA_SIZE); break;
+		}
+		ClearTime += Timer.End();
+		Timer.Begin();
+		Sum += SumHotSet(Hot);
+		HotTime += Timer.End();
+		Timer.Begin();
+		for (size_t Offset = 0; Offset < CLEAR_ARENA_SIZE; Offset += 64) Base[Offset] = (uint8_t)Round;
+		FillTime += Timer.End();
+	}
+	DoNotOptimize(Sum);
+	BENCH_LOG("%-16s clear %8.3lf ms   hot set after %7.3lf us   next fill %8.3lf ms", Name,
+		ClearTime * 1000.0 / CLEAR_ROUNDS, HotTime * 1e6 / CLEAR_ROUNDS, FillTime * 1000.0 / CLEAR_ROUNDS);
+}
+
+BIT_BENCHMARK(MemoryClear)
+{
+	bit::VirtualMemoryBlock Arena;
+	if (!bit::VirtualAllocateBlock(CLEAR_ARENA_SIZE, Arena) || Arena.CommitAll() == nullptr)
+	{
+		BENCH_LOG("Failed to allocate the arena");
+		return;
+	}
+	uint64_t* Hot = (uint64_t*)malloc(CLEAR_HOT_SIZE);
+	memset(Hot, 1, CLEAR_HOT_SIZE);
+	BENCH_LOG("Clearing a %.0lf MiB arena next to a %.0lf MiB hot set", bit::FromMiB(CLEAR_ARENA_SIZE), bit::FromMiB(CLEAR_HOT_SIZE));
+	RunClear("memset", ClearMethod::MEMSET, Arena, Hot);
+	RunClear("bit::Memset", ClearMethod::BIT_MEMSET, Arena, Hot);
+	RunClear("bit::StreamZero", ClearMethod::STREAM_ZERO, Arena, Hot);
+	RunClear("ZeroPages", ClearMethod::ZERO_PAGES, Arena, Hot);
+	free(Hot);
+	bit::VirtualFreeBlock(Arena);
+}
@@ -0,0 +1,144 @@
+#include "benchmark.h"
+#include <bit/core/memory.h>
+#include <bit/core/memory/system/tlsf_allocator.h>
+#include <stdlib.h>
+
+/* Measures how many bytes TLSFAllocator::Reallocate avoids copying by resizing blocks
+   in place, compared to the allocate-copy-free path it used before. */
+
+struct ReallocCounters
+{
+	uint64_t InPlaceCount = 0;
+	uint64_t MovedCount = 0;
+	uint64_t BytesCopied = 0;
+	uint64_t BytesNotCopied = 0;
+};
+
+static constexpr int32_t BUFFER_COUNT = 64;
+static constexpr size_t MIN_BUFFER_SIZE = 64;
+static constexpr size_t MAX_BUFFER_SIZE = 8 MiB;
+
+static void* CopyRealloc(bit::TLSFAllocator& Allocator, void* Pointer, size_t OldSize, size_t Size)
+{
+	void* NewBlock = Allocator.Allocate(Size, bit::DEFAULT_ALIGNMENT);
+	bit::Memcpy(NewBlock, Pointer, bit::Min(OldSize, Size));
+	Allocator.Free(Pointer);
+	return NewBlock;
+}
+
+template<bool bInPlace>
+static double RunGrowthPattern(bit::TLSFAllocator& Allocator, ReallocCounters& Counters, uint32_t Seed)
+{
+	void* Buffers[BUFFER_COUNT] = {};
+	size_t Sizes[BUFFER_COUNT] = {};
+	srand(Seed);
+
+	bit::ProfTimer Timer;
+	Timer.Begin();
+	for (int32_t Index = 0; Index < BUFFER_COUNT; ++Index)
+	{
+		Sizes[Index] = MIN_BUFFER_SIZE;
+		Buffers[Index] = Allocator.Allocate(Sizes[Index], bit::DEFAULT_ALIGNMENT);
+	}
+
+	// Buffers grow by 1.5x in random order, like many Arrays being filled at once.
+	// Every 8th step shrinks a buffer back down to simulate Shrink/Resize.
+	for (int32_t Step = 0; Step < 5000; ++Step)
+	{
+		int32_t Index = rand() % BUFFER_COUNT;
+		size_t OldSize = Sizes[Index];
+		size_t NewSize = (Step % 8) == 7 ? bit::Max(OldSize / 4, MIN_BUFFER_SIZE) : OldSize + OldSize / 2;
+		if (NewSize > MAX_BUFFER_SIZE) NewSize = MIN_BUFFER_SIZE;
+		size_t CopySize = bit::Min(OldSize, NewSize);
+
+		void* NewBuffer = nullptr;
+		if (bInPlace)
+		{
+			NewBuffer = Allocator.Reallocate(Buffers[Index], NewSize, bit::DEFAULT_ALIGNMENT);
+		}
+		else
+		{
+			NewBuffer = CopyRealloc(Allocator, Buffers[Index], OldSize, NewSize);
+		}
+
+		if (NewBuffer == Buffers[Index])
+		{
+			Counters.InPlaceCount += 1;
+			Counters.BytesNotCopied += CopySize;
+		}
+		else
+		{
+			Counters.MovedCount += 1;
+			Counters.BytesCopied += CopySize;
+		}
+		Buffers[Index] = NewBuffer;
+		Sizes[Index] = NewSize;
+	}
+
+	for (int32_t Index = 0; Index < BUFFER_COUNT; ++Index)
+	{
+		Allocator.Free(Buffers[Index]);
+	}
+	return Timer.End();
+}
+
+static void PrintCounters(const char* Name, double Time, const ReallocCounters& Counters)
+{
+	uint64_t Total = Counters.InPlaceCount + Counters.MovedCount;
+	BENCH_LOG("%-12s %8.3lf ms  %6.2lf ns/op  in-place %5.1lf%%  copied %8.2lf MiB  avoided %8.2lf MiB",
+		Name, Time * 1000.0, Time * 1e9 / (double)Total,
+		100.0 * (double)Counters.InPlaceCount / (double)Total,
+		bit::FromMiB((size_t)Counters.BytesCopied),
+		bit::FromMiB((size_t)Counters.BytesNotCopied));
+}
+
+BIT_BENCHMARK(TLSFReallocGrowth)
+{
+	bit::TLSFAllocator* Allocator = bit::New<bit::TLSFAllocator>();
+	ReallocCounters CopyCounters;
+	ReallocCounters InPlaceCounters;
+	double CopyTime = RunGrowthPattern<false>(*Allocator, CopyCounters, 1234);
+	double InPlaceTime = RunGrowthPattern<true>(*Allocator, InPlaceCounters, 1234);
+	PrintCounters("copy", CopyTime, CopyCounters);
+	PrintCounters("in-place", InPlaceTime, InPlaceCounters);
+	bit::Delete(Allocator);
+}
+
+BIT_BENCHMARK(GlobalReallocGrowth)
+{
+	static constexpr int32_t STEP_COUNT = 20000;
+	void* Buffers[BUFFER_COUNT] = {};
+	size_t Sizes[BUFFER_COUNT] = {};
+	ReallocCounters Counters;
+	srand(4321);
+
+	bit::ProfTimer Timer;
+	Timer.Begin();
+	for (int32_t Step = 0; Step < STEP_COUNT; ++Step)
+	{
+		int32_t Index = rand() % BUFFER_COUNT;
+		size_t OldSize = Sizes[Index];
+		size_t NewSize = OldSize == 0 ? MIN_BUFFER_SIZE : OldSize + OldSize / 2;
+		if (NewSize > MAX_BUFFER_SIZE) NewSize = MIN_BUFFER_SIZE;
+		void* NewBuffer = bit::Realloc(Buffers[Index], NewSize);
+		if (NewBuffer == Buffers[Index])
+		{
+			Counters.InPlaceCount += 1;
+			Counters.BytesNotCopied += bit::Min(OldSize, NewSize);
+		}
+		else
+		{
+			Counters.MovedCount += 1;
+			Counters.BytesCopied += bit::Min(OldSize, NewSize);
+		}
+		Buffers[Index] = NewBuffer;
+		Sizes[Index] = NewSize;
+	}
+	double Time = Timer.End();
+
+	for (int32_t Index = 0; Index < BUFFER_COUNT; ++Index)
+	{
+		bit::Free(Buffers[Index]);
+	}
+	PrintCounters("bit::Realloc", Time, Counters);
+}
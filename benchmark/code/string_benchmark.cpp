@@ -0,0 +1,94 @@
+#include "benchmark.h"
+#include <bit/core/memory.h>
+#include <bit/utility/utility.h>
+#include <string_view>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+/* Compares bit::Strlen, Strcmp, StrContains and StrFind against the C runtime and
+   std::string_view::find on random lowercase text. Strcmp compares every string with
+   an equal copy so it has to scan to the end, the needle of the searches is never
+   found for the same reason. */
+
+static constexpr size_t STRING_BYTES = 512 * 1024;
+static constexpr size_t BYTES_PER_SIZE = 256 * 1024 * 1024;
+static const char* const NEEDLE = "qzxjvkwp";
+static constexpr size_t NEEDLE_LENGTH = 8;
+
+typedef size_t(*StringOp_t)(const char* Str, size_t Len, const char* Copy);
+
+struct StringOpEntry
+{
+	const char* Name;
+	StringOp_t Function;
+};
+
+static size_t BitStrlenOp(const char* Str, size_t, const char*) { return bit::Strlen(Str); }
+static size_t CrtStrlenOp(const char* Str, size_t, const char*) { return strlen(Str); }
+static size_t BitStrcmpOp(const char* Str, size_t, const char* Copy) { return bit::Strcmp(Str, Copy); }
+static size_t CrtStrcmpOp(const char* Str, size_t, const char* Copy) { return strcmp(Str, Copy) == 0; }
+static size_t BitStrContainsOp(const char* Str, size_t, const char*) { return bit::StrContains(Str, NEEDLE, nullptr); }
+static size_t CrtStrstrOp(const char* Str, size_t, const char*) { return strstr(Str, NEEDLE) != nullptr; }
+static size_t BitStrFindOp(const char* Str, size_t Len, const char*) { return bit::StrFind(Str, Len, NEEDLE, NEEDLE_LENGTH, nullptr); }
+static size_t StdFindOp(const char* Str, size_t Len, const char*) { return std::string_view(Str, Len).find(std::string_view(NEEDLE, NEEDLE_LENGTH)) != std::string_view::npos; }
+
+static const StringOpEntry STRING_OPS[] =
+{
+	{ "bit::Strlen", &BitStrlenOp },
+	{ "strlen", &CrtStrlenOp },
+	{ "bit::Strcmp", &BitStrcmpOp },
+	{ "strcmp", &CrtStrcmpOp },
+	{ "bit::StrContains", &BitStrContainsOp },
+	{ "strstr", &CrtStrstrOp },
+	{ "bit::StrFind", &BitStrFindOp },
+	{ "string_view::find", &StdFindOp }
+};
+
+BIT_BENCHMARK(StringOps)
+{
+	static const size_t LENGTHS[] = { 7, 16, 31, 64, 256, 1024, 4096, 64 * 1024 };
+	char* Strings = (char*)malloc(STRING_BYTES);
+	char* Copies = (char*)malloc(STRING_BYTES);
+	uint64_t State = 0x9E3779B97F4A7C15ULL;
+
+	BENCH_LOG("%-10s %12s %12s %12s %12s %12s %12s %12s %12s", "bytes", "bit::Strlen", "strlen", "bit::Strcmp", "strcmp",
+		"StrContains", "strstr", "bit::StrFind", "sv::find");
+	for (size_t Length : LENGTHS)
+	{
+		// Strings are packed back to back so they start at every alignment
+		size_t StringCount = STRING_BYTES / (Length + 1);
+		for (size_t Index = 0; Index < StringCount * (Length + 1); ++Index)
+		{
+			State ^= State << 13;
+			State ^= State >> 7;
+			State ^= State << 17;
+			Strings[Index] = (Index % (Length + 1)) == Length ? 0 : (char)('a' + (State >> 32) % 26);
+		}
+		memcpy(Copies + 1, Strings, StringCount * (Length + 1) - 1);
+
+		char Line[192];
+		int32_t LineLength = snprintf(Line, sizeof(Line), "%-10zu", Length);
+		for (const StringOpEntry& Entry : STRING_OPS)
+		{
+			size_t Count = bit::Max(BYTES_PER_SIZE / Length, (size_t)1);
+			size_t Sum = 0;
+			bit::ProfTimer Timer;
+			Timer.Begin();
+			for (size_t Index = 0; Index < Count; ++Index)
+			{
+				size_t Offset = (Index % StringCount) * (Length + 1);
+				Sum += Entry.Function(Strings + Offset, Length, Copies + Offset + 1);
+			}
+			double Time = Timer.End();
+			DoNotOptimize(Sum);
+			if (Length < 256)
+				LineLength += snprintf(Line + LineLength, sizeof(Line) - LineLength, " %7.2lf ns/op", Time * 1e9 / (double)Count);
+			else
+				LineLength += snprintf(Line + LineLength, sizeof(Line) - LineLength, " %7.2lf GB/s", (double)Count * (double)Length / Time / 1e9);
+		}
+		BENCH_LOG("%s", Line);
+	}
+	free(Strings);
+	free(Copies);
+}
@@ -82,12 +82,15 @@ namespace bit
 			Resize(InitialCapacity);
 		}
 
+		/* Trivially copyable elements come along with a copy of the whole block, others are
+		   copy constructed one by one */
 		Array(const SelfType_t& Copy) :
-			Storage(Copy.Storage),
-			Count(Copy.Count),
+			Count(0),
 			Capacity(Storage.GetBlockSize() / sizeof(T)),
 			Data((T*)Storage.GetBlock())
 		{
+			static_assert(bit::IsCopyConstructible<T>::Value, "Arrays of move only elements can't be copied");
+			CopyElements(Copy);
 		}
 
 		Array(SelfType_t&& Move) noexcept :
@@ -96,7 +99,7 @@ namespace bit
 			Data((T*)Storage.GetBlock())
 		{
 			Storage = bit::Move(Move.Storage);
-			Data = Move.Data;
+			Data = (T*)Storage.GetBlock();
 			Count = Move.Count;
 			Capacity = Move.Capacity;
 			Move.Count = 0;
@@ -150,15 +153,31 @@ namespace bit
 			}
 		}
 
-		/* We can either grow or shrink the internal storage for the array */
+		/* We can either grow or shrink the internal storage for the array. Shrinking below 
+		   the count destroys the elements that don't fit. Trivially relocatable elements are
+		   moved by reallocating the block, others are move constructed into the new one. */
 		void Resize(SizeType_t NewSize)
 		{
-			Storage.Allocate(sizeof(T), NewSize);
+			if (NewSize < Count)
+			{
+				bit::DestroyArray(GetData(NewSize), (size_t)(Count - NewSize));
+				Count = NewSize;
+			}
+			Storage.template AllocateElements<T>(NewSize, Count);
 			BIT_ASSERT(Storage.IsValid());
 			Data = (T*)Storage.GetBlock();
 			Capacity = NewSize;
 		}
 
+		/* Grows the storage to fit at least NewCapacity elements, never shrinks it */
+		void Reserve(SizeType_t NewCapacity)
+		{
+			if (NewCapacity > Capacity)
+			{
+				Resize(NewCapacity);
+			}
+		}
+
 		void Compact()
 		{
 			Resize(Count);
@@ -166,46 +185,140 @@ namespace bit
 
 		void Add(const T& Element)
 		{
-			Allocate(Element);
+			EmplaceBack(Element);
 		}
 
 		void Add(T&& Element)
 		{
-			Allocate(bit::Forward<T>(Element));
+			EmplaceBack(bit::Forward<T>(Element));
 		}
 
 		void Add(const T* Buffer, SizeType_t BufferCount)
 		{
-			CheckGrow(BufferCount);
-			for (SizeType_t Index = 0; Index < BufferCount; ++Index)
+			Append(Buffer, BufferCount);
+		}
+
+		void Add(const SelfType_t& Other)
+		{
+			Append(Other.GetData(), Other.GetCount());
+		}
+
+		/* Grows once for the whole range, trivially copyable elements are copied with a single Memcpy */
+		void Append(const T* Buffer, SizeType_t BufferCount)
+		{
+			if (BufferCount <= 0) return;
+			if (!CanAdd(BufferCount))
 			{
-				Add(Buffer[Index]);
+				// Buffer can be a range of this array, it has to follow the elements when they move
+				bool bFromSelf = bit::PtrInRange(Buffer, GetData(), GetData(Count));
+				SizeType_t BufferOffset = bFromSelf ? (SizeType_t)(Buffer - GetData()) : 0;
+				CheckGrow(BufferCount);
+				if (bFromSelf) Buffer = GetData(BufferOffset);
 			}
+			T* Dst = GetData(Count);
+			BIT_IF_CONSTEXPR (bit::IsTriviallyCopyable<T>::Value)
+			{
+				bit::Memcpy(Dst, Buffer, (size_t)BufferCount * sizeof(T));
+			}
+			else
+			{
+				for (SizeType_t Index = 0; Index < BufferCount; ++Index)
+				{
+					bit::Construct(&Dst[Index], Buffer[Index]);
+				}
+			}
+			Count += BufferCount;
 		}
 
-		void Add(const SelfType_t& Other)
+		void Append(const SelfType_t& Other)
 		{
-			CheckGrow(Other.GetCount());
-			Add(Other.GetData(), Other.GetCount());
+			Append(Other.GetData(), Other.GetCount());
 		}
 
 		T& AddEmpty()
 		{
-			CheckGrow();
-			T DefaultElement{};
-			Add(DefaultElement);
-			return GetLast();
+			return EmplaceBack();
+		}
+
+		/* Adds AddCount elements without constructing them and returns the first one. They
+		   have to be written before they are read, e.g. by copying into them from a file. */
+		T* AddUninitialized(SizeType_t AddCount)
+		{
+			static_assert(bit::IsTriviallyCopyable<T>::Value, "Only trivially copyable elements can be left uninitialized");
+			CheckGrow(AddCount);
+			T* First = GetData(Count);
+			Count += AddCount;
+			return First;
+		}
+
+		/* AddUninitialized with the new elements cleared to zero bytes */
+		T* AddZeroed(SizeType_t AddCount)
+		{
+			T* First = AddUninitialized(AddCount);
+			bit::Memset(First, 0, (size_t)AddCount * sizeof(T));
+			return First;
+		}
+
+		/* Sets the count without constructing or destroying anything, growing the storage to
+		   exactly NewCount if it's too small. For arrays used as IO buffers, where the size
+		   is known before the data is read into them. */
+		void SetCountUninitialized(SizeType_t NewCount)
+		{
+			static_assert(bit::IsTriviallyCopyable<T>::Value, "Only trivially copyable elements can be left uninitialized");
+			Reserve(NewCount);
+			Count = NewCount;
 		}
 
 		template<typename... TArgs>
-		T& Allocate(TArgs&& ... ConstructorArgs)
+		T& EmplaceBack(TArgs&& ... ConstructorArgs)
 		{
-			CheckGrow();
-			T* Ptr = &GetData()[Count++];
+			if (!CanAdd(1))
+			{
+				// The arguments may refer to elements that growing is about to free
+				T Element(bit::Forward<TArgs>(ConstructorArgs)...);
+				CheckGrow();
+				T* Ptr = GetData(Count);
+				bit::Construct(Ptr, bit::Move(Element));
+				Count += 1;
+				return *Ptr;
+			}
+			T* Ptr = GetData(Count);
 			bit::Construct(Ptr, bit::Forward<TArgs>(ConstructorArgs)...);
+			Count += 1;
 			return *Ptr;
 		}
 
+		template<typename... TArgs>
+		T& Allocate(TArgs&& ... ConstructorArgs)
+		{
+			return EmplaceBack(bit::Forward<TArgs>(ConstructorArgs)...);
+		}
+
+		/* Elements from Index on move up by one. Element is taken by value so it can be
+		   one of this array's own elements. */
+		T& InsertAt(SizeType_t Index, T Element)
+		{
+			BIT_ASSERT_MSG(Index >= 0 && Index <= Count, "Index out of bounds. Index = %d. Count = %d", Index, Count);
+			CheckGrow();
+			T* Slot = GetData(Index);
+			BIT_IF_CONSTEXPR (bit::IsTriviallyRelocatable<T>::Value)
+			{
+				bit::Memmove(Slot + 1, Slot, (size_t)(Count - Index) * sizeof(T));
+			}
+			else if (Index < Count)
+			{
+				bit::Construct(GetData(Count), bit::Move(Data[Count - 1]));
+				for (SizeType_t MoveIndex = Count - 1; MoveIndex > Index; --MoveIndex)
+				{
+					Data[MoveIndex] = bit::Move(Data[MoveIndex - 1]);
+				}
+				bit::Destroy(Slot);
+			}
+			bit::Construct(Slot, bit::Move(Element));
+			Count += 1;
+			return *Slot;
+		}
+
 		bool Contains(const T& Element)
 		{
 			for (const T& Value : *this)
@@ -258,14 +371,21 @@ namespace bit
 
 		void PopLast()
 		{
-			if (Count > 0) Count -= 1;
+			if (Count > 0)
+			{
+				Count -= 1;
+				bit::Destroy(GetData(Count));
+			}
 		}
 
 		SelfType_t& operator=(const SelfType_t& Copy)
 		{
-			bit::DestroyArray(GetData(), Count);
-			Storage = Copy.Storage;
-			Count = Copy.Count;
+			static_assert(bit::IsCopyConstructible<T>::Value, "Arrays of move only elements can't be copied");
+			if (this != &Copy)
+			{
+				Clear();
+				CopyElements(Copy);
+			}
 			return *this;
 		}
 
@@ -273,7 +393,7 @@ namespace bit
 		{
 			Destroy();
 			Storage = bit::Move(Move.Storage);
-			Data = Move.Data;
+			Data = (T*)Storage.GetBlock();
 			Count = Move.Count;
 			Capacity = Move.Capacity;
 			Move.Data = nullptr;
@@ -303,10 +423,18 @@ namespace bit
 		{
 			if (Count > 0 && InIndex < Count)
 			{
-				SizeType_t Diff = Count - InIndex;
-				if (Diff > 1)
+				BIT_IF_CONSTEXPR (bit::IsTriviallyRelocatable<T>::Value)
+				{
+					bit::Destroy(&Data[InIndex]);
+					bit::Memmove(&Data[InIndex], &Data[InIndex + 1], (size_t)(Count - InIndex - 1) * sizeof(T));
+				}
+				else
 				{
-					bit::Memcpy(&Data[InIndex], &Data[InIndex + 1], Diff * sizeof(T));
+					for (SizeType_t Index = InIndex; Index < Count - 1; ++Index)
+					{
+						Data[Index] = bit::Move(Data[Index + 1]);
+					}
+					bit::Destroy(&Data[Count - 1]);
 				}
 				Count -= 1;
 				return true;
@@ -314,6 +442,34 @@ namespace bit
 			return false;
 		}
 
+		/* Removes in O(1) by moving the last element into InIndex, the order isn't kept */
+		bool RemoveAtSwap(SizeType_t InIndex)
+		{
+			if (Count > 0 && InIndex < Count)
+			{
+				SizeType_t LastIndex = Count - 1;
+				BIT_IF_CONSTEXPR (bit::IsTriviallyRelocatable<T>::Value)
+				{
+					bit::Destroy(&Data[InIndex]);
+					if (InIndex != LastIndex)
+					{
+						bit::Memcpy(&Data[InIndex], &Data[LastIndex], sizeof(T));
+					}
+				}
+				else
+				{
+					if (InIndex != LastIndex)
+					{
+						Data[InIndex] = bit::Move(Data[LastIndex]);
+					}
+					bit::Destroy(&Data[LastIndex]);
+				}
+				Count = LastIndex;
+				return true;
+			}
+			return false;
+		}
+
 		template<typename TSearchFunc>
 		bool Remove(TSearchFunc Func)
 		{
@@ -343,6 +499,23 @@ namespace bit
 		}
 
 	protected:
+		/* Fills this empty array with copies of the elements of Copy */
+		void CopyElements(const SelfType_t& Copy)
+		{
+			BIT_IF_CONSTEXPR (bit::IsTriviallyCopyable<T>::Value)
+			{
+				Storage = Copy.Storage;
+				Data = (T*)Storage.GetBlock();
+				Count = Copy.Count;
+				Capacity = Storage.GetBlockSize() / sizeof(T);
+			}
+			else
+			{
+				Reserve(Copy.Count);
+				Append(Copy.GetData(), Copy.Count);
+			}
+		}
+
 		TStorage Storage;
 		SizeType_t Count;
 		SizeType_t Capacity;
@@ -0,0 +1,482 @@
+#pragma once
+
+#include <bit/container/hash_table.h>
+#include <bit/core/os/atomics.h>
+#include <bit/core/os/mutex.h>
+#include <bit/utility/epoch_reclaimer.h>
+#include <bit/utility/scope_lock.h>
+
+namespace bit
+{
+	/* Chain node of ConcurrentHashTable. The hash is kept to skip key compares and to
+	   move the node on resize without hashing the key again. */
+	template<typename TPair, typename THash, bool bStoreHash>
+	struct ConcurrentHashNode
+	{
+		ConcurrentHashNode(ConcurrentHashNode* InNext, THash InHash, const TPair& InPair) : Next(InNext), Hash(InHash), Pair(InPair) {}
+		bool MatchesHash(THash OtherHash) const { return Hash == OtherHash; }
+		template<typename THasher>
+		THash GetHash(const THasher&) const { return Hash; }
+
+		ConcurrentHashNode* Next;
+		THash Hash;
+		TPair Pair;
+	};
+
+	/* Keys that compare as cheaply as a hash don't store it. An int32_t keyed node then
+	   fits 16 bytes, which keeps more of the chains in cache. */
+	template<typename TPair, typename THash>
+	struct ConcurrentHashNode<TPair, THash, false>
+	{
+		ConcurrentHashNode(ConcurrentHashNode* InNext, THash, const TPair& InPair) : Next(InNext), Pair(InPair) {}
+		bool MatchesHash(THash) const { return true; }
+		template<typename THasher>
+		THash GetHash(const THasher& Hasher) const { return Hasher(Pair.Key); }
+
+		ConcurrentHashNode* Next;
+		TPair Pair;
+	};
+
+	/* Hash table that many threads can read and write at once. Lookups take no lock.
+	   They run inside an epoch so nodes and bucket arrays unlinked by writers stay
+	   valid until every reader that could see them has left. Writers lock one of
+	   LOCK_STRIPE_COUNT stripes picked from the key hash. An insert over an existing
+	   key stores trivially copyable values of 4 or 8 bytes in place with an atomic
+	   store, any other value is replaced by linking a new node.
+	   The table doubles when it's 3/4 full. Growing is incremental, every writer
+	   moves TRANSFER_CHUNK buckets to the new array and leaves a forward marker
+	   behind, so readers and writers on other buckets are never stopped.
+	   Storage is used from any thread and must be thread safe. */
+	template<
+		typename TKey,
+		typename TValue,
+		typename TStorage = HashTableStorage
+	>
+	struct ConcurrentHashTable : public NonCopyable
+	{
+		typedef Hash<TKey> HashFunc_t;
+		typedef typename HashFunc_t::HashType_t HashType_t;
+		typedef KeyValue<TKey, TValue> PairType_t;
+
+		static constexpr SizeType_t LOCK_STRIPE_COUNT = 64;
+		static constexpr SizeType_t MIN_BUCKET_COUNT = LOCK_STRIPE_COUNT; // Stripes must divide the bucket count
+		static constexpr SizeType_t TRANSFER_CHUNK = 16;
+		static constexpr bool STORE_HASH = !(IsTriviallyCopyable<TKey>::Value && sizeof(TKey) <= sizeof(HashType_t));
+		static constexpr bool IN_PLACE_VALUES = IsTriviallyCopyable<TValue>::Value &&
+			(sizeof(TValue) == sizeof(int32_t) || sizeof(TValue) == sizeof(int64_t)) && alignof(TValue) == sizeof(TValue);
+
+		ConcurrentHashTable() :
+			Storage(),
+			Reclaimer(Storage.GetAllocator()),
+			Current(nullptr),
+			ElementCount(0)
+		{
+			Current = AllocateBucketArray(MIN_BUCKET_COUNT);
+		}
+
+		ConcurrentHashTable(IAllocator& InAllocator) :
+			Storage(InAllocator),
+			Reclaimer(Storage.GetAllocator()),
+			Current(nullptr),
+			ElementCount(0)
+		{
+			Current = AllocateBucketArray(MIN_BUCKET_COUNT);
+		}
+
+		/* No other thread can be using the table */
+		~ConcurrentHashTable()
+		{
+			BucketArray* Table = Current;
+			if (Table->Next != nullptr)
+			{
+				FreeBucketArray(Table->Next, true);
+			}
+			FreeBucketArray(Table, true);
+		}
+
+		/* Copies the value out so it stays valid after the reader leaves */
+		bool Find(const TKey& Key, TValue& OutValue) const
+		{
+			EpochGuard Guard(Reclaimer);
+			const Node* Found = FindNode(GetHash(Key), Key);
+			if (Found == nullptr) return false;
+			LoadValue(&Found->Pair.Value, OutValue);
+			return true;
+		}
+
+		bool Contains(const TKey& Key) const
+		{
+			EpochGuard Guard(Reclaimer);
+			return FindNode(GetHash(Key), Key) != nullptr;
+		}
+
+		/* Calls Func(const TValue&) if the key is present. The value must not escape Func. */
+		template<typename TFunc>
+		bool Visit(const TKey& Key, TFunc Func) const
+		{
+			EpochGuard Guard(Reclaimer);
+			const Node* Found = FindNode(GetHash(Key), Key);
+			if (Found == nullptr) return false;
+			BIT_IF_CONSTEXPR (IN_PLACE_VALUES)
+			{
+				const TValue Value = LoadInPlaceValue(&Found->Pair.Value);
+				Func(Value);
+			}
+			else
+			{
+				Func(Found->Pair.Value);
+			}
+			return true;
+		}
+
+		/* Calls Func(const TKey&, const TValue&) for every element. Writes running at the
+		   same time may or may not be seen but no element is visited twice. */
+		template<typename TFunc>
+		void ForEach(TFunc Func) const
+		{
+			EpochGuard Guard(Reclaimer);
+			const BucketArray* Table = LoadPtr(&Current);
+			for (SizeType_t Index = 0; Index < Table->BucketCount; ++Index)
+			{
+				VisitBucket(Table, Index, Func);
+			}
+		}
+
+		/* Returns true if the key wasn't in the table. Otherwise the value is replaced. */
+		bool Insert(const TKey& Key, const TValue& Value)
+		{
+			HashType_t Hash = GetHash(Key);
+			bool bInserted = false;
+			bool bGrow = false;
+			{
+				EpochGuard Guard(Reclaimer);
+				HelpResize();
+				ScopedLock<Mutex> Lock(&Stripes[Hash & (LOCK_STRIPE_COUNT - 1)].Lock);
+				Node** Bucket = LockBucket(Hash);
+				Node** Link = Bucket;
+				Node* Entry = LoadPtr(Link);
+				while (Entry != nullptr && !(Entry->MatchesHash(Hash) && Entry->Pair.Key == Key))
+				{
+					Link = &Entry->Next;
+					Entry = LoadPtr(Link);
+				}
+				if (Entry != nullptr)
+				{
+					BIT_IF_CONSTEXPR (IN_PLACE_VALUES)
+					{
+						StoreValue(&Entry->Pair.Value, Value);
+					}
+					else
+					{
+						StorePtr(Link, AllocateNode(Hash, Key, Value, LoadPtr(&Entry->Next)));
+						Reclaimer.Retire(Entry, &ConcurrentHashTable::FreeNode, this);
+					}
+				}
+				else
+				{
+					StorePtr(Bucket, AllocateNode(Hash, Key, Value, LoadPtr(Bucket)));
+					bInserted = true;
+					bGrow = AtomicIncrement(&ElementCount) > GetGrowThreshold();
+				}
+			}
+			if (bGrow)
+			{
+				StartResize();
+			}
+			return bInserted;
+		}
+
+		bool Erase(const TKey& Key)
+		{
+			HashType_t Hash = GetHash(Key);
+			EpochGuard Guard(Reclaimer);
+			HelpResize();
+			ScopedLock<Mutex> Lock(&Stripes[Hash & (LOCK_STRIPE_COUNT - 1)].Lock);
+			Node** Link = LockBucket(Hash);
+			for (Node* Entry = LoadPtr(Link); Entry != nullptr; Entry = LoadPtr(Link))
+			{
+				if (Entry->MatchesHash(Hash) && Entry->Pair.Key == Key)
+				{
+					// Readers standing on Entry still reach the rest of the chain through Entry->Next
+					StorePtr(Link, LoadPtr(&Entry->Next));
+					Reclaimer.Retire(Entry, &ConcurrentHashTable::FreeNode, this);
+					AtomicDecrement(&ElementCount);
+					return true;
+				}
+				Link = &Entry->Next;
+			}
+			return false;
+		}
+
+		/* Frees unlinked nodes no reader can reach anymore. Writers also do this every
+		   EpochReclaimer::COLLECT_INTERVAL removals. */
+		size_t Collect() { return Reclaimer.Collect(); }
+
+		HashType_t GetHash(const TKey& Key) const { return Hasher(Key); }
+		SizeType_t GetCount() const { return AtomicLoad(&ElementCount); }
+		SizeType_t GetBucketCount() const
+		{
+			EpochGuard Guard(Reclaimer);
+			return LoadPtr(&Current)->BucketCount;
+		}
+
+		bool IsEmpty() const { return GetCount() == 0; }
+
+	private:
+		typedef ConcurrentHashNode<PairType_t, HashType_t, STORE_HASH> Node;
+
+		struct BucketArray
+		{
+			SizeType_t BucketCount;
+			BucketArray* Next; // Array being resized into
+			SizeType_t TransferIndex; // Next bucket a writer can claim to move
+			SizeType_t TransferCount; // Buckets already moved
+			Node** Buckets;
+		};
+
+		struct BIT_ALIGN(64) LockStripe
+		{
+			Mutex Lock;
+		};
+
+		static_assert(alignof(Node) <= bit::DEFAULT_ALIGNMENT, "ConcurrentHashTable nodes can't be over aligned");
+
+		/* Left in a bucket of an array being resized once its nodes were moved */
+		static Node* GetForwardMarker() { return (Node*)(uintptr_t)1; }
+
+		/* Every chain link is followed with one of these, so they are inlined rather than
+		   calls to AtomicLoad */
+		template<typename T>
+		static BIT_FORCEINLINE T* LoadPtr(T* const* Target) { return AtomicLoadInline(Target); }
+
+		template<typename T>
+		static BIT_FORCEINLINE void StorePtr(T** Target, T* Value) { AtomicStoreInline(Target, Value); }
+
+		/* Values stored in place are read with one atomic load so a reader never sees half a write */
+		static BIT_FORCEINLINE TValue LoadInPlaceValue(const TValue* Source)
+		{
+			BIT_IF_CONSTEXPR (sizeof(TValue) == sizeof(int64_t))
+			{
+				int64_t Bits = AtomicLoadInline((const int64_t*)Source);
+				return *(const TValue*)&Bits;
+			}
+			else
+			{
+				int32_t Bits = AtomicLoadInline((const int32_t*)Source);
+				return *(const TValue*)&Bits;
+			}
+		}
+
+		static BIT_FORCEINLINE void LoadValue(const TValue* Source, TValue& OutValue)
+		{
+			BIT_IF_CONSTEXPR (IN_PLACE_VALUES)
+			{
+				OutValue = LoadInPlaceValue(Source);
+			}
+			else
+			{
+				OutValue = *Source;
+			}
+		}
+
+		static void StoreValue(TValue* Target, const TValue& Value)
+		{
+			BIT_IF_CONSTEXPR (sizeof(TValue) == sizeof(int64_t))
+			{
+				AtomicStoreInline((int64_t*)Target, *(const int64_t*)&Value);
+			}
+			else
+			{
+				AtomicStoreInline((int32_t*)Target, *(const int32_t*)&Value);
+			}
+		}
+
+		static void FreeNode(void* Context, void* Pointer)
+		{
+			((ConcurrentHashTable*)Context)->DestroyNode((Node*)Pointer);
+		}
+
+		static void FreeNodeChain(void* Context, void* Pointer)
+		{
+			ConcurrentHashTable* Table = (ConcurrentHashTable*)Context;
+			for (Node* Entry = (Node*)Pointer; Entry != nullptr;)
+			{
+				Node* Next = Entry->Next;
+				Table->DestroyNode(Entry);
+				Entry = Next;
+			}
+		}
+
+		static void FreeRetiredBucketArray(void* Context, void* Pointer)
+		{
+			((ConcurrentHashTable*)Context)->FreeBucketArray((BucketArray*)Pointer, false);
+		}
+
+		Node* AllocateNode(HashType_t Hash, const TKey& Key, const TValue& Value, Node* Next)
+		{
+			return BitPlacementNew(Storage.AllocateBuckets(sizeof(Node), 1)) Node(Next, Hash, PairType_t{ Key, Value });
+		}
+
+		void DestroyNode(Node* Entry)
+		{
+			Entry->~Node();
+			Storage.FreeBuckets(Entry);
+		}
+
+		BucketArray* AllocateBucketArray(SizeType_t BucketCount)
+		{
+			BucketArray* Table = (BucketArray*)Storage.AllocateBuckets(sizeof(BucketArray) + sizeof(Node*) * BucketCount, 1);
+			Table->BucketCount = BucketCount;
+			Table->Next = nullptr;
+			Table->TransferIndex = 0;
+			Table->TransferCount = 0;
+			Table->Buckets = (Node**)(Table + 1);
+			for (SizeType_t Index = 0; Index < BucketCount; ++Index)
+			{
+				Table->Buckets[Index] = nullptr;
+			}
+			return Table;
+		}
+
+		/* Retired arrays only had forward markers left. Nodes are freed when destroying the table. */
+		void FreeBucketArray(BucketArray* Table, bool bFreeNodes)
+		{
+			if (bFreeNodes)
+			{
+				for (SizeType_t Index = 0; Index < Table->BucketCount; ++Index)
+				{
+					if (Table->Buckets[Index] != GetForwardMarker())
+					{
+						FreeNodeChain(this, Table->Buckets[Index]);
+					}
+				}
+			}
+			Storage.FreeBuckets(Table);
+		}
+
+		/* Must be called inside an epoch */
+		SizeType_t GetGrowThreshold() const
+		{
+			return LoadPtr(&Current)->BucketCount / 4 * 3;
+		}
+
+		const Node* FindNode(HashType_t Hash, const TKey& Key) const
+		{
+			const BucketArray* Table = LoadPtr(&Current);
+			Node* Entry = LoadPtr(&Table->Buckets[Hash & (Table->BucketCount - 1)]);
+			while (Entry == GetForwardMarker())
+			{
+				Table = LoadPtr(&Table->Next);
+				Entry = LoadPtr(&Table->Buckets[Hash & (Table->BucketCount - 1)]);
+			}
+			for (; Entry != nullptr; Entry = LoadPtr(&Entry->Next))
+			{
+				if (Entry->MatchesHash(Hash) && Entry->Pair.Key == Key)
+				{
+					return Entry;
+				}
+			}
+			return nullptr;
+		}
+
+		/* Forwarded buckets split in two in the next array */
+		template<typename TFunc>
+		void VisitBucket(const BucketArray* Table, SizeType_t Index, TFunc& Func) const
+		{
+			Node* Entry = LoadPtr(&Table->Buckets[Index]);
+			if (Entry == GetForwardMarker())
+			{
+				const BucketArray* Next = LoadPtr(&Table->Next);
+				VisitBucket(Next, Index, Func);
+				VisitBucket(Next, Index + Table->BucketCount, Func);
+				return;
+			}
+			for (; Entry != nullptr; Entry = LoadPtr(&Entry->Next))
+			{
+				BIT_IF_CONSTEXPR (IN_PLACE_VALUES)
+				{
+					const TValue Value = LoadInPlaceValue(&Entry->Pair.Value);
+					Func(Entry->Pair.Key, Value);
+				}
+				else
+				{
+					Func(Entry->Pair.Key, Entry->Pair.Value);
+				}
+			}
+		}
+
+		/* Returns the bucket the hash maps to in the newest array that owns it. The stripe
+		   lock for the hash must be held, which keeps the bucket from being moved. */
+		Node** LockBucket(HashType_t Hash)
+		{
+			BucketArray* Table = LoadPtr(&Current);
+			Node** Bucket = &Table->Buckets[Hash & (Table->BucketCount - 1)];
+			while (LoadPtr(Bucket) == GetForwardMarker())
+			{
+				Table = LoadPtr(&Table->Next);
+				Bucket = &Table->Buckets[Hash & (Table->BucketCount - 1)];
+			}
+			return Bucket;
+		}
+
+		void StartResize()
+		{
+			EpochGuard Guard(Reclaimer);
+			BucketArray* Table = LoadPtr(&Current);
+			if (LoadPtr(&Table->Next) != nullptr || AtomicLoad(&ElementCount) <= Table->BucketCount / 4 * 3) return;
+			BucketArray* NewTable = AllocateBucketArray(Table->BucketCount * 2);
+			if (AtomicCompareExchange((void**)&Table->Next, (void*)NewTable, nullptr) != nullptr)
+			{
+				FreeBucketArray(NewTable, false);
+			}
+		}
+
+		/* Moves one chunk of buckets if a resize is running. Must be called inside an epoch. */
+		void HelpResize()
+		{
+			BucketArray* Table = LoadPtr(&Current);
+			BucketArray* NewTable = LoadPtr(&Table->Next);
+			if (NewTable == nullptr) return;
+			SizeType_t Begin = AtomicAdd(&Table->TransferIndex, TRANSFER_CHUNK);
+			if (Begin >= Table->BucketCount) return;
+			SizeType_t End = bit::Min(Begin + TRANSFER_CHUNK, Table->BucketCount);
+			for (SizeType_t Index = Begin; Index < End; ++Index)
+			{
+				TransferBucket(Table, NewTable, Index);
+			}
+			if (AtomicAdd(&Table->TransferCount, End - Begin) + (End - Begin) == Table->BucketCount)
+			{
+				StorePtr(&Current, NewTable);
+				Reclaimer.Retire(Table, &ConcurrentHashTable::FreeRetiredBucketArray, this);
+			}
+		}
+
+		/* Nodes are copied rather than relinked so readers still walking the old chain
+		   never jump into a chain of the new array and miss nodes. Both destination
+		   buckets use the same stripe as the source since stripes divide bucket counts. */
+		void TransferBucket(BucketArray* Table, BucketArray* NewTable, SizeType_t Index)
+		{
+			ScopedLock<Mutex> Lock(&Stripes[Index & (LOCK_STRIPE_COUNT - 1)].Lock);
+			Node* Chain = LoadPtr(&Table->Buckets[Index]);
+			for (Node* Entry = Chain; Entry != nullptr; Entry = Entry->Next)
+			{
+				HashType_t Hash = Entry->GetHash(Hasher);
+				Node** Bucket = &NewTable->Buckets[Hash & (NewTable->BucketCount - 1)];
+				StorePtr(Bucket, AllocateNode(Hash, Entry->Pair.Key, Entry->Pair.Value, LoadPtr(Bucket)));
+			}
+			StorePtr(&Table->Buckets[Index], GetForwardMarker());
+			if (Chain != nullptr)
+			{
+				Reclaimer.Retire(Chain, &ConcurrentHashTable::FreeNodeChain, this);
+			}
+		}
+
+		// Storage is declared first so it outlives the reclaimer, which frees through it
+		TStorage Storage;
+		mutable EpochReclaimer Reclaimer;
+		BucketArray* Current;
+		SizeType_t ElementCount;
+		LockStripe Stripes[LOCK_STRIPE_COUNT];
+		HashFunc_t Hasher;
+	};
+}
@@ -4,53 +4,142 @@
 #include <bit/core/types.h>
 #include <bit/utility/hash.h>
 #include <bit/core/memory.h>
-#include <bit/container/linked_list.h>
+#include <bit/container/storage.h>
+
+#if BIT_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+#if BIT_PLATFORM_WINDOWS
+#include <intrin.h>
+#endif
 
 namespace bit
 {
-	template<
-		typename T,
-		typename TBucketType,
-		typename TBucketIteratorType
-	>
-	struct HashTableIterator
+	/* Every slot of a HashTable has a control byte. Full slots store the low 7 bits
+	   of the key hash (H2), so a whole group of slots is filtered with one compare
+	   before any key is touched. */
+	typedef int8_t HashControl_t;
+	static constexpr HashControl_t HASH_CONTROL_EMPTY = -128; // 0b10000000
+	static constexpr HashControl_t HASH_CONTROL_DELETED = -2; // 0b11111110
+
+	/* Set of slots in a group that matched a query. Each slot is MASK_STRIDE bits wide. */
+	template<uint32_t MASK_STRIDE>
+	struct HashGroupMask
+	{
+		HashGroupMask(uint64_t Bits) : Bits(Bits) {}
+		explicit operator bool() const { return Bits != 0; }
+		void ClearLowest() { Bits &= Bits - 1; }
+
+		uint32_t GetLowest() const
+		{
+		#if BIT_PLATFORM_WINDOWS
+			unsigned long BitIndex = 0;
+			_BitScanForward64(&BitIndex, Bits);
+			return (uint32_t)BitIndex / MASK_STRIDE;
+		#else
+			return (uint32_t)__builtin_ctzll(Bits) / MASK_STRIDE;
+		#endif
+		}
+
+		/* Number of slots that didn't match before the first match */
+		uint32_t CountTrailing(uint32_t GroupWidth) const { return Bits != 0 ? GetLowest() : GroupWidth; }
+
+		/* Number of slots that didn't match after the last match */
+		uint32_t CountLeading(uint32_t GroupWidth) const
+		{
+			if (Bits == 0) return GroupWidth;
+		#if BIT_PLATFORM_WINDOWS
+			unsigned long BitIndex = 0;
+			_BitScanReverse64(&BitIndex, Bits);
+			return GroupWidth - 1 - (uint32_t)BitIndex / MASK_STRIDE;
+		#else
+			return GroupWidth - 1 - (uint32_t)(63 - __builtin_clzll(Bits)) / MASK_STRIDE;
+		#endif
+		}
+
+		uint64_t Bits;
+	};
+
+#if BIT_SIMD_SSE2
+	/* 16 control bytes compared at once with SSE2 */
+	struct HashGroup
 	{
-		typedef HashTableIterator<T, TBucketType, TBucketIteratorType> SelfType_t;
+		static constexpr uint32_t WIDTH = 16;
+		typedef HashGroupMask<1> Mask_t;
 
-		HashTableIterator(TBucketType* Buckets, TBucketIteratorType Iter, SizeType_t BucketIndex, SizeType_t BucketCount) :
-			Buckets(Buckets),
-			Iter(Iter),
-			BucketIndex(BucketIndex),
-			BucketCount(BucketCount)
+		HashGroup(const HashControl_t* Control) :
+			Control(_mm_loadu_si128((const __m128i*)Control))
 		{}
 
+		Mask_t Match(HashControl_t H2) const { return (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(H2), Control)); }
+		Mask_t MatchEmpty() const { return (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(HASH_CONTROL_EMPTY), Control)); }
+		// Empty and deleted are the only control values below -1
+		Mask_t MatchEmptyOrDeleted() const { return (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), Control)); }
+
+	private:
+		__m128i Control;
+	};
+#else
+	/* 8 control bytes compared at once in a 64-bit register. Match can report false
+	   positives next to a real match, which the key compare filters out. */
+	struct HashGroup
+	{
+		static constexpr uint32_t WIDTH = 8;
+		static constexpr uint64_t LSBS = 0x0101010101010101ULL;
+		static constexpr uint64_t MSBS = 0x8080808080808080ULL;
+		typedef HashGroupMask<8> Mask_t;
+
+		HashGroup(const HashControl_t* InControl)
+		{
+			bit::Memcpy(&Control, InControl, sizeof(Control));
+		}
+
+		Mask_t Match(HashControl_t H2) const
+		{
+			uint64_t Bytes = Control ^ (LSBS * (uint8_t)H2);
+			return (Bytes - LSBS) & ~Bytes & MSBS;
+		}
+		Mask_t MatchEmpty() const { return (Control & (~Control << 6)) & MSBS; }
+		Mask_t MatchEmptyOrDeleted() const { return (Control & (~Control << 7)) & MSBS; }
+
+	private:
+		uint64_t Control;
+	};
+#endif
+
+	template<typename T>
+	struct HashTableIterator
+	{
+		typedef HashTableIterator<T> SelfType_t;
+
+		HashTableIterator(const HashControl_t* Control, T* Slots, SizeType_t Capacity, const HashControl_t* OldControl, T* OldSlots, SizeType_t OldCapacity, SizeType_t Index) :
+			Control(Control),
+			Slots(Slots),
+			Capacity(Capacity),
+			OldControl(OldControl),
+			OldSlots(OldSlots),
+			OldCapacity(OldCapacity),
+			Index(Index)
+		{
+			SkipFree();
+		}
+
 		T& operator*()
 		{
-			return Iter->Data;
+			return *GetSlot();
 		}
 
 		T* operator->()
 		{
-			if (Iter != Buckets[BucketIndex].Container.end())
-				return &Iter->Data;
+			if (Index < Capacity + OldCapacity)
+				return GetSlot();
 			return nullptr;
 		}
 
 		SelfType_t& operator++()
 		{
-			if (++Iter == Buckets[BucketIndex].Container.end())
-			{
-				for (SizeType_t Index = BucketIndex + 1; Index < BucketCount; ++Index)
-				{
-					if (!Buckets[Index].Container.IsEmpty())
-					{
-						Iter = Buckets[Index].Container.begin();
-						BucketIndex = Index;
-						return *this;
-					}
-				}
-				Iter.Invalidate();
-			}
+			Index += 1;
+			SkipFree();
 			return *this;
 		}
 
@@ -58,64 +147,66 @@ namespace bit
 
 		friend bool operator==(const SelfType_t& A, const SelfType_t& B)
 		{
-			return A.Iter == B.Iter;
+			return A.Index == B.Index;
 		}
 
 		friend bool operator!=(const SelfType_t& A, const SelfType_t& B)
 		{
-			return A.Iter != B.Iter;
+			return A.Index != B.Index;
 		}
 
 	private:
-		TBucketType* Buckets;
-		TBucketIteratorType Iter;
-		SizeType_t BucketIndex;
-		SizeType_t BucketCount;
+		/* Indices past Capacity point into the old slot array of an incremental rehash */
+		T* GetSlot() const { return Index < Capacity ? &Slots[Index] : &OldSlots[Index - Capacity]; }
+		HashControl_t GetControl() const { return Index < Capacity ? Control[Index] : OldControl[Index - Capacity]; }
+
+		void SkipFree()
+		{
+			while (Index < Capacity + OldCapacity && GetControl() < 0) Index += 1;
+		}
+
+		const HashControl_t* Control;
+		T* Slots;
+		SizeType_t Capacity;
+		const HashControl_t* OldControl;
+		T* OldSlots;
+		SizeType_t OldCapacity;
+		SizeType_t Index;
 	};
 
-	template<
-		typename T,
-		typename TBucketType,
-		typename TBucketIteratorType
-	>
+	template<typename T>
 	struct ConstHashTableIterator
 	{
-		typedef ConstHashTableIterator<T, TBucketType, TBucketIteratorType> SelfType_t;
-
-		ConstHashTableIterator(TBucketType* Buckets, TBucketIteratorType Iter, SizeType_t BucketIndex, SizeType_t BucketCount) :
-			Buckets(Buckets),
-			Iter(Iter),
-			BucketIndex(BucketIndex),
-			BucketCount(BucketCount)
-		{}
+		typedef ConstHashTableIterator<T> SelfType_t;
+
+		ConstHashTableIterator(const HashControl_t* Control, const T* Slots, SizeType_t Capacity, const HashControl_t* OldControl, const T* OldSlots, SizeType_t OldCapacity, SizeType_t Index) :
+			Control(Control),
+			Slots(Slots),
+			Capacity(Capacity),
+			OldControl(OldControl),
+			OldSlots(OldSlots),
+			OldCapacity(OldCapacity),
+			Index(Index)
+		{
+			SkipFree();
+		}
 
 		const T& operator*()
 		{
-			return Iter->Data;
+			return *GetSlot();
 		}
 
 		const T* operator->()
 		{
-			if (Iter != Buckets[BucketIndex].Container.cend())
-				return &Iter->Data;
+			if (Index < Capacity + OldCapacity)
+				return GetSlot();
 			return nullptr;
 		}
 
 		SelfType_t& operator++()
 		{
-			if (++Iter == Buckets[BucketIndex].Container.cend())
-			{
-				for (SizeType_t Index = BucketIndex + 1; Index < BucketCount; ++Index)
-				{
-					if (!Buckets[Index].Container.IsEmpty())
-					{
-						Iter = Buckets[Index].Container.cbegin();
-						BucketIndex = Index;
-						return *this;
-					}
-				}
-				Iter.Invalidate();
-			}
+			Index += 1;
+			SkipFree();
 			return *this;
 		}
 
@@ -123,19 +214,31 @@ namespace bit
 
 		friend bool operator==(const SelfType_t& A, const SelfType_t& B)
 		{
-			return A.Iter == B.Iter;
+			return A.Index == B.Index;
 		}
 
 		friend bool operator!=(const SelfType_t& A, const SelfType_t& B)
 		{
-			return A.Iter != B.Iter;
+			return A.Index != B.Index;
 		}
 
 	private:
-		const TBucketType* Buckets;
-		TBucketIteratorType Iter;
-		SizeType_t BucketIndex;
-		SizeType_t BucketCount;
+		/* Indices past Capacity point into the old slot array of an incremental rehash */
+		const T* GetSlot() const { return Index < Capacity ? &Slots[Index] : &OldSlots[Index - Capacity]; }
+		HashControl_t GetControl() const { return Index < Capacity ? Control[Index] : OldControl[Index - Capacity]; }
+
+		void SkipFree()
+		{
+			while (Index < Capacity + OldCapacity && GetControl() < 0) Index += 1;
+		}
+
+		const HashControl_t* Control;
+		const T* Slots;
+		SizeType_t Capacity;
+		const HashControl_t* OldControl;
+		const T* OldSlots;
+		SizeType_t OldCapacity;
+		SizeType_t Index;
 	};
 
 	template<typename TKey, typename TValue>
@@ -147,91 +250,33 @@ namespace bit
 		ValueType_t Value;
 	};
 
-	template<typename T, typename THashType>
-	struct BucketEntry
-	{
-		typedef BucketEntry<T, THashType> SelfType_t;
-		typedef T DataType_t;
-		typedef THashType HashType_t;
-		DataType_t Data;
-		HashType_t Hash;
-
-		friend bool operator==(const SelfType_t& LHS, const SelfType_t& RHS)
-		{
-			return bit::Memcmp(&LHS, &RHS, sizeof(SelfType_t));
-		}
-	};
-
-	template<typename TBucketEntryContainer>
-	struct Bucket
+	/* Returned by HashTable::FindOrInsert. The pair lives in the table and its value
+	   was default constructed when bInserted is set. */
+	template<typename TPair>
+	struct HashTableInsertResult
 	{
-		typedef typename TBucketEntryContainer::ElementType_t EntryType_t;
-		typedef typename EntryType_t::DataType_t DataType_t;
-		typedef typename EntryType_t::HashType_t HashType_t;
-		typedef typename DataType_t::KeyType_t KeyType_t;
-		typedef typename DataType_t::ValueType_t ValueType_t;
-
-		Bucket() = default;
-
-		Bucket(IAllocator& Allocator) :
-			Container(Allocator)
-		{}
-
-		bool Erase(HashType_t Hash, const KeyType_t& Key)
-		{
-			EntryType_t* Entry = Find(Hash, Key);
-			if (Entry != nullptr)
-			{
-				return Container.Erase(*Entry);
-			}
-			return false;
-		}
-
-		EntryType_t* Insert(HashType_t Hash, const KeyType_t& Key, const ValueType_t& Value)
-		{
-			return SetOrInsert(Hash, Key, Value);
-		}
-
-		EntryType_t* SetOrInsert(HashType_t Hash, const KeyType_t& Key, const ValueType_t& Value)
-		{
-			for (EntryType_t& Entry : Container)
-			{
-				if (Entry.Hash == Hash && Entry.Data.Key == Key)
-				{
-					return Set(&Entry, Hash, Key, Value);
-				}
-			}
-			return CreateAndInsert(Hash, Key, Value);
-		}
-
-		EntryType_t* CreateAndInsert(HashType_t Hash, const KeyType_t& Key, const ValueType_t& Value)
-		{
-			return Set(Container.New(), Hash, Key, Value);
-		}
-
-		EntryType_t* Set(EntryType_t* Entry, HashType_t Hash, const KeyType_t& Key, const ValueType_t& Value)
-		{
-			Entry->Hash = Hash;
-			Entry->Data.Key = Key;
-			Entry->Data.Value = Value;
-			return Entry;
-		}
-
-		EntryType_t* Find(HashType_t Hash, const KeyType_t& Key)
-		{
-			for (EntryType_t& Entry : Container)
-			{
-				if (Entry.Hash == Hash && Entry.Data.Key == Key)
-				{
-					return &Entry;
-				}
-			}
-			return nullptr;
-		}
-
-		TBucketEntryContainer Container;
+		TPair* Pair;
+		bool bInserted;
 	};
 
+	/* Open addressing hash table. Key-value pairs live in one flat slot array next to
+	   an array of control bytes. Lookups probe whole groups of control bytes at once
+	   and only compare keys whose 7 bit hash tag matches. The capacity is always a
+	   power of two so slots are found with a mask instead of a division. The table
+	   grows when it's 7/8 full unless another max load factor is set.
+	   With incremental rehashing on, the arrays for the next growth are allocated
+	   when the table is almost full and their control bytes are cleared a chunk per
+	   insert or erase. Growing then only swaps arrays, and every following insert or
+	   erase moves just enough old slots to be done before the new arrays fill up,
+	   so no single insert pays for the whole table. Lookups check both arrays meanwhile.
+	   Pointers to values are invalidated by any insert that grows the table, and
+	   by any insert or erase while an incremental rehash is running.
+	   Lookups accept any key type that Hash<TKey> can hash and that compares with
+	   TKey, like StringView or const char* for String keys, so no temporary key is
+	   built. The key is first converted to HashLookupKey<TKey, TLookupKey>::Type, so a
+	   const char* is measured once and not again for every slot it's compared with.
+	   Every lookup also has an overload taking a hash from GetHash so callers that
+	   probe several times hash only once. */
 	template<
 		typename TKey,
 		typename TValue,
@@ -243,204 +288,629 @@ namespace bit
 		typedef typename HashFunc_t::HashType_t HashType_t;
 		typedef HashTable<TKey, TValue, TStorage> SelfType_t;
 		typedef KeyValue<TKey, TValue> PairType_t;
-		typedef BucketEntry<PairType_t, HashType_t> BucketEntryType_t;
-		typedef LinkedList<BucketEntryType_t> BucketEntryContainerType_t;
-		typedef Bucket<BucketEntryContainerType_t> BucketType_t;
-		typedef typename HashTableIterator<KeyValue<TKey, TValue>, BucketType_t, typename BucketEntryContainerType_t::IteratorType_t> IteratorType_t;
-		typedef typename ConstHashTableIterator<KeyValue<TKey, TValue>, BucketType_t, typename BucketEntryContainerType_t::ConstIteratorType_t> ConstIteratorType_t;
-
-	private:
-		struct HashTableKey
-		{
-			HashType_t Hash;
-			SizeType_t BucketIndex;
-		};
+		typedef HashTableIterator<PairType_t> IteratorType_t;
+		typedef ConstHashTableIterator<PairType_t> ConstIteratorType_t;
+		typedef HashTableInsertResult<PairType_t> InsertResult_t;
+
+		static constexpr SizeType_t GROUP_WIDTH = HashGroup::WIDTH;
+		static constexpr SizeType_t MIN_CAPACITY = GROUP_WIDTH;
+		static constexpr SizeType_t INVALID_INDEX = -1;
+		static constexpr uint32_t LOAD_FACTOR_SHIFT = 10;
+		static constexpr uint32_t LOAD_FACTOR_ONE = 1 << LOAD_FACTOR_SHIFT;
+		static constexpr uint32_t DEFAULT_MAX_LOAD_FACTOR = LOAD_FACTOR_ONE * 7 / 8;
+		static constexpr SizeType_t CONTROL_CLEAR_STEP = 64; // Fewest control bytes of the next arrays cleared per insert or erase
+		static_assert(alignof(PairType_t) <= bit::DEFAULT_ALIGNMENT, "HashTable slots can't be over aligned");
 
-	public:
 		/* Begin range for loop implementation */
-		IteratorType_t begin() { return IteratorType_t(Buckets, Buckets[ClosestBucket].Container.begin(), ClosestBucket, BucketCount); }
-		IteratorType_t end() { return IteratorType_t(Buckets, Buckets[FurthestBucket].Container.end(), FurthestBucket, BucketCount); }
-		ConstIteratorType_t cbegin() const { return ConstIteratorType_t(Buckets, Buckets[ClosestBucket].Container.cbegin(), ClosestBucket, BucketCount); }
-		ConstIteratorType_t cend() const { return ConstIteratorType_t(Buckets, Buckets[FurthestBucket].Container.cend(), FurthestBucket, BucketCount); }
+		IteratorType_t begin() { return IteratorType_t(Control, Slots, Capacity, OldControl, OldSlots, OldCapacity, 0); }
+		IteratorType_t end() { return IteratorType_t(Control, Slots, Capacity, OldControl, OldSlots, OldCapacity, Capacity + OldCapacity); }
+		ConstIteratorType_t cbegin() const { return ConstIteratorType_t(Control, Slots, Capacity, OldControl, OldSlots, OldCapacity, 0); }
+		ConstIteratorType_t cend() const { return ConstIteratorType_t(Control, Slots, Capacity, OldControl, OldSlots, OldCapacity, Capacity + OldCapacity); }
 		/* End range for loop implementation */
 
 		HashTable() :
 			Storage(),
-			Buckets(nullptr),
-			BucketCount(0),
+			Control(nullptr),
+			Slots(nullptr),
+			Capacity(0),
 			ElementCount(0),
-			FurthestBucket(0),
-			ClosestBucket(0)
+			GrowthLeft(0),
+			OldControl(nullptr),
+			OldSlots(nullptr),
+			OldCapacity(0),
+			MigrateIndex(0),
+			NextSlots(nullptr),
+			NextReady(0),
+			MaxLoadFactor(DEFAULT_MAX_LOAD_FACTOR),
+			bIncrementalReHash(false)
 		{}
 
 		HashTable(SizeType_t InitialCapacity) :
 			Storage(),
-			Buckets(nullptr),
-			BucketCount(0),
+			Control(nullptr),
+			Slots(nullptr),
+			Capacity(0),
 			ElementCount(0),
-			FurthestBucket(0),
-			ClosestBucket(0)
+			GrowthLeft(0),
+			OldControl(nullptr),
+			OldSlots(nullptr),
+			OldCapacity(0),
+			MigrateIndex(0),
+			NextSlots(nullptr),
+			NextReady(0),
+			MaxLoadFactor(DEFAULT_MAX_LOAD_FACTOR),
+			bIncrementalReHash(false)
 		{
 			ReHash(InitialCapacity);
 		}
 
 		HashTable(IAllocator& InAllocator) :
 			Storage(InAllocator),
-			Buckets(nullptr),
-			BucketCount(0),
+			Control(nullptr),
+			Slots(nullptr),
+			Capacity(0),
 			ElementCount(0),
-			FurthestBucket(0),
-			ClosestBucket(0)
+			GrowthLeft(0),
+			OldControl(nullptr),
+			OldSlots(nullptr),
+			OldCapacity(0),
+			MigrateIndex(0),
+			NextSlots(nullptr),
+			NextReady(0),
+			MaxLoadFactor(DEFAULT_MAX_LOAD_FACTOR),
+			bIncrementalReHash(false)
 		{}
 
 		HashTable(IAllocator& InAllocator, SizeType_t InitialCapacity) :
 			Storage(InAllocator),
-			Buckets(nullptr),
-			BucketCount(0),
+			Control(nullptr),
+			Slots(nullptr),
+			Capacity(0),
 			ElementCount(0),
-			FurthestBucket(0),
-			ClosestBucket(0)
+			GrowthLeft(0),
+			OldControl(nullptr),
+			OldSlots(nullptr),
+			OldCapacity(0),
+			MigrateIndex(0),
+			NextSlots(nullptr),
+			NextReady(0),
+			MaxLoadFactor(DEFAULT_MAX_LOAD_FACTOR),
+			bIncrementalReHash(false)
 		{
 			ReHash(InitialCapacity);
 		}
 
+		HashTable(const SelfType_t& Other) :
+			Storage(Other.Storage),
+			Control(nullptr),
+			Slots(nullptr),
+			Capacity(0),
+			ElementCount(0),
+			GrowthLeft(0),
+			OldControl(nullptr),
+			OldSlots(nullptr),
+			OldCapacity(0),
+			MigrateIndex(0),
+			NextSlots(nullptr),
+			NextReady(0),
+			MaxLoadFactor(Other.MaxLoadFactor),
+			bIncrementalReHash(Other.bIncrementalReHash)
+		{
+			Reserve(Other.ElementCount);
+			CopyFrom(Other);
+		}
+
+		HashTable(SelfType_t&& Other) noexcept :
+			Storage(Other.Storage),
+			Control(Other.Control),
+			Slots(Other.Slots),
+			Capacity(Other.Capacity),
+			ElementCount(Other.ElementCount),
+			GrowthLeft(Other.GrowthLeft),
+			OldControl(Other.OldControl),
+			OldSlots(Other.OldSlots),
+			OldCapacity(Other.OldCapacity),
+			MigrateIndex(Other.MigrateIndex),
+			NextSlots(Other.NextSlots),
+			NextReady(Other.NextReady),
+			MaxLoadFactor(Other.MaxLoadFactor),
+			bIncrementalReHash(Other.bIncrementalReHash)
+		{
+			Other.Control = nullptr;
+			Other.Slots = nullptr;
+			Other.Capacity = 0;
+			Other.ElementCount = 0;
+			Other.GrowthLeft = 0;
+			Other.OldControl = nullptr;
+			Other.OldSlots = nullptr;
+			Other.OldCapacity = 0;
+			Other.MigrateIndex = 0;
+			Other.NextSlots = nullptr;
+			Other.NextReady = 0;
+		}
+
 		~HashTable()
 		{
-			bit::DestroyArray(Buckets, BucketCount);
-			Storage.FreeBuckets(Buckets);
-			Buckets = nullptr;
-			BucketCount = 0;
-			ElementCount = 0;
+			DestroySlots();
+		}
+
+		SelfType_t& operator=(const SelfType_t& Other)
+		{
+			if (this != &Other)
+			{
+				DestroySlots();
+				Storage = Other.Storage;
+				MaxLoadFactor = Other.MaxLoadFactor;
+				bIncrementalReHash = Other.bIncrementalReHash;
+				Reserve(Other.ElementCount);
+				CopyFrom(Other);
+			}
+			return *this;
 		}
 
+		SelfType_t& operator=(SelfType_t&& Other) noexcept
+		{
+			if (this != &Other)
+			{
+				DestroySlots();
+				Storage = Other.Storage;
+				Control = Other.Control;
+				Slots = Other.Slots;
+				Capacity = Other.Capacity;
+				ElementCount = Other.ElementCount;
+				GrowthLeft = Other.GrowthLeft;
+				OldControl = Other.OldControl;
+				OldSlots = Other.OldSlots;
+				OldCapacity = Other.OldCapacity;
+				MigrateIndex = Other.MigrateIndex;
+				NextSlots = Other.NextSlots;
+				NextReady = Other.NextReady;
+				MaxLoadFactor = Other.MaxLoadFactor;
+				bIncrementalReHash = Other.bIncrementalReHash;
+				Other.Control = nullptr;
+				Other.Slots = nullptr;
+				Other.Capacity = 0;
+				Other.ElementCount = 0;
+				Other.GrowthLeft = 0;
+				Other.OldControl = nullptr;
+				Other.OldSlots = nullptr;
+				Other.OldCapacity = 0;
+				Other.MigrateIndex = 0;
+				Other.NextSlots = nullptr;
+				Other.NextReady = 0;
+			}
+			return *this;
+		}
+
+		/* Resizes the table to at least NewSize slots, rounded up to a power of two.
+		   Never drops below what the current elements need. */
 		void ReHash(SizeType_t NewSize)
 		{
-			if (Buckets != nullptr)
+			Resize(bit::Max(GetCapacityFor(ElementCount), (SizeType_t)bit::NextPow2((size_t)bit::Max(NewSize, MIN_CAPACITY))));
+		}
+
+		/* Makes room for Count elements so inserting them never grows the table */
+		void Reserve(SizeType_t Count)
+		{
+			if (Count > GetMaxLoad(Capacity))
 			{
-				FurthestBucket = 0;
-				ClosestBucket = NewSize;
-				BucketType_t* NewBuckets = (BucketType_t*)Storage.AllocateBuckets(sizeof(BucketType_t), NewSize);
-				bit::ConstructArray<BucketType_t>(NewBuckets, NewSize, Storage.GetAllocator());
-				for (SizeType_t OldIndex = 0; OldIndex < BucketCount; ++OldIndex)
-				{
-					BucketType_t& Bucket = Buckets[OldIndex];
-					int32_t TIndex = 0;
-					for (BucketEntryType_t& Entry : Bucket.Container)
-					{
-						SizeType_t NewBucketIndex = Entry.Hash % NewSize;
-						NewBuckets[NewBucketIndex].Container.Insert(Entry);
-						FurthestBucket = bit::Max(FurthestBucket, NewBucketIndex);
-						ClosestBucket = bit::Min(ClosestBucket, NewBucketIndex);
-						TIndex++;
-					}
-				}
-				bit::DestroyArray(Buckets, BucketCount);
-				Storage.FreeBuckets(Buckets);
-				Buckets = NewBuckets;
-				BucketCount = NewSize;
+				Resize(GetCapacityFor(Count));
 			}
-			else
+		}
+
+		/* Fraction of the slots that can be full before the table grows. Clamped to [1/8, 7/8].
+		   Lower values shorten probes at the cost of memory. */
+		void SetMaxLoadFactor(float Factor)
+		{
+			float Clamped = bit::Clamp(Factor, 0.125f, 0.875f);
+			MaxLoadFactor = (uint32_t)(Clamped * (float)LOAD_FACTOR_ONE);
+			if (Capacity > 0)
 			{
-				BucketType_t* NewBuckets = (BucketType_t*)Storage.AllocateBuckets(sizeof(BucketType_t), NewSize);
-				Buckets = bit::ConstructArray<BucketType_t>(NewBuckets, NewSize, Storage.GetAllocator());
-				if (Buckets != nullptr) BucketCount = NewSize;
-				ClosestBucket = BucketCount;
+				Resize(bit::Max(Capacity, GetCapacityFor(ElementCount)));
 			}
 		}
 
+		/* Spreads the cost of growing over the inserts and erases that follow it.
+		   Turning it off finishes a rehash that's still running. */
+		void SetIncrementalReHash(bool bEnable)
+		{
+			bIncrementalReHash = bEnable;
+			if (!bEnable) FinishReHash();
+		}
+
+		/* Moves every element still in the old slot array of an incremental rehash */
+		void FinishReHash()
+		{
+			if (OldControl != nullptr) MigrateSlots(OldCapacity - MigrateIndex);
+		}
+
 		TValue& Insert(const TKey& Key, const TValue& Value)
 		{
-			CheckGrow();
-			ElementCount += 1;
-			HashTableKey TableKey = GetTableKey(Key);
-			FurthestBucket = bit::Max(FurthestBucket, TableKey.BucketIndex);
-			ClosestBucket = bit::Min(ClosestBucket, TableKey.BucketIndex);
-			return Buckets[TableKey.BucketIndex].Insert(TableKey.Hash, Key, Value)->Data.Value;
+			return InsertOrAssign(Key, Value);
 		}
 
 		TValue& Insert(const TKey& Key, TValue&& Value)
 		{
-			CheckGrow();
-			ElementCount += 1;
-			HashTableKey TableKey = GetTableKey(Key);
-			FurthestBucket = bit::Max(FurthestBucket, TableKey.BucketIndex);
-			ClosestBucket = bit::Min(ClosestBucket, TableKey.BucketIndex);
-			return Buckets[TableKey.BucketIndex].Insert(TableKey.Hash, Key, bit::Move(Value))->Data.Value;
+			return InsertOrAssign(Key, bit::Move(Value));
+		}
+
+		template<typename TLookupKey>
+		bool Erase(const TLookupKey& Key)
+		{
+			typename HashLookupKey<TKey, TLookupKey>::Type LookupKey(Key);
+			return Erase(LookupKey, GetHash(LookupKey));
 		}
 
-		bool Erase(const TKey& Key)
+		template<typename TLookupKey>
+		bool Erase(const TLookupKey& Key, HashType_t Hash)
 		{
-			HashTableKey TableKey = GetTableKey(Key);
-			BucketType_t& Bucket = Buckets[TableKey.BucketIndex];
-			if (Bucket.Erase(TableKey.Hash, Key))
+			typename HashLookupKey<TKey, TLookupKey>::Type LookupKey(Key);
+			StepReHash();
+			SizeType_t Index = FindIndex(Hash, LookupKey);
+			if (Index == INVALID_INDEX) return EraseOld(Hash, LookupKey);
+			Slots[Index].~PairType_t();
+			ElementCount -= 1;
+
+			// A probe only stops at an empty slot, so the slot can only become empty again
+			// if no group that contains it was ever completely full.
+			SizeType_t IndexBefore = (Index - GROUP_WIDTH) & (Capacity - 1);
+			uint32_t FullBefore = HashGroup(Control + IndexBefore).MatchEmpty().CountLeading(GROUP_WIDTH);
+			uint32_t FullAfter = HashGroup(Control + Index).MatchEmpty().CountTrailing(GROUP_WIDTH);
+			if (FullBefore + FullAfter < GROUP_WIDTH)
 			{
-				if (Bucket.Container.IsEmpty())
-				{
-					FurthestBucket = 0;
-					ClosestBucket = BucketCount;
-					for (SizeType_t Index = 0; Index < TableKey.BucketIndex; ++Index)
-					{
-						if (!Buckets[Index].Container.IsEmpty())
-						{
-							FurthestBucket = bit::Max(FurthestBucket, Index);
-							ClosestBucket = bit::Min(ClosestBucket, Index);
-						}
-					}
-				}
-				ElementCount -= 1;
-				return true;
+				SetControl(Index, HASH_CONTROL_EMPTY);
+				GrowthLeft += 1;
+			}
+			else
+			{
+				SetControl(Index, HASH_CONTROL_DELETED);
 			}
-			return false;
+			return true;
+		}
+
+		template<typename TLookupKey>
+		bool Contains(const TLookupKey& Key) const
+		{
+			typename HashLookupKey<TKey, TLookupKey>::Type LookupKey(Key);
+			return FindPair(GetHash(LookupKey), LookupKey) != nullptr;
 		}
 
-		bool Contains(const TKey& Key)
+		template<typename TLookupKey>
+		bool Contains(const TLookupKey& Key, HashType_t Hash) const
 		{
-			HashTableKey TableKey = GetTableKey(Key);
-			return Buckets[TableKey.BucketIndex].Find(TableKey.Hash, Key) != nullptr;
+			typename HashLookupKey<TKey, TLookupKey>::Type LookupKey(Key);
+			return FindPair(Hash, LookupKey) != nullptr;
+		}
+
+		/* Returns null when the key isn't in the table */
+		template<typename TLookupKey>
+		TValue* Find(const TLookupKey& Key) const
+		{
+			typename HashLookupKey<TKey, TLookupKey>::Type LookupKey(Key);
+			return Find(LookupKey, GetHash(LookupKey));
+		}
+
+		template<typename TLookupKey>
+		TValue* Find(const TLookupKey& Key, HashType_t Hash) const
+		{
+			typename HashLookupKey<TKey, TLookupKey>::Type LookupKey(Key);
+			PairType_t* Pair = FindPair(Hash, LookupKey);
+			return Pair != nullptr ? &Pair->Value : nullptr;
+		}
+
+		/* Finds the pair for a key or claims a slot for it with a default constructed
+		   value. The key is only converted to TKey when it's inserted. */
+		template<typename TLookupKey>
+		InsertResult_t FindOrInsert(const TLookupKey& Key)
+		{
+			typename HashLookupKey<TKey, TLookupKey>::Type LookupKey(Key);
+			return FindOrInsert(LookupKey, GetHash(LookupKey));
+		}
+
+		template<typename TLookupKey>
+		InsertResult_t FindOrInsert(const TLookupKey& Key, HashType_t Hash)
+		{
+			typename HashLookupKey<TKey, TLookupKey>::Type LookupKey(Key);
+			StepReHash();
+			PairType_t* Pair = FindPair(Hash, LookupKey);
+			if (Pair != nullptr) return { Pair, false };
+			SizeType_t Index = PrepareInsert(Hash);
+			Pair = &Slots[Index];
+			BitPlacementNew(Pair) PairType_t{ TKey(LookupKey), TValue{} };
+			return { Pair, true };
 		}
 
 		TValue& operator[](const TKey& Key)
 		{
-			if (Buckets != nullptr)
+			return FindOrInsert(Key).Pair->Value;
+		}
+
+		void CheckGrow(SizeType_t AddCount = 1)
+		{
+			Reserve(ElementCount + AddCount);
+		}
+
+		template<typename TLookupKey>
+		HashType_t GetHash(const TLookupKey& Key) const { return Hasher(Key); }
+		SizeType_t GetCount() const { return ElementCount; }
+		SizeType_t GetCapacity() const { return Capacity; }
+		float GetMaxLoadFactor() const { return (float)MaxLoadFactor / (float)LOAD_FACTOR_ONE; }
+		float GetLoadFactor() const { return Capacity > 0 ? (float)ElementCount / (float)Capacity : 0.0f; }
+		bool IsEmpty() const { return ElementCount == 0; }
+		bool IsReHashing() const { return OldControl != nullptr; }
+		bool IsIncrementalReHash() const { return bIncrementalReHash; }
+
+	private:
+		static HashControl_t GetH2(HashType_t Hash) { return (HashControl_t)(Hash & 0x7F); }
+		static SizeType_t GetH1(HashType_t Hash) { return (SizeType_t)(Hash >> 7); }
+
+		/* At least one slot always stays empty so probes terminate */
+		SizeType_t GetMaxLoad(SizeType_t InCapacity) const
+		{
+			return bit::Min((InCapacity * MaxLoadFactor) >> LOAD_FACTOR_SHIFT, bit::Max(InCapacity - 1, (SizeType_t)0));
+		}
+
+		SizeType_t GetCapacityFor(SizeType_t Count) const
+		{
+			SizeType_t NewCapacity = MIN_CAPACITY;
+			while (GetMaxLoad(NewCapacity) < Count) NewCapacity *= 2;
+			return NewCapacity;
+		}
+
+		template<typename TValueArg>
+		TValue& InsertOrAssign(const TKey& Key, TValueArg&& Value)
+		{
+			StepReHash();
+			HashType_t Hash = GetHash(Key);
+			PairType_t* Pair = FindPair(Hash, Key);
+			if (Pair != nullptr)
+			{
+				Pair->Value = bit::Forward<TValueArg>(Value);
+				return Pair->Value;
+			}
+			SizeType_t Index = PrepareInsert(Hash);
+			Pair = &Slots[Index];
+			BitPlacementNew(Pair) PairType_t{ Key, bit::Forward<TValueArg>(Value) };
+			return Pair->Value;
+		}
+
+		template<typename TLookupKey>
+		SizeType_t FindIndex(HashType_t Hash, const TLookupKey& Key) const
+		{
+			return FindIndexIn(Control, Slots, Capacity, Hash, Key);
+		}
+
+		/* Keys that weren't moved yet are still found in the old slot array */
+		template<typename TLookupKey>
+		PairType_t* FindPair(HashType_t Hash, const TLookupKey& Key) const
+		{
+			SizeType_t Index = FindIndex(Hash, Key);
+			if (Index != INVALID_INDEX) return &Slots[Index];
+			if (OldControl == nullptr) return nullptr;
+			Index = FindIndexIn(OldControl, OldSlots, OldCapacity, Hash, Key);
+			return Index != INVALID_INDEX ? &OldSlots[Index] : nullptr;
+		}
+
+		template<typename TLookupKey>
+		static SizeType_t FindIndexIn(const HashControl_t* Control, const PairType_t* Slots, SizeType_t Capacity, HashType_t Hash, const TLookupKey& Key)
+		{
+			if (Capacity == 0) return INVALID_INDEX;
+			SizeType_t Mask = Capacity - 1;
+			SizeType_t Offset = GetH1(Hash) & Mask;
+			HashControl_t H2 = GetH2(Hash);
+			// Triangular probing over groups visits every group once when the capacity is a power of two
+			for (SizeType_t Step = GROUP_WIDTH;; Step += GROUP_WIDTH)
 			{
-				HashTableKey TableKey = GetTableKey(Key);
-				BucketEntryType_t* Entry = Buckets[TableKey.BucketIndex].Find(TableKey.Hash, Key);
-				if (Entry != nullptr)
+				HashGroup Group(Control + Offset);
+				for (HashGroup::Mask_t Match = Group.Match(H2); Match; Match.ClearLowest())
 				{
-					return Entry->Data.Value;
+					SizeType_t Index = (Offset + Match.GetLowest()) & Mask;
+					if (Slots[Index].Key == Key) return Index;
 				}
+				if (Group.MatchEmpty()) return INVALID_INDEX;
+				Offset = (Offset + Step) & Mask;
 			}
-			TValue Default{};
-			return Insert(Key, Default);
 		}
 
-		void CheckGrow(SizeType_t AddCount = 1)
+		SizeType_t FindFirstFree(HashType_t Hash) const
 		{
-			if ((double)ElementCount + AddCount >= (double)BucketCount * 0.8)
+			SizeType_t Mask = Capacity - 1;
+			SizeType_t Offset = GetH1(Hash) & Mask;
+			for (SizeType_t Step = GROUP_WIDTH;; Step += GROUP_WIDTH)
 			{
-				ReHash((BucketCount + AddCount) * 4);
+				HashGroup::Mask_t Free = HashGroup(Control + Offset).MatchEmptyOrDeleted();
+				if (Free) return (Offset + Free.GetLowest()) & Mask;
+				Offset = (Offset + Step) & Mask;
 			}
 		}
 
-		HashType_t GetHash(const TKey& Key) const { return Hasher(Key); }
-		SizeType_t GetCount() const { return ElementCount; }
-		SizeType_t GetCapacity() const { return BucketCount; }
-		bool IsEmpty() const { return ElementCount == 0; }
+		/* Claims a slot for a key that isn't in the table. The caller constructs the pair. */
+		SizeType_t PrepareInsert(HashType_t Hash)
+		{
+			if (Capacity == 0) Resize(MIN_CAPACITY);
+			SizeType_t Index = FindFirstFree(Hash);
+			if (GrowthLeft == 0 && Control[Index] == HASH_CONTROL_EMPTY)
+			{
+				// When deleted slots take up an eighth of the load budget they are cleaned up in place
+				FinishReHash();
+				SizeType_t NewCapacity = ElementCount * 8 <= GetMaxLoad(Capacity) * 7 ? Capacity : Capacity * 2;
+				StartReHash(NewCapacity);
+				if (!bIncrementalReHash) FinishReHash();
+				Index = FindFirstFree(Hash);
+			}
+			GrowthLeft -= Control[Index] == HASH_CONTROL_EMPTY ? 1 : 0;
+			SetControl(Index, GetH2(Hash));
+			ElementCount += 1;
+			return Index;
+		}
 
-	private:
-		HashTableKey GetTableKey(const TKey& Key) const
+		/* The first group of control bytes is mirrored past the end so groups can be loaded from any slot */
+		void SetControl(SizeType_t Index, HashControl_t Value)
 		{
-			HashType_t Hash = GetHash(Key);
-			SizeType_t Index = Hash % BucketCount;
-			return { Hash, Index };
+			Control[Index] = Value;
+			if (Index < GROUP_WIDTH) Control[Capacity + Index] = Value;
+		}
+
+		void SetOldControl(SizeType_t Index, HashControl_t Value)
+		{
+			OldControl[Index] = Value;
+			if (Index < GROUP_WIDTH) OldControl[OldCapacity + Index] = Value;
+		}
+
+		void Resize(SizeType_t NewCapacity)
+		{
+			FinishReHash();
+			StartReHash(NewCapacity);
+			FinishReHash();
+		}
+
+		/* The current arrays become the old arrays and elements are moved out of them by MigrateSlots.
+		   Space for every element in the old arrays is already taken out of GrowthLeft. */
+		void StartReHash(SizeType_t NewCapacity)
+		{
+			OldControl = Control;
+			OldSlots = Slots;
+			OldCapacity = Capacity;
+			MigrateIndex = 0;
+
+			size_t SlotsSize = sizeof(PairType_t) * (size_t)NewCapacity;
+			void* Memory = NextSlots;
+			if (Memory == nullptr || NewCapacity != OldCapacity * 2)
+			{
+				if (Memory != nullptr) Storage.FreeBuckets(Memory);
+				Memory = Storage.AllocateBuckets(1, SlotsSize + (size_t)(NewCapacity + GROUP_WIDTH));
+				NextReady = 0;
+			}
+			Slots = (PairType_t*)Memory;
+			Control = (HashControl_t*)bit::OffsetPtr(Memory, (intptr_t)SlotsSize);
+			Capacity = NewCapacity;
+			GrowthLeft = GetMaxLoad(NewCapacity) - ElementCount;
+			bit::Memset(Control + NextReady, HASH_CONTROL_EMPTY, (size_t)(NewCapacity + GROUP_WIDTH - NextReady));
+			NextSlots = nullptr;
+			NextReady = 0;
+		}
+
+		/* Moves enough old slots that the rehash is done once half of GrowthLeft is used,
+		   two or three per insert after doubling. Once the last eighth of the growth budget
+		   is reached the next arrays are cleared over the inserts that are left. */
+		void StepReHash()
+		{
+			if (OldControl != nullptr)
+			{
+				SizeType_t Remaining = OldCapacity - MigrateIndex;
+				SizeType_t Budget = GrowthLeft / 2;
+				MigrateSlots((Remaining + Budget) / (Budget + 1));
+			}
+			else if (bIncrementalReHash && Capacity > 0 && GrowthLeft <= GetMaxLoad(Capacity) / 8)
+			{
+				ClearNextControl();
+			}
+		}
+
+		void ClearNextControl()
+		{
+			SizeType_t NextCapacity = Capacity * 2;
+			size_t SlotsSize = sizeof(PairType_t) * (size_t)NextCapacity;
+			if (NextSlots == nullptr)
+			{
+				NextSlots = (PairType_t*)Storage.AllocateBuckets(1, SlotsSize + (size_t)(NextCapacity + GROUP_WIDTH));
+				NextReady = 0;
+			}
+			SizeType_t Remaining = NextCapacity + GROUP_WIDTH - NextReady;
+			if (Remaining == 0) return;
+			SizeType_t Count = bit::Min(Remaining, bit::Max((Remaining + GrowthLeft) / (GrowthLeft + 1), CONTROL_CLEAR_STEP));
+			bit::Memset(bit::OffsetPtr(NextSlots, (intptr_t)(SlotsSize + (size_t)NextReady)), HASH_CONTROL_EMPTY, (size_t)Count);
+			NextReady += Count;
+		}
+
+		void MigrateSlots(SizeType_t Count)
+		{
+			SizeType_t End = bit::Min(MigrateIndex + Count, OldCapacity);
+			for (; MigrateIndex < End; ++MigrateIndex)
+			{
+				if (OldControl[MigrateIndex] < 0) continue;
+				PairType_t& Pair = OldSlots[MigrateIndex];
+				HashType_t Hash = GetHash(Pair.Key);
+				SizeType_t Index = FindFirstFree(Hash);
+				// The element was counted when GrowthLeft was computed, reusing a deleted slot gives it back
+				GrowthLeft += Control[Index] == HASH_CONTROL_DELETED ? 1 : 0;
+				SetControl(Index, GetH2(Hash));
+				BitPlacementNew(&Slots[Index]) PairType_t(bit::Move(Pair));
+				Pair.~PairType_t();
+				// Deleted rather than empty so probes for keys still in the old array go past it
+				SetOldControl(MigrateIndex, HASH_CONTROL_DELETED);
+			}
+			if (MigrateIndex == OldCapacity)
+			{
+				if (OldSlots != nullptr) Storage.FreeBuckets(OldSlots);
+				OldControl = nullptr;
+				OldSlots = nullptr;
+				OldCapacity = 0;
+				MigrateIndex = 0;
+			}
+		}
+
+		template<typename TLookupKey>
+		bool EraseOld(HashType_t Hash, const TLookupKey& Key)
+		{
+			if (OldControl == nullptr) return false;
+			SizeType_t Index = FindIndexIn(OldControl, OldSlots, OldCapacity, Hash, Key);
+			if (Index == INVALID_INDEX) return false;
+			OldSlots[Index].~PairType_t();
+			SetOldControl(Index, HASH_CONTROL_DELETED);
+			ElementCount -= 1;
+			GrowthLeft += 1;
+			return true;
+		}
+
+		void CopyFrom(const SelfType_t& Other)
+		{
+			for (ConstIteratorType_t Iter = Other.cbegin(); Iter != Other.cend(); ++Iter)
+			{
+				Insert(Iter->Key, Iter->Value);
+			}
+		}
+
+		void DestroySlots()
+		{
+			for (SizeType_t Index = 0; Index < Capacity; ++Index)
+			{
+				if (Control[Index] >= 0) Slots[Index].~PairType_t();
+			}
+			for (SizeType_t Index = 0; Index < OldCapacity; ++Index)
+			{
+				if (OldControl[Index] >= 0) OldSlots[Index].~PairType_t();
+			}
+			if (Slots != nullptr) Storage.FreeBuckets(Slots);
+			if (OldSlots != nullptr) Storage.FreeBuckets(OldSlots);
+			if (NextSlots != nullptr) Storage.FreeBuckets(NextSlots);
+			Control = nullptr;
+			Slots = nullptr;
+			Capacity = 0;
+			ElementCount = 0;
+			GrowthLeft = 0;
+			OldControl = nullptr;
+			OldSlots = nullptr;
+			OldCapacity = 0;
+			MigrateIndex = 0;
+			NextSlots = nullptr;
+			NextReady = 0;
 		}
 
 		TStorage Storage;
-		BucketType_t* Buckets;
-		SizeType_t BucketCount;
+		HashControl_t* Control;
+		PairType_t* Slots;
+		SizeType_t Capacity;
 		SizeType_t ElementCount;
-		SizeType_t FurthestBucket;
-		SizeType_t ClosestBucket;
+		SizeType_t GrowthLeft; // Empty slots that can still be filled before the table has to grow
+		HashControl_t* OldControl; // Arrays still being moved by an incremental rehash
+		PairType_t* OldSlots;
+		SizeType_t OldCapacity;
+		SizeType_t MigrateIndex; // Old slots below it were already moved
+		PairType_t* NextSlots; // Arrays for the next growth, allocated before the table is full
+		SizeType_t NextReady; // Control bytes of the next arrays already set to empty
+		uint32_t MaxLoadFactor; // Fixed point, LOAD_FACTOR_ONE is a full table
+		bool bIncrementalReHash;
 		HashFunc_t Hasher;
 	};
 
@@ -118,6 +118,8 @@ namespace bit
 		/* Begin range for loop implementation */
 		IteratorType_t begin() { return IteratorType_t(Head); }
 		IteratorType_t end() { return IteratorType_t(nullptr); }
+		ConstIteratorType_t begin() const { return ConstIteratorType_t(Head); }
+		ConstIteratorType_t end() const { return ConstIteratorType_t(nullptr); }
 		ConstIteratorType_t cbegin() const { return ConstIteratorType_t(Head); }
 		ConstIteratorType_t cend() const { return ConstIteratorType_t(nullptr); }
 		/* End range for loop implementation */
@@ -149,7 +151,7 @@ namespace bit
 		{}
 
 		LinkedList(SelfType_t&& Other) :
-			Storage(Other.Storage),
+			Storage(bit::Move(Other.Storage)),
 			Head(Other.Head),
 			Tail(Other.Tail),
 			Count(Other.Count)
@@ -160,15 +162,25 @@ namespace bit
 		}
 
 		~LinkedList()
+		{
+			Clear();
+			Storage.Free();
+		}
+
+		/* Destroys every element. The nodes stay in the storage pool for reuse. */
+		void Clear()
 		{
 			LinkType_t* Link = Head;
 			while (Link != nullptr)
 			{
 				LinkType_t* Next = Link->Next;
 				bit::Destroy(Link);
+				Storage.FreeLink(Link);
 				Link = Next;
 			}
-			Storage.Free();
+			Head = nullptr;
+			Tail = nullptr;
+			Count = 0;
 		}
 
 		T& Insert(const T& Element)
@@ -186,12 +198,9 @@ namespace bit
 			LinkType_t* Link = FindLink(Element);
 			if (Link != nullptr)
 			{
+				if (Link == Head) Head = Link->Next;
+				if (Link == Tail) Tail = Link->Prev;
 				Unlink(Link);
-				if (Link == Head)
-				{
-					Head = nullptr;
-					Tail = nullptr;
-				}
 				bit::Destroy(Link);
 				Storage.FreeLink(Link);
 				Count -= 1;
@@ -234,8 +243,10 @@ namespace bit
 			return *Invalid;
 		}
 
-		SelfType_t operator=(const SelfType_t& Other)
+		SelfType_t& operator=(const SelfType_t& Other)
 		{
+			if (this == &Other) return *this;
+			Clear();
 			for (const T& Element : Other)
 			{
 				Insert(Element);
@@ -243,13 +254,14 @@ namespace bit
 			return *this;
 		}
 
-		SelfType_t operator=(SelfType_t&& Other)
+		SelfType_t& operator=(SelfType_t&& Other)
 		{
-			Storage = Other.Storage;
+			if (this == &Other) return *this;
+			Clear();
+			Storage = bit::Move(Other.Storage);
 			Head = Other.Head;
 			Tail = Other.Tail;
 			Count = Other.Count;
-			Other.Storage = nullptr;
 			Other.Head = nullptr;
 			Other.Tail = nullptr;
 			Other.Count = 0;
@@ -101,10 +101,7 @@ namespace bit
 		{
 			if (AllocationSize > 0)
 			{
-				void* NewBlock = BackingAllocator->Allocate(Size * Count, bit::DEFAULT_ALIGNMENT);
-				Memcpy(NewBlock, Block, Size * Count);
-				BackingAllocator->Free(Block);
-				Block = NewBlock;
+				Block = BackingAllocator->Reallocate(Block, Size * Count, bit::DEFAULT_ALIGNMENT);
 			}
 			else
 			{
@@ -113,6 +110,39 @@ namespace bit
 			AllocationSize = Size * Count;
 		}
 
+		/* Allocate for a block holding UsedCount constructed elements. Types that aren't
+		   trivially relocatable can't go through Reallocate, they are moved to a new block
+		   when the allocator can't resize this one in place. */
+		template<typename TElement>
+		void AllocateElements(SizeType_t Count, SizeType_t UsedCount)
+		{
+			BIT_IF_CONSTEXPR (bit::IsTriviallyRelocatable<TElement>::Value)
+			{
+				Allocate(sizeof(TElement), Count);
+			}
+			else
+			{
+				SizeType_t NewSize = (SizeType_t)sizeof(TElement) * Count;
+				if (AllocationSize == 0 || UsedCount == 0)
+				{
+					Allocate(sizeof(TElement), Count);
+				}
+				else if (BackingAllocator->ResizeInPlace(Block, (size_t)NewSize))
+				{
+					AllocationSize = NewSize;
+				}
+				else
+				{
+					void* NewBlock = BackingAllocator->Allocate((size_t)NewSize, bit::DEFAULT_ALIGNMENT);
+					BIT_ASSERT_MSG(NewBlock != nullptr, "Failed to allocate block of %lld bytes", (long long)NewSize);
+					bit::RelocateArray((TElement*)NewBlock, (TElement*)Block, (size_t)bit::Min(UsedCount, Count));
+					BackingAllocator->Free(Block);
+					Block = NewBlock;
+					AllocationSize = NewSize;
+				}
+			}
+		}
+
 		void Free()
 		{
 			if (IsValid())
@@ -145,7 +175,14 @@ namespace bit
 
 		void Allocate(SizeType_t Size, SizeType_t Count)
 		{
-			BIT_ASSERT_MSG(Size * Count <= Capacity * sizeof(T), "Block is too small to fit requested allocation.");
+			BIT_ASSERT_MSG((size_t)(Size * Count) <= Capacity * sizeof(T), "Block is too small to fit requested allocation.");
+		}
+
+		/* Elements never move, the block is always the inline one */
+		template<typename TElement>
+		void AllocateElements(SizeType_t Count, SizeType_t)
+		{
+			Allocate(sizeof(TElement), Count);
 		}
 
 		void Free() {}
@@ -244,7 +281,7 @@ namespace bit
 
 		void Allocate(SizeType_t Size, SizeType_t Count)
 		{
-			if (Size * Count > InlineCount * sizeof(T))
+			if ((size_t)(Size * Count) > InlineCount * sizeof(T))
 			{
 				FallbackAllocator.Allocate(Size, Count);
 				if (IsUsingInlineBlock())
@@ -261,6 +298,37 @@ namespace bit
 			}
 		}
 
+		/* Elements are moved between the inline and fallback blocks with RelocateArray */
+		template<typename TElement>
+		void AllocateElements(SizeType_t Count, SizeType_t UsedCount)
+		{
+			SizeType_t RelocateCount = bit::Min(UsedCount, Count);
+			if ((SizeType_t)sizeof(TElement) * Count > (SizeType_t)(InlineCount * sizeof(T)))
+			{
+				if (IsUsingInlineBlock())
+				{
+					FallbackAllocator.template AllocateElements<TElement>(Count, 0);
+					bit::RelocateArray((TElement*)FallbackAllocator.GetBlock(), (TElement*)Block, (size_t)RelocateCount);
+				}
+				else
+				{
+					FallbackAllocator.template AllocateElements<TElement>(Count, UsedCount);
+				}
+				Block = FallbackAllocator.GetBlock();
+				BlockSize = (SizeType_t)sizeof(TElement) * Count;
+			}
+			else
+			{
+				if (!IsUsingInlineBlock() && IsValid())
+				{
+					bit::RelocateArray((TElement*)&InlineBlock[0], (TElement*)Block, (size_t)RelocateCount);
+					FallbackAllocator.Free();
+				}
+				Block = (void*)&InlineBlock[0];
+				BlockSize = InlineCount * sizeof(T);
+			}
+		}
+
 		void Free() 
 		{
 			if (!IsUsingInlineBlock())
@@ -282,49 +350,81 @@ namespace bit
 		SizeType_t BlockSize;
 	};
 
+	/* Pool for fixed size links. Links are carved from contiguous blocks that double in
+	   size up to MAX_BLOCK_LINK_COUNT links, freed links go to a free list and are reused
+	   first. Blocks are only returned to the allocator by Free. */
 	struct BITLIB_API LinkedListStorage
 	{
+		static constexpr size_t MAX_BLOCK_LINK_COUNT = 1024;
+
 		struct BITLIB_API StorageBlockLink
 		{
 			StorageBlockLink* Next;
 		};
 
+		struct BITLIB_API FreeLinkEntry
+		{
+			FreeLinkEntry* Next;
+		};
+
 		LinkedListStorage(size_t InAllocSize, size_t InAllocCount, size_t InAlignment) :
-			Allocator(&bit::GetGlobalAllocator()),
-			BlockList(nullptr),
-			BlockData(nullptr),
-			BlockUsed(0),
-			AllocSize(InAllocSize),
-			AllocCount(InAllocCount),
-			AllocAlignment(InAlignment)
+			LinkedListStorage(InAllocSize, InAllocCount, InAlignment, &bit::GetGlobalAllocator())
 		{}
 
 		LinkedListStorage(size_t InAllocSize, size_t InAllocCount, size_t InAlignment, IAllocator* InAllocator) :
 			Allocator(InAllocator),
 			BlockList(nullptr),
+			FreeList(nullptr),
 			BlockData(nullptr),
 			BlockUsed(0),
-			AllocSize(InAllocSize),
-			AllocCount(InAllocCount),
-			AllocAlignment(InAlignment)
+			BlockCapacity(0),
+			AllocSize(bit::AlignUint(bit::Max(InAllocSize, sizeof(FreeLinkEntry)), bit::Max(InAlignment, alignof(FreeLinkEntry)))),
+			AllocCount(bit::Max(InAllocCount, (size_t)1)),
+			AllocAlignment(bit::Max(InAlignment, alignof(FreeLinkEntry)))
 		{}
 
+		LinkedListStorage(const LinkedListStorage&) = delete;
+		LinkedListStorage& operator=(const LinkedListStorage&) = delete;
+
 		LinkedListStorage(LinkedListStorage&& Other) noexcept :
 			Allocator(Other.Allocator),
 			BlockList(Other.BlockList),
+			FreeList(Other.FreeList),
 			BlockData(Other.BlockData),
 			BlockUsed(Other.BlockUsed),
+			BlockCapacity(Other.BlockCapacity),
 			AllocSize(Other.AllocSize),
 			AllocCount(Other.AllocCount),
 			AllocAlignment(Other.AllocAlignment)
 		{
-			Other.Allocator = nullptr;
-			Other.BlockList = nullptr;
-			Other.AllocSize = 0;
-			Other.AllocCount = 0;
-			Other.AllocAlignment = 0;
+			Other.ResetBlocks();
 		}
 
+		LinkedListStorage& operator=(LinkedListStorage&& Other) noexcept
+		{
+			if (this != &Other)
+			{
+				Free();
+				Allocator = Other.Allocator;
+				BlockList = Other.BlockList;
+				FreeList = Other.FreeList;
+				BlockData = Other.BlockData;
+				BlockUsed = Other.BlockUsed;
+				BlockCapacity = Other.BlockCapacity;
+				AllocSize = Other.AllocSize;
+				AllocCount = Other.AllocCount;
+				AllocAlignment = Other.AllocAlignment;
+				Other.ResetBlocks();
+			}
+			return *this;
+		}
+
+		~LinkedListStorage()
+		{
+			Free();
+		}
+
+		/* Returns every block to the allocator. Links handed out before are invalid after this. */
 		void Free()
 		{
 			for (StorageBlockLink* Block = BlockList; Block != nullptr; )
@@ -333,45 +433,64 @@ namespace bit
 				Allocator->Free(Block);
 				Block = Next;
 			}
+			ResetBlocks();
 		}
 
 		void* AllocateLink()
 		{
-			/*if (Allocator == nullptr) return nullptr;
-			if (BlockList == nullptr)
+			if (FreeList != nullptr)
 			{
-				AllocateNewBlock();
+				FreeLinkEntry* Entry = FreeList;
+				FreeList = Entry->Next;
+				return Entry;
 			}
-			
-			if (BlockUsed + AllocSize > (AllocSize * AllocCount))
+			if (BlockUsed + AllocSize > BlockCapacity)
 			{
 				AllocateNewBlock();
 			}
-			void* Ptr = bit::OffsetPtr(BlockData, BlockUsed);
+			void* Ptr = bit::OffsetPtr(BlockData, (intptr_t)BlockUsed);
 			BlockUsed += AllocSize;
-			return Ptr;*/
-			return Allocator->Allocate(AllocSize, AllocAlignment);
+			return Ptr;
 		}
 
 		void FreeLink(void* Link)
 		{
-			Allocator->Free(Link);
+			FreeLinkEntry* Entry = (FreeLinkEntry*)Link;
+			Entry->Next = FreeList;
+			FreeList = Entry;
 		}
 
 	private:
 		void AllocateNewBlock()
 		{
-			StorageBlockLink* NewBlock = (StorageBlockLink*)Allocator->Allocate(sizeof(StorageBlockLink) + AllocSize * AllocCount, alignof(StorageBlockLink));
+			// The first block holds AllocCount links, every next one twice the previous
+			size_t LinkCount = BlockCapacity > 0 ? bit::Min((BlockCapacity / AllocSize) * 2, MAX_BLOCK_LINK_COUNT) : AllocCount;
+			LinkCount = bit::Max(LinkCount, AllocCount);
+			size_t HeaderSize = bit::AlignUint(sizeof(StorageBlockLink), AllocAlignment);
+			StorageBlockLink* NewBlock = (StorageBlockLink*)Allocator->Allocate(HeaderSize + AllocSize * LinkCount, bit::Max(AllocAlignment, alignof(StorageBlockLink)));
+			BIT_ASSERT_MSG(NewBlock != nullptr, "Failed to allocate linked list block");
 			NewBlock->Next = BlockList;
 			BlockList = NewBlock;
-			BlockData = bit::AlignPtr(bit::OffsetPtr(NewBlock, sizeof(StorageBlockLink)), AllocAlignment);
+			BlockData = bit::OffsetPtr(NewBlock, (intptr_t)HeaderSize);
+			BlockUsed = 0;
+			BlockCapacity = AllocSize * LinkCount;
+		}
+
+		void ResetBlocks()
+		{
+			BlockList = nullptr;
+			FreeList = nullptr;
+			BlockData = nullptr;
 			BlockUsed = 0;
+			BlockCapacity = 0;
 		}
 
 		IAllocator* Allocator;
 		StorageBlockLink* BlockList;
+		FreeLinkEntry* FreeList;
 		void* BlockData;
 		size_t BlockUsed;
+		size_t BlockCapacity;
 		size_t AllocSize;
 		size_t AllocCount;
 		size_t AllocAlignment;
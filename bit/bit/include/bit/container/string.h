@@ -23,12 +23,31 @@ namespace bit
 	typedef bit::Array<CharType_t> StringStorage_t;
 #endif
 
+	struct String;
+
+	/* Characters owned by someone else. Not null terminated unless the source was.
+	   Used to look up String keys without building a String. */
+	struct BITLIB_API StringView
+	{
+		StringView() : Data(nullptr), Length(0) {}
+		StringView(const CharType_t* RawStr) : Data(RawStr), Length((SizeType_t)bit::Strlen(RawStr)) {}
+		StringView(const CharType_t* RawStr, SizeType_t Len) : Data(RawStr), Length(Len) {}
+		StringView(const String& Str);
+		const CharType_t* operator*() const { return Data; }
+		SizeType_t GetLength() const { return Length; }
+
+	private:
+		const CharType_t* Data;
+		SizeType_t Length;
+	};
+
 	/* ASCII String. Maybe at some point use unicode (utf-8 encoding) */
 	struct BITLIB_API String
 	{
 		String();
 		String(const CharType_t* RawStr);
 		String(const CharType_t* RawStr, SizeType_t Len);
+		explicit String(const StringView& View);
 		String(const String& Other);
 		String(String&& Other) noexcept;
 		String& operator=(const CharType_t* RawStr);
@@ -38,6 +57,8 @@ namespace bit
 		String& operator+=(const String& Other);
 		const CharType_t* operator*() const;
 		SizeType_t GetLength() const;
+		/* True when SubStr occurs in the string, Offset gets the position of the first match */
+		bool Contains(const StringView& SubStr, SizeType_t* Offset = nullptr) const;
 		void Copy(const CharType_t* RawStr, SizeType_t Len);
 		void Copy(const String& Other);
 		void Append(const CharType_t* RawStr, SizeType_t Len);
@@ -56,13 +77,60 @@ namespace bit
 		StringStorage_t Storage;
 	};
 
+	BITLIB_API bool operator==(const String& LHS, const StringView& RHS);
+	BITLIB_API bool operator==(const StringView& LHS, const String& RHS);
+	BITLIB_API bool operator==(const String& LHS, const CharType_t* RHS);
+	BITLIB_API bool operator!=(const String& LHS, const StringView& RHS);
+	BITLIB_API bool operator!=(const StringView& LHS, const String& RHS);
+	BITLIB_API bool operator!=(const String& LHS, const CharType_t* RHS);
+
+	/* Views and raw strings hash like the String holding the same characters */
 	template<>
 	struct BITLIB_API Hash<String>
 	{
 		typedef size_t HashType_t;
 		HashType_t operator()(const String& String) const
 		{
-			return bit::MurmurHash(*String, String.GetLength(), bit::DEFAULT_HASH_SEED);
+			return bit::WyHash(*String, String.GetLength(), bit::DEFAULT_HASH_SEED);
+		}
+
+		HashType_t operator()(const StringView& View) const
+		{
+			return bit::WyHash(*View, View.GetLength(), bit::DEFAULT_HASH_SEED);
+		}
+
+		HashType_t operator()(const CharType_t* RawStr) const
+		{
+			return bit::WyHash(RawStr, bit::Strlen(RawStr), bit::DEFAULT_HASH_SEED);
+		}
+	};
+
+	/* Raw strings are measured once per lookup instead of once per probed String */
+	template<>
+	struct HashLookupKey<String, const CharType_t*>
+	{
+		typedef StringView Type;
+	};
+
+	template<>
+	struct HashLookupKey<String, CharType_t*>
+	{
+		typedef StringView Type;
+	};
+
+	template<size_t Size>
+	struct HashLookupKey<String, CharType_t[Size]>
+	{
+		typedef StringView Type;
+	};
+
+	template<>
+	struct BITLIB_API Hash<StringView>
+	{
+		typedef size_t HashType_t;
+		HashType_t operator()(const StringView& View) const
+		{
+			return bit::WyHash(*View, View.GetLength(), bit::DEFAULT_HASH_SEED);
 		}
 	};
 
@@ -72,7 +140,7 @@ namespace bit
 		typedef size_t HashType_t;
 		HashType_t operator()(const char* Str) const
 		{
-			return bit::MurmurHash(Str, bit::Strlen(Str), bit::DEFAULT_HASH_SEED);
+			return bit::WyHash(Str, bit::Strlen(Str), bit::DEFAULT_HASH_SEED);
 		}
 	};
 
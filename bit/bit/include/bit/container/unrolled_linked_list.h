@@ -0,0 +1,594 @@
+#pragma once
+
+#include <bit/container/array.h>
+#include <bit/container/storage.h>
+#include <bit/core/memory/allocator.h>
+#include <bit/core/types.h>
+#include <bit/core/os/os.h>
+
+namespace bit
+{
+	/* Default element count per node, about 256 bytes of elements and never less than 4 */
+	template<typename T>
+	struct UnrolledNodeCapacity
+	{
+		static constexpr SizeType_t Value = sizeof(T) * 4 >= 256 ? 4 : (SizeType_t)(256 / sizeof(T));
+	};
+
+	template<typename T, SizeType_t Capacity>
+	struct UnrolledNodeLink
+	{
+		typedef T ElementType_t;
+		UnrolledNodeLink* Prev;
+		UnrolledNodeLink* Next;
+		SizeType_t Count;
+		SizeType_t Slot; // Position in the list's node tree, in list order but with free slots between
+		alignas(T) uint8_t Elements[sizeof(T) * Capacity];
+
+		T* GetElements() { return (T*)&Elements[0]; }
+		const T* GetElements() const { return (const T*)&Elements[0]; }
+	};
+
+	template<typename TNodeType, typename TElementType>
+	struct UnrolledLinkIterator
+	{
+		UnrolledLinkIterator(TNodeType* Node, SizeType_t Index) :
+			Node(Node),
+			Index(Index)
+		{}
+
+		TElementType& operator*() const { return Node->GetElements()[Index]; }
+		TElementType* operator->() const { return &Node->GetElements()[Index]; }
+		UnrolledLinkIterator& operator++()
+		{
+			if (Node != nullptr && ++Index == Node->Count)
+			{
+				Node = Node->Next;
+				Index = 0;
+			}
+			return *this;
+		}
+		UnrolledLinkIterator operator++(int32_t) { UnrolledLinkIterator Self = *this; ++(*this); return Self; }
+
+		friend bool operator==(const UnrolledLinkIterator& A, const UnrolledLinkIterator& B)
+		{
+			return A.Node == B.Node && A.Index == B.Index;
+		}
+
+		friend bool operator!=(const UnrolledLinkIterator& A, const UnrolledLinkIterator& B)
+		{
+			return !(A == B);
+		}
+
+		TNodeType* Node;
+		SizeType_t Index;
+	};
+
+	/* Linked list of nodes that hold up to TCapacity elements each. Iterating touches one
+	   node per TCapacity elements. Indexing first checks the last node it found, so walking
+	   by index is O(1), and otherwise searches a Fenwick tree over the element count of every
+	   node, O(log(Count / TCapacity)). Appending only bumps the tail's count, which stays out
+	   of the tree, inserting or erasing in the middle updates one node's count in
+	   O(log(Count / TCapacity)). A split that finds the tree slot after its node taken
+	   moves the following nodes up to a nearby free slot, and only when there's none
+	   spreads all nodes out again in O(Count / TCapacity).
+	   Inserting or erasing shifts the following elements of the same node, so unlike
+	   LinkedList element addresses are only stable while their node isn't modified. */
+	template<
+		typename T,
+		typename TStorage = LinkedListStorage,
+		SizeType_t TCapacity = UnrolledNodeCapacity<T>::Value
+	>
+	struct UnrolledLinkedList
+	{
+		typedef UnrolledLinkedList<T, TStorage, TCapacity> SelfType_t;
+		typedef UnrolledNodeLink<T, TCapacity> NodeType_t;
+		typedef T ElementType_t;
+		typedef UnrolledLinkIterator<NodeType_t, T> IteratorType_t;
+		typedef UnrolledLinkIterator<const NodeType_t, const T> ConstIteratorType_t;
+
+		static constexpr SizeType_t MIN_SLOT_COUNT = 8;
+		static constexpr SizeType_t MAX_SLOT_SHIFT = 32; // Furthest a split looks for a free slot before spreading all nodes out
+		static_assert(TCapacity >= 2, "Unrolled linked list nodes must hold at least two elements");
+
+	public:
+		/* Begin range for loop implementation */
+		IteratorType_t begin() { return IteratorType_t(Head, 0); }
+		IteratorType_t end() { return IteratorType_t(nullptr, 0); }
+		ConstIteratorType_t begin() const { return ConstIteratorType_t(Head, 0); }
+		ConstIteratorType_t end() const { return ConstIteratorType_t(nullptr, 0); }
+		ConstIteratorType_t cbegin() const { return ConstIteratorType_t(Head, 0); }
+		ConstIteratorType_t cend() const { return ConstIteratorType_t(nullptr, 0); }
+		/* End range for loop implementation */
+
+		UnrolledLinkedList() :
+			Storage(sizeof(NodeType_t), 8, alignof(NodeType_t)),
+			Head(nullptr),
+			Tail(nullptr),
+			Count(0),
+			NodeCount(0),
+			FingerNode(nullptr),
+			FingerStart(0),
+			DirtyNode(nullptr),
+			DirtyDelta(0)
+		{}
+
+		UnrolledLinkedList(IAllocator& InAllocator) :
+			Storage(sizeof(NodeType_t), 8, alignof(NodeType_t), &InAllocator),
+			Head(nullptr),
+			Tail(nullptr),
+			Count(0),
+			NodeCount(0),
+			FingerNode(nullptr),
+			FingerStart(0),
+			NodeTree(InAllocator),
+			SlotNodes(InAllocator),
+			DirtyNode(nullptr),
+			DirtyDelta(0)
+		{}
+
+		UnrolledLinkedList(const SelfType_t& Other) :
+			UnrolledLinkedList()
+		{
+			for (const T& Element : Other)
+			{
+				Insert(Element);
+			}
+		}
+
+		UnrolledLinkedList(SelfType_t&& Other) :
+			Storage(bit::Move(Other.Storage)),
+			Head(Other.Head),
+			Tail(Other.Tail),
+			Count(Other.Count),
+			NodeCount(Other.NodeCount),
+			FingerNode(Other.FingerNode),
+			FingerStart(Other.FingerStart),
+			NodeTree(bit::Move(Other.NodeTree)),
+			SlotNodes(bit::Move(Other.SlotNodes)),
+			DirtyNode(Other.DirtyNode),
+			DirtyDelta(Other.DirtyDelta)
+		{
+			Other.Head = nullptr;
+			Other.Tail = nullptr;
+			Other.Count = 0;
+			Other.NodeCount = 0;
+			Other.FingerNode = nullptr;
+			Other.FingerStart = 0;
+			Other.DirtyNode = nullptr;
+			Other.DirtyDelta = 0;
+		}
+
+		~UnrolledLinkedList()
+		{
+			Clear();
+			Storage.Free();
+		}
+
+		/* Destroys every element. The nodes stay in the storage pool for reuse. */
+		void Clear()
+		{
+			NodeType_t* Node = Head;
+			while (Node != nullptr)
+			{
+				NodeType_t* Next = Node->Next;
+				bit::DestroyArray(Node->GetElements(), (size_t)Node->Count);
+				Storage.FreeLink(Node);
+				Node = Next;
+			}
+			Head = nullptr;
+			Tail = nullptr;
+			Count = 0;
+			NodeCount = 0;
+			FingerNode = nullptr;
+			FingerStart = 0;
+			NodeTree.Clear();
+			SlotNodes.Clear();
+			DirtyNode = nullptr;
+			DirtyDelta = 0;
+		}
+
+		T& Insert(const T& Element)
+		{
+			return *bit::Construct(AppendSlot(), Element);
+		}
+
+		T& Insert(T&& Element)
+		{
+			return *bit::Construct(AppendSlot(), bit::Move(Element));
+		}
+
+		template<typename... TArgs>
+		T* New(TArgs&& ... ConstructorArgs)
+		{
+			return bit::Construct(AppendSlot(), bit::Forward<TArgs>(ConstructorArgs)...);
+		}
+
+		/* Inserts before the element at Index, a full node is split in two first */
+		T& InsertAt(SizeType_t Index, const T& Element)
+		{
+			return *bit::Construct(InsertSlot(Index), Element);
+		}
+
+		T& InsertAt(SizeType_t Index, T&& Element)
+		{
+			return *bit::Construct(InsertSlot(Index), bit::Move(Element));
+		}
+
+		bool Erase(const T& Element)
+		{
+			SizeType_t Start = 0;
+			for (NodeType_t* Node = Head; Node != nullptr; Node = Node->Next)
+			{
+				T* Elements = Node->GetElements();
+				for (SizeType_t Offset = 0; Offset < Node->Count; ++Offset)
+				{
+					if (Elements[Offset] == Element)
+					{
+						RemoveAt(Node, Start, Offset);
+						return true;
+					}
+				}
+				Start += Node->Count;
+			}
+			return false;
+		}
+
+		void EraseAt(SizeType_t Index)
+		{
+			BIT_ASSERT_MSG(Index >= 0 && Index < Count, "Unrolled linked list index out of bounds");
+			SizeType_t Start = 0;
+			NodeType_t* Node = FindNode(Index, Start);
+			RemoveAt(Node, Start, Index - Start);
+		}
+
+		bool Contains(const T& Element) const
+		{
+			for (const T& Value : *this)
+			{
+				if (Value == Element) return true;
+			}
+			return false;
+		}
+
+		SizeType_t GetCount() const { return Count; }
+		bool IsEmpty() const { return Count == 0; }
+
+		T& operator[](SizeType_t Index)
+		{
+			BIT_ASSERT_MSG(Index >= 0 && Index < Count, "Unrolled linked list index out of bounds");
+			SizeType_t Start = 0;
+			NodeType_t* Node = FindNode(Index, Start);
+			return Node->GetElements()[Index - Start];
+		}
+
+		const T& operator[](SizeType_t Index) const
+		{
+			BIT_ASSERT_MSG(Index >= 0 && Index < Count, "Unrolled linked list index out of bounds");
+			SizeType_t Start = 0;
+			const NodeType_t* Node = FindNode(Index, Start);
+			return Node->GetElements()[Index - Start];
+		}
+
+		SelfType_t& operator=(const SelfType_t& Other)
+		{
+			if (this == &Other) return *this;
+			Clear();
+			for (const T& Element : Other)
+			{
+				Insert(Element);
+			}
+			return *this;
+		}
+
+		SelfType_t& operator=(SelfType_t&& Other)
+		{
+			if (this == &Other) return *this;
+			Clear();
+			Storage = bit::Move(Other.Storage);
+			Head = Other.Head;
+			Tail = Other.Tail;
+			Count = Other.Count;
+			NodeCount = Other.NodeCount;
+			FingerNode = Other.FingerNode;
+			FingerStart = Other.FingerStart;
+			NodeTree = bit::Move(Other.NodeTree);
+			SlotNodes = bit::Move(Other.SlotNodes);
+			DirtyNode = Other.DirtyNode;
+			DirtyDelta = Other.DirtyDelta;
+			Other.Head = nullptr;
+			Other.Tail = nullptr;
+			Other.Count = 0;
+			Other.NodeCount = 0;
+			Other.FingerNode = nullptr;
+			Other.FingerStart = 0;
+			Other.DirtyNode = nullptr;
+			Other.DirtyDelta = 0;
+			return *this;
+		}
+
+	private:
+		/* Appending never changes where earlier nodes start and the tail's count isn't in the tree */
+		T* AppendSlot()
+		{
+			if (Tail == nullptr || Tail->Count == TCapacity)
+			{
+				InsertNodeAfter(Tail);
+			}
+			Count += 1;
+			return &Tail->GetElements()[Tail->Count++];
+		}
+
+		T* InsertSlot(SizeType_t Index)
+		{
+			BIT_ASSERT_MSG(Index >= 0 && Index <= Count, "Unrolled linked list index out of bounds");
+			if (Index == Count) return AppendSlot();
+			SizeType_t Start = 0;
+			NodeType_t* Node = FindNode(Index, Start);
+			SizeType_t Offset = Index - Start;
+			if (Node->Count == TCapacity)
+			{
+				NodeType_t* NewNode = InsertNodeAfter(Node);
+				SizeType_t Half = TCapacity / 2;
+				MoveElements(Node->GetElements() + Half, NewNode->GetElements(), TCapacity - Half);
+				AddNodeCount(NewNode, TCapacity - Half);
+				AddNodeCount(Node, Half - TCapacity);
+				if (Offset > Half)
+				{
+					Node = NewNode;
+					Start += Half;
+					Offset -= Half;
+				}
+			}
+			T* Elements = Node->GetElements();
+			for (SizeType_t Slot = Node->Count; Slot > Offset; --Slot)
+			{
+				bit::Construct(&Elements[Slot], bit::Move(Elements[Slot - 1]));
+				bit::Destroy(&Elements[Slot - 1]);
+			}
+			AddNodeCount(Node, 1);
+			Count += 1;
+			FingerNode = Node;
+			FingerStart = Start;
+			return &Elements[Offset];
+		}
+
+		void RemoveAt(NodeType_t* Node, SizeType_t Start, SizeType_t Offset)
+		{
+			T* Elements = Node->GetElements();
+			bit::Destroy(&Elements[Offset]);
+			MoveElements(&Elements[Offset + 1], &Elements[Offset], Node->Count - Offset - 1);
+			AddNodeCount(Node, -1);
+			Count -= 1;
+			if (Node->Count == 0)
+			{
+				RemoveNode(Node);
+				FingerNode = nullptr;
+				FingerStart = 0;
+				return;
+			}
+			// Keep nodes dense, an underfull node takes in the next one when they both fit
+			NodeType_t* Next = Node->Next;
+			if (Next != nullptr && Node->Count < TCapacity / 2 && Node->Count + Next->Count <= TCapacity)
+			{
+				MoveElements(Next->GetElements(), Node->GetElements() + Node->Count, Next->Count);
+				AddNodeCount(Node, Next->Count);
+				RemoveNode(Next);
+			}
+			FingerNode = Node;
+			FingerStart = Start;
+		}
+
+		NodeType_t* FindNode(SizeType_t Index, SizeType_t& OutStart) const
+		{
+			if (FingerNode != nullptr)
+			{
+				// Walking by index stays in the finger node or moves to one of its neighbours
+				if (Index >= FingerStart && Index < FingerStart + FingerNode->Count)
+				{
+					OutStart = FingerStart;
+					return FingerNode;
+				}
+				NodeType_t* Next = FingerNode->Next;
+				SizeType_t NextStart = FingerStart + FingerNode->Count;
+				if (Next != nullptr && Index >= NextStart && Index < NextStart + Next->Count)
+				{
+					FingerNode = Next;
+					FingerStart = NextStart;
+					OutStart = NextStart;
+					return Next;
+				}
+			}
+			SizeType_t Start = Count - Tail->Count;
+			NodeType_t* Node = Tail;
+			if (Index < Start)
+			{
+				FlushDirtyNode();
+				// Descends the tree to the last slot whose preceding nodes hold at most Index elements
+				const SizeType_t* Tree = NodeTree.GetData();
+				SizeType_t Slot = 0;
+				Start = 0;
+				for (SizeType_t Step = NodeTree.GetCount(); Step > 0; Step >>= 1)
+				{
+					if (Slot + Step <= NodeTree.GetCount() && Start + Tree[Slot + Step - 1] <= Index)
+					{
+						Slot += Step;
+						Start += Tree[Slot - 1];
+					}
+				}
+				Node = *SlotNodes.GetData(Slot);
+			}
+			FingerNode = Node;
+			FingerStart = Start;
+			OutStart = Start;
+			return Node;
+		}
+
+		/* Every node but the tail has its count in the tree. Changes to the last node edited
+		   outside the tail are held back until another node is edited or the tree is searched,
+		   so erasing or inserting through one node updates the tree once. */
+		void AddNodeCount(NodeType_t* Node, SizeType_t Delta)
+		{
+			Node->Count += Delta;
+			if (Node == Tail) return;
+			if (Node != DirtyNode)
+			{
+				FlushDirtyNode();
+				DirtyNode = Node;
+			}
+			DirtyDelta += Delta;
+		}
+
+		BIT_FORCENOINLINE void FlushDirtyNode() const
+		{
+			if (DirtyNode == nullptr) return;
+			AddTreeCount(DirtyNode->Slot, DirtyDelta);
+			DirtyNode = nullptr;
+			DirtyDelta = 0;
+		}
+
+		void AddTreeCount(SizeType_t Slot, SizeType_t Delta) const
+		{
+			SizeType_t* Tree = NodeTree.GetData();
+			for (SizeType_t Position = Slot + 1; Position <= NodeTree.GetCount(); Position += Position & -Position)
+			{
+				Tree[Position - 1] += Delta;
+			}
+		}
+
+		/* Gives a new node the slot right after Prev. When that slot is taken the nodes after it
+		   move up to a nearby free slot, or all nodes are spread out when there's none. When it's
+		   past the end the slots double unless most of them are free. */
+		void AssignSlot(NodeType_t* Node, NodeType_t* Prev)
+		{
+			SizeType_t Slot = Prev != nullptr ? Prev->Slot + 1 : 0;
+			if (Slot == SlotNodes.GetCount() && NodeCount * 4 > Slot)
+			{
+				GrowSlots();
+			}
+			else if (Slot == SlotNodes.GetCount() || (SlotNodes[Slot] != nullptr && !ShiftSlots(Slot)))
+			{
+				SpreadSlots();
+				Slot = Prev != nullptr ? Prev->Slot + 1 : 0;
+			}
+			Node->Slot = Slot;
+			SlotNodes[Slot] = Node;
+		}
+
+		/* Frees Slot by moving the nodes from it up to the first free slot within MAX_SLOT_SHIFT */
+		bool ShiftSlots(SizeType_t Slot)
+		{
+			SizeType_t End = bit::Min(Slot + MAX_SLOT_SHIFT, SlotNodes.GetCount());
+			SizeType_t Free = Slot;
+			while (Free < End && SlotNodes[Free] != nullptr) Free += 1;
+			if (Free == End) return false;
+			FlushDirtyNode();
+			for (; Free > Slot; --Free)
+			{
+				NodeType_t* Moved = SlotNodes[Free - 1];
+				SizeType_t MovedCount = Moved != Tail ? Moved->Count : 0;
+				AddTreeCount(Free - 1, -MovedCount);
+				AddTreeCount(Free, MovedCount);
+				Moved->Slot = Free;
+				SlotNodes[Free] = Moved;
+			}
+			SlotNodes[Slot] = nullptr;
+			return true;
+		}
+
+		/* The slot count stays a power of two. Free slots at the end hold zero, so after doubling
+		   only the top entry covers anything and it takes the total of the old tree. */
+		void GrowSlots()
+		{
+			SizeType_t OldCount = SlotNodes.GetCount();
+			SlotNodes.AddZeroed(OldCount);
+			NodeTree.AddZeroed(OldCount);
+			NodeTree[OldCount * 2 - 1] = NodeTree[OldCount - 1];
+		}
+
+		/* Puts every node two slots apart from the start so each one can be split once more without
+		   moving the others, and leaves at least half of the slots free at the end for appending */
+		void SpreadSlots()
+		{
+			SizeType_t SlotCount = (SizeType_t)bit::NextPow2((size_t)bit::Max(NodeCount * 4, MIN_SLOT_COUNT));
+			SlotNodes.Clear();
+			NodeTree.Clear();
+			SlotNodes.AddZeroed(SlotCount);
+			NodeTree.AddZeroed(SlotCount);
+			SizeType_t Slot = 0;
+			for (NodeType_t* Node = Head; Node != nullptr; Node = Node->Next, Slot += 2)
+			{
+				Node->Slot = Slot;
+				SlotNodes[Slot] = Node;
+				NodeTree[Slot] = Node != Tail ? Node->Count : 0;
+			}
+			DirtyNode = nullptr;
+			DirtyDelta = 0;
+			// Builds the tree in place by pushing every entry into the one above it
+			for (SizeType_t Position = 1; Position <= SlotCount; ++Position)
+			{
+				SizeType_t Parent = Position + (Position & -Position);
+				if (Parent <= SlotCount) NodeTree[Parent - 1] += NodeTree[Position - 1];
+			}
+		}
+
+		/* Out of line so the slot bookkeeping doesn't bloat the inlined append and erase paths */
+		BIT_FORCENOINLINE NodeType_t* InsertNodeAfter(NodeType_t* Prev)
+		{
+			NodeType_t* Node = (NodeType_t*)Storage.AllocateLink();
+			Node->Count = 0;
+			AssignSlot(Node, Prev);
+			NodeCount += 1;
+			// The old tail's count goes into the tree once it stops being the tail
+			if (Prev != nullptr && Prev == Tail) AddTreeCount(Prev->Slot, Prev->Count);
+			Node->Prev = Prev;
+			Node->Next = Prev != nullptr ? Prev->Next : Head;
+			if (Node->Next != nullptr) Node->Next->Prev = Node;
+			else Tail = Node;
+			if (Prev != nullptr) Prev->Next = Node;
+			else Head = Node;
+			return Node;
+		}
+
+		BIT_FORCENOINLINE void RemoveNode(NodeType_t* Node)
+		{
+			FlushDirtyNode();
+			if (Node != Tail) AddTreeCount(Node->Slot, -Node->Count);
+			else if (Node->Prev != nullptr) AddTreeCount(Node->Prev->Slot, -Node->Prev->Count);
+			SlotNodes[Node->Slot] = nullptr;
+			NodeCount -= 1;
+			if (Node->Prev != nullptr) Node->Prev->Next = Node->Next;
+			else Head = Node->Next;
+			if (Node->Next != nullptr) Node->Next->Prev = Node->Prev;
+			else Tail = Node->Prev;
+			Storage.FreeLink(Node);
+			if (Head == nullptr)
+			{
+				NodeTree.Clear();
+				SlotNodes.Clear();
+			}
+		}
+
+		/* Moves into uninitialized slots, From and To may overlap when To is below From */
+		static void MoveElements(T* From, T* To, SizeType_t ElementCount)
+		{
+			for (SizeType_t Index = 0; Index < ElementCount; ++Index)
+			{
+				bit::Construct(&To[Index], bit::Move(From[Index]));
+				bit::Destroy(&From[Index]);
+			}
+		}
+
+		TStorage Storage;
+		NodeType_t* Head;
+		NodeType_t* Tail;
+		SizeType_t Count;
+		SizeType_t NodeCount;
+		mutable NodeType_t* FingerNode; // Last node found by index and the index of its first element
+		mutable SizeType_t FingerStart;
+		mutable Array<SizeType_t> NodeTree; // Fenwick tree over the element count in every slot, the tail's is left out
+		Array<NodeType_t*> SlotNodes; // Node in every slot, null for free ones
+		mutable NodeType_t* DirtyNode; // Node whose last count changes aren't in the tree yet
+		mutable SizeType_t DirtyDelta;
+	};
+}
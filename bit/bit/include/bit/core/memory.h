@@ -1,11 +1,14 @@
 #pragma once
 
 #include <bit/core/memory/allocator.h>
+#include <bit/core/memory/memory_ops.h>
+#include <bit/core/memory/string_ops.h>
 #include <bit/core/types.h>
 
 namespace bit
 {
 	struct IAllocator;
+	struct MemoryStats;
 
 	/* Allocation Functions */
 	BITLIB_API IAllocator& GetGlobalAllocator();
@@ -14,17 +17,17 @@ namespace bit
 	BITLIB_API void Free(void* Pointer);
 	BITLIB_API size_t CompactMemory();
 	BITLIB_API size_t GetMallocSize(void* Pointer);
+	/* Snapshot of the global allocator telemetry. See allocator_stats.h */
+	BITLIB_API void GetMemoryStats(MemoryStats& OutStats);
+	/* Records every global allocator call to a trace file. See allocation_trace.h */
+	BITLIB_API bool StartAllocationTrace(const char* Path);
+	BITLIB_API void StopAllocationTrace();
 	template<typename T> T* Malloc(size_t Count = 1) { return (T*)Malloc(Count * sizeof(T), alignof(T)); }
 	template<typename T, typename... TArgs> T* New(TArgs&& ... ConstructorArgs) { return BitPlacementNew((T*)bit::Malloc(sizeof(T), alignof(T))) T(bit::Forward<TArgs>(ConstructorArgs)...); }
 	template<typename T> void Delete(T* Ptr) { Ptr->~T(); bit::Free(Ptr); }
 
-	/* Memory Operation Functions */
-	BITLIB_API void* Memcpy(void* Dst, const void* Src, size_t Num);
-	BITLIB_API void* Memset(void* Ptr, int32_t Value, size_t Num);
-	BITLIB_API bool Memcmp(const void* A, const void* B, size_t Num);
-	BITLIB_API size_t Strlen(const char* Str);
-	BITLIB_API bool StrContains(const char* A, const char* B, size_t* Offset);
-	BITLIB_API bool Strcmp(const char* A, const char* B);
+	/* Memory Operation Functions. Memcpy, Memmove, Memset and Memcmp are in memory_ops.h,
+	   Strlen, StrContains, Strcmp and StrFind in string_ops.h */
 	BITLIB_API size_t Fmt(char* Buffer, size_t BufferSize, const char* Fmt, ...);
 	BITLIB_API const char* TempFmtString(const char* Fmt, ...);
 
@@ -82,5 +85,23 @@ namespace bit
 		Element->~T();
 	}
 
+	/* Moves Count elements to uninitialized memory at Dst and destroys them at Src */
+	template<typename T>
+	void RelocateArray(T* Dst, T* Src, size_t Count)
+	{
+		BIT_IF_CONSTEXPR (bit::IsTriviallyRelocatable<T>::Value)
+		{
+			bit::Memmove(Dst, Src, Count * sizeof(T));
+		}
+		else
+		{
+			for (size_t Index = 0; Index < Count; ++Index)
+			{
+				BitPlacementNew(&Dst[Index]) T(bit::Move(Src[Index]));
+				Src[Index].~T();
+			}
+		}
+	}
+
 
 }
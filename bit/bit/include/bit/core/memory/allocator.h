@@ -129,6 +129,11 @@ namespace bit
 		virtual bool CanAllocate(size_t Size, size_t Alignment) = 0;
 		virtual bool OwnsAllocation(const void* Ptr) = 0;
 		virtual size_t Compact() { return 0; }
+		/* Default implementation allocates a new block, copies and frees the old one */
+		virtual void* Reallocate(void* Pointer, size_t Size, size_t Alignment);
+		/* Grows or shrinks the allocation only if it can stay where it is, containers use it to
+		   avoid moving elements. The default succeeds when the block is already big enough. */
+		virtual bool ResizeInPlace(void* Pointer, size_t Size);
 
 	#if BIT_ALLOCATOR_USE_NAME
 		const char* GetName() const { return Name; }
@@ -12,6 +12,9 @@ namespace bit
 		~LinearAllocator();
 
 		void Reset();
+		/* Reset that also zeroes the used part of the arena with StreamZero, so clearing
+		   a large arena doesn't evict what the rest of the frame is working on */
+		void ResetAndZero();
 		void* Allocate(size_t Size, size_t Alignment) override;
 		void Free(void* Pointer) override;
 		size_t GetSize(void* Pointer) override;
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <bit/core/types.h>
+
+#if BIT_SIMD_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace bit
+{
+	/* Memcpy, Memmove, Memset and Memcmp handle up to MEMORY_INLINE_MAX_SIZE bytes inline
+	   with a few overlapping loads and stores, where the startup cost of rep movsb or of
+	   a call would dominate. Larger sizes go to the bulk functions, which pick SSE2, AVX2,
+	   rep movsb/stosb or non-temporal stores from the size and the CPU features. */
+	static constexpr size_t MEMORY_INLINE_MAX_SIZE = BIT_SIMD_SSE2 ? 64 : 16;
+
+	BITLIB_API void* MemcpyBulk(void* Dst, const void* Src, size_t Num);
+	BITLIB_API void* MemmoveBulk(void* Dst, const void* Src, size_t Num);
+	BITLIB_API void* MemsetBulk(void* Ptr, uint8_t Value, size_t Num);
+	BITLIB_API bool MemcmpBulk(const void* A, const void* B, size_t Num);
+
+	template<typename T>
+	BIT_FORCEINLINE T LoadUnaligned(const void* Ptr)
+	{
+	#if BIT_PLATFORM_WINDOWS
+		return *(const T*)Ptr;
+	#else
+		T Value;
+		__builtin_memcpy(&Value, Ptr, sizeof(T));
+		return Value;
+	#endif
+	}
+
+	template<typename T>
+	BIT_FORCEINLINE void StoreUnaligned(void* Ptr, T Value)
+	{
+	#if BIT_PLATFORM_WINDOWS
+		*(T*)Ptr = Value;
+	#else
+		__builtin_memcpy(Ptr, &Value, sizeof(T));
+	#endif
+	}
+
+	/* Num <= MEMORY_INLINE_MAX_SIZE. Everything is loaded before anything is stored so
+	   overlapping ranges are fine. */
+	BIT_FORCEINLINE void CopyInline(uint8_t* Dst, const uint8_t* Src, size_t Num)
+	{
+	#if BIT_SIMD_SSE2
+		if (Num >= 16)
+		{
+			if (Num > 32)
+			{
+				__m128i A = _mm_loadu_si128((const __m128i*)Src);
+				__m128i B = _mm_loadu_si128((const __m128i*)(Src + 16));
+				__m128i C = _mm_loadu_si128((const __m128i*)(Src + Num - 32));
+				__m128i D = _mm_loadu_si128((const __m128i*)(Src + Num - 16));
+				_mm_storeu_si128((__m128i*)Dst, A);
+				_mm_storeu_si128((__m128i*)(Dst + 16), B);
+				_mm_storeu_si128((__m128i*)(Dst + Num - 32), C);
+				_mm_storeu_si128((__m128i*)(Dst + Num - 16), D);
+				return;
+			}
+			__m128i A = _mm_loadu_si128((const __m128i*)Src);
+			__m128i B = _mm_loadu_si128((const __m128i*)(Src + Num - 16));
+			_mm_storeu_si128((__m128i*)Dst, A);
+			_mm_storeu_si128((__m128i*)(Dst + Num - 16), B);
+			return;
+		}
+	#endif
+		if (Num >= 8)
+		{
+			uint64_t A = LoadUnaligned<uint64_t>(Src);
+			uint64_t B = LoadUnaligned<uint64_t>(Src + Num - 8);
+			StoreUnaligned(Dst, A);
+			StoreUnaligned(Dst + Num - 8, B);
+		}
+		else if (Num >= 4)
+		{
+			uint32_t A = LoadUnaligned<uint32_t>(Src);
+			uint32_t B = LoadUnaligned<uint32_t>(Src + Num - 4);
+			StoreUnaligned(Dst, A);
+			StoreUnaligned(Dst + Num - 4, B);
+		}
+		else if (Num > 0)
+		{
+			uint8_t A = Src[0];
+			uint8_t B = Src[Num >> 1];
+			uint8_t C = Src[Num - 1];
+			Dst[0] = A;
+			Dst[Num >> 1] = B;
+			Dst[Num - 1] = C;
+		}
+	}
+
+	/* Num <= MEMORY_INLINE_MAX_SIZE */
+	BIT_FORCEINLINE void SetInline(uint8_t* Dst, uint8_t Value, size_t Num)
+	{
+	#if BIT_SIMD_SSE2
+		if (Num >= 16)
+		{
+			__m128i Fill = _mm_set1_epi8((char)Value);
+			_mm_storeu_si128((__m128i*)Dst, Fill);
+			_mm_storeu_si128((__m128i*)(Dst + Num - 16), Fill);
+			if (Num > 32)
+			{
+				_mm_storeu_si128((__m128i*)(Dst + 16), Fill);
+				_mm_storeu_si128((__m128i*)(Dst + Num - 32), Fill);
+			}
+			return;
+		}
+	#endif
+		uint64_t Fill = 0x0101010101010101ULL * Value;
+		if (Num >= 8)
+		{
+			StoreUnaligned(Dst, Fill);
+			StoreUnaligned(Dst + Num - 8, Fill);
+		}
+		else if (Num >= 4)
+		{
+			StoreUnaligned(Dst, (uint32_t)Fill);
+			StoreUnaligned(Dst + Num - 4, (uint32_t)Fill);
+		}
+		else if (Num > 0)
+		{
+			Dst[0] = Value;
+			Dst[Num >> 1] = Value;
+			Dst[Num - 1] = Value;
+		}
+	}
+
+	/* Num <= MEMORY_INLINE_MAX_SIZE */
+	BIT_FORCEINLINE bool CompareInline(const uint8_t* A, const uint8_t* B, size_t Num)
+	{
+	#if BIT_SIMD_SSE2
+		if (Num >= 16)
+		{
+			__m128i Equal = _mm_and_si128(
+				_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)A), _mm_loadu_si128((const __m128i*)B)),
+				_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(A + Num - 16)), _mm_loadu_si128((const __m128i*)(B + Num - 16))));
+			if (Num > 32)
+			{
+				Equal = _mm_and_si128(Equal, _mm_and_si128(
+					_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(A + 16)), _mm_loadu_si128((const __m128i*)(B + 16))),
+					_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(A + Num - 32)), _mm_loadu_si128((const __m128i*)(B + Num - 32)))));
+			}
+			return _mm_movemask_epi8(Equal) == 0xFFFF;
+		}
+	#endif
+		if (Num >= 8)
+		{
+			return ((LoadUnaligned<uint64_t>(A) ^ LoadUnaligned<uint64_t>(B)) |
+				(LoadUnaligned<uint64_t>(A + Num - 8) ^ LoadUnaligned<uint64_t>(B + Num - 8))) == 0;
+		}
+		if (Num >= 4)
+		{
+			return ((LoadUnaligned<uint32_t>(A) ^ LoadUnaligned<uint32_t>(B)) |
+				(LoadUnaligned<uint32_t>(A + Num - 4) ^ LoadUnaligned<uint32_t>(B + Num - 4))) == 0;
+		}
+		if (Num > 0)
+		{
+			return A[0] == B[0] && A[Num >> 1] == B[Num >> 1] && A[Num - 1] == B[Num - 1];
+		}
+		return true;
+	}
+
+	/* Src and Dst must not overlap, use Memmove for that */
+	BIT_FORCEINLINE void* Memcpy(void* Dst, const void* Src, size_t Num)
+	{
+		if (Num <= MEMORY_INLINE_MAX_SIZE)
+		{
+			CopyInline((uint8_t*)Dst, (const uint8_t*)Src, Num);
+			return Dst;
+		}
+		return MemcpyBulk(Dst, Src, Num);
+	}
+
+	BIT_FORCEINLINE void* Memmove(void* Dst, const void* Src, size_t Num)
+	{
+		if (Num <= MEMORY_INLINE_MAX_SIZE)
+		{
+			CopyInline((uint8_t*)Dst, (const uint8_t*)Src, Num);
+			return Dst;
+		}
+		return MemmoveBulk(Dst, Src, Num);
+	}
+
+	BIT_FORCEINLINE void* Memset(void* Ptr, int32_t Value, size_t Num)
+	{
+		if (Num <= MEMORY_INLINE_MAX_SIZE)
+		{
+			SetInline((uint8_t*)Ptr, (uint8_t)Value, Num);
+			return Ptr;
+		}
+		return MemsetBulk(Ptr, (uint8_t)Value, Num);
+	}
+
+	/* True when the Num bytes at A and B are equal */
+	BIT_FORCEINLINE bool Memcmp(const void* A, const void* B, size_t Num)
+	{
+		if (Num <= MEMORY_INLINE_MAX_SIZE)
+		{
+			return CompareInline((const uint8_t*)A, (const uint8_t*)B, Num);
+		}
+		return MemcmpBulk(A, B, Num);
+	}
+
+	/* Copy and zero fill with non-temporal stores that go around the cache, for large
+	   buffers that won't be read again soon, like resetting an arena. Memcpy and Memset
+	   only do this above half the last level cache. The stores are fenced before
+	   returning so the data is visible to other threads like with a regular copy. */
+	BITLIB_API void* StreamCopy(void* Dst, const void* Src, size_t Num);
+	BITLIB_API void* StreamZero(void* Ptr, size_t Num);
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <bit/core/types.h>
+
+namespace bit
+{
+	/* Null terminated string functions, these forward to the C runtime */
+	BITLIB_API size_t Strlen(const char* Str);
+	/* True when B occurs in A, Offset gets the position of the first match */
+	BITLIB_API bool StrContains(const char* A, const char* B, size_t* Offset);
+	/* True when A and B hold the same characters */
+	BITLIB_API bool Strcmp(const char* A, const char* B);
+
+	/* StrContains for strings with known lengths, neither needs a null terminator.
+	   Candidates are filtered by comparing the first and last byte of SubStr against
+	   a whole block of Str at once with SSE2 or AVX2, only those are compared in full. */
+	BITLIB_API bool StrFind(const char* Str, size_t StrLen, const char* SubStr, size_t SubStrLen, size_t* Offset);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <bit/core/types.h>
+#include <bit/core/os/mutex.h>
+#include <bit/core/os/thread.h>
+#include <bit/core/os/virtual_memory.h>
+
+namespace bit
+{
+	enum class AllocationEventType : uint8_t
+	{
+		EVENT_ALLOCATE,
+		EVENT_FREE,
+		EVENT_REALLOCATE
+	};
+
+	/* Trace files start with an AllocationTraceHeader followed by tightly packed events */
+	struct BITLIB_API AllocationTraceHeader
+	{
+		static constexpr uint32_t MAGIC = 0x52544142; // "BATR"
+		static constexpr uint32_t VERSION = 1;
+
+		uint32_t Magic;
+		uint32_t Version;
+		uint32_t EventSize;
+		uint32_t Reserved;
+	};
+
+	struct BITLIB_API AllocationEvent
+	{
+		uint64_t Timestamp; // Nanoseconds since recording started
+		uint64_t Address; // Null when the allocation failed
+		uint64_t PrevAddress; // Block passed to Reallocate
+		uint64_t Size;
+		uint64_t CallSite; // Return address of the caller. Only stable within one run.
+		int32_t ThreadId;
+		uint8_t AlignmentShift; // Alignment is 1 << AlignmentShift
+		AllocationEventType Type;
+		uint8_t Padding[2];
+	};
+	static_assert(sizeof(AllocationEvent) == 48, "AllocationEvent is written as is to trace files");
+
+	/* Records allocation events into a ring buffer that a writer thread streams to a file.
+	   Record never allocates from the global allocator so it can be called from inside it.
+	   When the ring is full the recording thread writes it out itself. Events recorded
+	   while Stop runs may be lost. */
+	struct BITLIB_API AllocationTraceRecorder : public NonCopyable
+	{
+		static constexpr int64_t RING_CAPACITY = 64 * 1024; // Events
+		static constexpr uint32_t WRITE_INTERVAL_MS = 10;
+
+		AllocationTraceRecorder();
+		~AllocationTraceRecorder();
+		bool Start(const char* Path);
+		void Stop();
+		bool IsRecording() const { return bRecording != 0; }
+		void Record(AllocationEventType Type, const void* Address, const void* PrevAddress, size_t Size, size_t Alignment, const void* CallSite);
+
+	private:
+		static int32_t WriterMain(void* UserData);
+		void Flush();
+		/* Writes out the ring. FlushLock must be held. */
+		void WriteRing();
+
+		VirtualMemoryBlock RingMemory;
+		AllocationEvent* Ring;
+		Mutex RingLock;
+		Mutex FlushLock;
+		Thread Writer;
+		void* File;
+		double StartSeconds;
+		int64_t Head;
+		int64_t Tail;
+		int32_t bRecording;
+	};
+
+	/* Reads trace files written by AllocationTraceRecorder */
+	struct BITLIB_API AllocationTraceReader : public NonCopyable
+	{
+		AllocationTraceReader();
+		~AllocationTraceReader();
+		/* Fails if the file can't be opened or wasn't written by a compatible recorder */
+		bool Open(const char* Path);
+		bool Read(AllocationEvent& OutEvent);
+		void Close();
+
+	private:
+		void* File;
+	};
+}
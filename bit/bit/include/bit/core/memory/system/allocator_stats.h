@@ -0,0 +1,163 @@
+#pragma once
+
+#include <bit/core/types.h>
+#include <bit/core/memory/allocator.h>
+#include <bit/core/os/atomics.h>
+#include <bit/core/os/mutex.h>
+
+/* Allocator telemetry is on by default in debug builds. Define BIT_ALLOCATOR_STATS=1 to keep it
+   in release builds. When disabled every counter update compiles to nothing. The counters
+   are always declared so the layout does not depend on the setting of the including code. */
+#ifndef BIT_ALLOCATOR_STATS
+#define BIT_ALLOCATOR_STATS BIT_BUILD_DEBUG
+#endif
+
+namespace bit
+{
+	/* Snapshot of a single size class. Bytes count whole blocks, not requested sizes. */
+	struct BITLIB_API SizeClassStats
+	{
+		size_t BlockSize;
+		int64_t AllocCount;
+		int64_t FreeCount;
+		int64_t LiveBytes;
+		int64_t PeakBytes;
+	};
+
+	/* Snapshot of a single allocator */
+	struct BITLIB_API AllocatorStats
+	{
+		AllocatorMemoryInfo MemoryInfo;
+		int64_t AllocCount;
+		int64_t FreeCount;
+		int64_t PeakAllocatedBytes;
+		int64_t CommitCount;
+		int64_t DecommitCount;
+		int64_t LockWaitCount;
+		int64_t LockWaitNanoseconds;
+		double FragmentationRatio; // Share of committed bytes not used by live allocations
+	};
+
+	/* Snapshot of every allocator owned by the MemoryManager */
+	struct BITLIB_API MemoryStats
+	{
+		static constexpr size_t MAX_SIZE_CLASSES = 64;
+
+		/* Writes the snapshot as JSON. Returns the length of the full output like snprintf
+		   so a short buffer can be retried with the right size. */
+		size_t WriteJson(char* Buffer, size_t BufferSize) const;
+
+		bool bEnabled;
+		AllocatorStats Total; // Peak is the sum of each allocator peak
+		AllocatorStats Small;
+		AllocatorStats Medium;
+		AllocatorStats Large;
+		SizeClassStats SmallClasses[MAX_SIZE_CLASSES];
+		SizeClassStats MediumClasses[MAX_SIZE_CLASSES];
+		size_t SmallClassCount;
+		size_t MediumClassCount;
+	};
+
+	BITLIB_API double GetFragmentationRatio(const AllocatorMemoryInfo& Info);
+
+	BIT_FORCEINLINE void StatsStoreMax(int64_t* Target, int64_t Value)
+	{
+		int64_t Current = *Target;
+		while (Value > Current)
+		{
+			int64_t Previous = AtomicCompareExchange(Target, Value, Current);
+			if (Previous == Current) break;
+			Current = Previous;
+		}
+	}
+
+	/* Live counters are updated with atomics so a snapshot can be taken while other threads allocate */
+	struct BITLIB_API SizeClassCounters
+	{
+		BIT_FORCEINLINE void OnAlloc(int64_t Bytes, int64_t Count = 1)
+		{
+			BIT_IF_CONSTEXPR (BIT_ALLOCATOR_STATS != 0)
+			{
+				AtomicAdd(&AllocCount, Count);
+				StatsStoreMax(&PeakBytes, AtomicAdd(&LiveBytes, Bytes) + Bytes);
+			}
+		}
+
+		BIT_FORCEINLINE void OnFree(int64_t Bytes, int64_t Count = 1)
+		{
+			BIT_IF_CONSTEXPR (BIT_ALLOCATOR_STATS != 0)
+			{
+				AtomicAdd(&FreeCount, Count);
+				AtomicAdd(&LiveBytes, -Bytes);
+			}
+		}
+
+		SizeClassStats Read(size_t BlockSize) const;
+
+		int64_t AllocCount = 0;
+		int64_t FreeCount = 0;
+		int64_t LiveBytes = 0;
+		int64_t PeakBytes = 0;
+	};
+
+	struct BITLIB_API AllocatorCounters
+	{
+		BIT_FORCEINLINE void OnAlloc(int64_t Bytes, int64_t Count = 1)
+		{
+			BIT_IF_CONSTEXPR (BIT_ALLOCATOR_STATS != 0)
+			{
+				AtomicAdd(&AllocCount, Count);
+				StatsStoreMax(&PeakBytes, AtomicAdd(&LiveBytes, Bytes) + Bytes);
+			}
+		}
+
+		BIT_FORCEINLINE void OnFree(int64_t Bytes, int64_t Count = 1)
+		{
+			BIT_IF_CONSTEXPR (BIT_ALLOCATOR_STATS != 0)
+			{
+				AtomicAdd(&FreeCount, Count);
+				AtomicAdd(&LiveBytes, -Bytes);
+			}
+		}
+
+		BIT_FORCEINLINE void OnCommit()
+		{
+			BIT_IF_CONSTEXPR (BIT_ALLOCATOR_STATS != 0)
+			{
+				AtomicIncrement(&CommitCount);
+			}
+		}
+
+		BIT_FORCEINLINE void OnDecommit()
+		{
+			BIT_IF_CONSTEXPR (BIT_ALLOCATOR_STATS != 0)
+			{
+				AtomicIncrement(&DecommitCount);
+			}
+		}
+
+		/* Fills the counters of OutStats. MemoryInfo and lock waits are left untouched. */
+		void Read(AllocatorStats& OutStats) const;
+
+		int64_t AllocCount = 0;
+		int64_t FreeCount = 0;
+		int64_t LiveBytes = 0;
+		int64_t PeakBytes = 0;
+		int64_t CommitCount = 0;
+		int64_t DecommitCount = 0;
+	};
+
+	/* Mutex that records how often and for how long Lock had to wait for another thread */
+	struct BITLIB_API StatsMutex : public NonCopyable
+	{
+		void Lock();
+		void Unlock() { Handle.Unlock(); }
+		/* Adds the wait counters to OutStats */
+		void Read(AllocatorStats& OutStats) const;
+
+	private:
+		Mutex Handle;
+		int64_t WaitCount = 0;
+		int64_t WaitNanoseconds = 0;
+	};
+}
@@ -2,17 +2,29 @@
 
 #include <bit/core/os/virtual_memory.h>
 #include <bit/core/memory/allocator.h>
-#include <bit/container/hash_table.h>
+#include <bit/core/memory/system/allocator_stats.h>
 
 namespace bit
 {
-	struct LargePageAllocator : public IAllocator
+	/* Maps every allocation directly from the OS backed by 2 MiB or 1 GiB pages when available.
+	   Allocations are tracked in an open addressing table that lives in its own reserved
+	   block so the allocator never calls back into the global allocator. 
+	   Alignment is limited to the OS page size. */
+	struct BITLIB_API LargePageAllocator : public IAllocator
 	{
 		struct AllocationEntry
 		{
+			void* Address;
 			uint64_t AllocatedBytes;
 			uint64_t CommittedBytes;
+			LargePageType PageType;
 		};
+
+		static constexpr size_t TABLE_SIZE = 16 * 1024;
+		static_assert((TABLE_SIZE & (TABLE_SIZE - 1)) == 0, "TABLE_SIZE must be power of 2");
+		// The table never fills up so every probe chain ends in an empty slot
+		static constexpr size_t MAX_ALLOCATION_COUNT = TABLE_SIZE / 8 * 7;
+
 		LargePageAllocator();
 		virtual ~LargePageAllocator();
 		virtual void* Allocate(size_t Size, size_t Alignment) override;
@@ -21,9 +33,22 @@ namespace bit
 		virtual AllocatorMemoryInfo GetMemoryUsageInfo() override;
 		virtual bool CanAllocate(size_t Size, size_t Alignment) override;
 		virtual bool OwnsAllocation(const void* Ptr) override;
-		
+		size_t GetAllocationCount() const { return AllocationCount; }
+		size_t GetLargePageBytes() const { return LargePageBytes; }
+		void GetStats(AllocatorStats& OutStats);
+
 	private:
-		bit::HashTable<void*, AllocationEntry> AllocationMap;
+		size_t GetSlotIndex(const void* Ptr) const;
+		AllocationEntry* FindEntry(const void* Ptr);
+		AllocationEntry* InsertEntry(void* Ptr);
+		void RemoveEntry(AllocationEntry* Entry);
+
+		AllocationEntry* AllocationMap;
 		bit::VirtualMemoryBlock AllocationMapBackstore;
+		size_t AllocationCount;
+		uint64_t AllocatedBytes;
+		uint64_t CommittedBytes;
+		uint64_t LargePageBytes;
+		AllocatorCounters Counters;
 	};
 }
@@ -1,11 +1,20 @@
 #pragma once
 
 #include <bit/core/types.h>
+#include <bit/core/memory/system/small_block_allocator.h>
 #include <bit/core/memory/system/tlsf_allocator.h>
+#include <bit/core/memory/system/large_page_allocator.h>
+#include <bit/core/memory/system/allocator_stats.h>
+#include <bit/core/memory/system/allocation_trace.h>
+#include <bit/core/os/thread_local_storage.h>
 #include <bit/core/os/mutex.h>
 
 namespace bit
 {
+	/* Dispatches allocations by size. Blocks up to SmallBlockAllocator::MAX_ALLOCATION_SIZE
+	   go to the SmallBlockAllocator, blocks up to TLSFAllocator::MAX_ALLOCATION_SIZE go to 
+	   the TLSFAllocator and anything bigger is mapped directly by the LargePageAllocator.
+	   Free and GetSize find the owner by address range. */
 	struct BITLIB_API MemoryManager : public IAllocator
 	{
 		MemoryManager();
@@ -16,10 +25,35 @@ namespace bit
 		bool CanAllocate(size_t Size, size_t Alignment) override;
 		bool OwnsAllocation(const void* Ptr) override;
 		size_t Compact() override;
-		void* Reallocate(void* Pointer, size_t Size, size_t Alignment);
+		void* Reallocate(void* Pointer, size_t Size, size_t Alignment) override;
+		/* Medium blocks grow into free neighbours, small and large blocks only within the
+		   size they were given */
+		bool ResizeInPlace(void* Pointer, size_t Size) override;
+		/* Reclaims blocks freed to the calling thread heap by other threads and releases its empty pages */
+		void CollectThreadHeap();
+		/* Counters are only filled when BIT_ALLOCATOR_STATS is enabled. Memory usage is always reported. */
+		void GetStats(MemoryStats& OutStats);
+		/* Same as Allocate, Reallocate and Free but record CallSite instead of the direct caller */
+		void* TracedAllocate(size_t Size, size_t Alignment, const void* CallSite);
+		void* TracedReallocate(void* Pointer, size_t Size, size_t Alignment, const void* CallSite);
+		void TracedFree(void* Pointer, const void* CallSite);
+		/* Streams every allocation, reallocation and free to a trace file until StopTrace */
+		bool StartTrace(const char* Path);
+		void StopTrace();
 
 	private:
-		TLSFAllocator BaseAllocator;
-		Mutex AccessLock;
+		void* AllocateBlock(size_t Size, size_t Alignment);
+		void* ReallocateBlock(void* Pointer, size_t Size, size_t Alignment, const void* CallSite);
+		void FreeBlock(void* Pointer);
+		static void OnThreadExit(void* Heap);
+		SmallBlockAllocator::ThreadHeap* GetThreadHeap();
+		void DestroyThreadHeap(SmallBlockAllocator::ThreadHeap* Heap);
+
+		SmallBlockAllocator SmallAllocator;
+		TLSFAllocator MediumAllocator;
+		LargePageAllocator LargeAllocator;
+		StatsMutex AccessLock;
+		TlsHandle ThreadHeapSlot;
+		AllocationTraceRecorder TraceRecorder;
 	};
 }
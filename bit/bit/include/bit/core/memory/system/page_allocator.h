@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bit/core/os/virtual_memory.h>
+#include <bit/core/memory/system/allocator_stats.h>
 
 namespace bit
 {
@@ -14,6 +15,7 @@ namespace bit
 		static constexpr size_t INVALID_LEVEL = 0xFFFFFFFF;
 		static constexpr size_t INVALID_PAGE = 0xFFFFFFFF;
 		static constexpr size_t DEFAULT_PAGE_ALIGNMENT = 0; // We don't use alignment here. By default it'll be aligned to page size.
+		static constexpr size_t MAX_LEVEL_COUNT = 64;
 
 		PageAllocator(const char* Name, void* StartAddress, size_t RegionSize, size_t AllocationGranularity = DEFAULT_PAGE_GRANULARITY);
 		~PageAllocator();
@@ -25,6 +27,9 @@ namespace bit
 		bool CanAllocate(size_t Size, size_t Alignment) override;
 		bool OwnsAllocation(const void* Ptr) override;
 		size_t GetPageSize();
+		void GetStats(AllocatorStats& OutStats);
+		/* Size classes are the buddy levels, from the whole region down to the page granularity. Returns the number of classes written. */
+		size_t GetSizeClassStats(SizeClassStats* OutStats, size_t MaxCount);
 
 	protected:
 		void DebugPrintState(size_t PageIndex = 0, size_t Depth = 0);
@@ -83,5 +88,7 @@ namespace bit
 		size_t PageGranularity;
 		size_t PageCount;
 		size_t LevelCount;
+		AllocatorCounters Counters;
+		SizeClassCounters LevelCounters[MAX_LEVEL_COUNT];
 	};
 }
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <bit/core/types.h>
+
+namespace bit
+{
+	/* Geometric size classes. Every power of two range is split in ClassesPerDoubling classes
+	   spaced by at least MinSize, so the smallest sizes end up MinSize apart. A class is always
+	   a multiple of any power of two alignment that divides the requested size.
+	   Sizes are mapped to classes with a table indexed by size in MinSize units built at compile time. */
+	template<size_t MinSize, size_t MaxSize, size_t ClassesPerDoubling>
+	struct SizeClassTable
+	{
+		static_assert(MinSize > 0 && (MinSize & (MinSize - 1)) == 0, "MinSize must be a power of two");
+		static_assert(MaxSize >= MinSize && (MaxSize & (MaxSize - 1)) == 0, "MaxSize must be a power of two");
+		static_assert(ClassesPerDoubling > 0 && (ClassesPerDoubling & (ClassesPerDoubling - 1)) == 0, "ClassesPerDoubling must be a power of two");
+
+		static constexpr size_t GetNextClassSize(size_t Size)
+		{
+			size_t RangeBase = MinSize;
+			while (RangeBase * 2 <= Size) RangeBase *= 2;
+			size_t Step = RangeBase / ClassesPerDoubling;
+			return Size + (Step < MinSize ? MinSize : Step);
+		}
+
+		static constexpr size_t CountClasses()
+		{
+			size_t Count = 1;
+			for (size_t Size = MinSize; Size < MaxSize; Size = GetNextClassSize(Size)) Count += 1;
+			return Count;
+		}
+
+		static constexpr size_t NUM_OF_CLASSES = CountClasses();
+		static constexpr size_t NUM_OF_LOOKUP_ENTRIES = MaxSize / MinSize + 1;
+		static_assert(NUM_OF_CLASSES <= 256, "Class indices are stored as uint8_t");
+
+		struct Tables_t
+		{
+			size_t ClassSizes[NUM_OF_CLASSES] = {};
+			uint8_t ClassIndices[NUM_OF_LOOKUP_ENTRIES] = {};
+		};
+
+		static constexpr Tables_t BuildTables()
+		{
+			Tables_t Tables = {};
+			size_t ClassIndex = 0;
+			for (size_t Size = MinSize; ClassIndex < NUM_OF_CLASSES; Size = GetNextClassSize(Size))
+			{
+				Tables.ClassSizes[ClassIndex++] = Size;
+			}
+			ClassIndex = 0;
+			for (size_t Entry = 0; Entry < NUM_OF_LOOKUP_ENTRIES; ++Entry)
+			{
+				while (Tables.ClassSizes[ClassIndex] < Entry * MinSize) ClassIndex += 1;
+				Tables.ClassIndices[Entry] = (uint8_t)ClassIndex;
+			}
+			return Tables;
+		}
+
+		static constexpr Tables_t TABLES = BuildTables();
+
+		/* Size must not be bigger than MaxSize */
+		static constexpr size_t GetClassIndex(size_t Size) { return TABLES.ClassIndices[(Size + MinSize - 1) / MinSize]; }
+		static constexpr size_t GetClassSize(size_t ClassIndex) { return TABLES.ClassSizes[ClassIndex]; }
+	};
+
+	template<size_t MinSize, size_t MaxSize, size_t ClassesPerDoubling>
+	constexpr typename SizeClassTable<MinSize, MaxSize, ClassesPerDoubling>::Tables_t SizeClassTable<MinSize, MaxSize, ClassesPerDoubling>::TABLES;
+}
@@ -3,37 +3,46 @@
 #include <bit/core/types.h>
 #include <bit/core/os/virtual_memory.h>
 #include <bit/core/os/debug.h>
+#include <bit/core/os/mutex.h>
 #include <bit/core/memory.h>
+#include <bit/core/memory/system/size_class_table.h>
+#include <bit/core/memory/system/allocator_stats.h>
 
 #define SMALL_SIZE_ALLOCATOR_MARK_BLOCKS 1
 
 namespace bit
 {
+	/* Pages are owned by a ThreadHeap. Only the owner thread allocates from a page and
+	   frees to its local free list. Blocks are carved lazily with a bump offset so a new
+	   page costs O(1) and untouched blocks are never written. Other threads push freed blocks to the page remote
+	   free list with a CAS and the owner reclaims them in batch when it runs out of blocks.
+	   The page pool is the only state shared between heaps and is protected by PageLock. */
 	struct BITLIB_API SmallBlockAllocator
 	{
+		struct ThreadHeap;
+
 		struct FreePageLink
 		{
 			FreePageLink* NextPage;
 		};
 
-		struct PageMetadata
-		{
-			int64_t PageIndex;
-			int64_t AllocatedBytes;
-			size_t AssignedSize;
-			PageMetadata* NextFreePage;
-		};
-
 		struct FreeBlockLink
 		{
-			FreeBlockLink* PrevBlock;
 			FreeBlockLink* NextBlock;
 		};
 
-		struct BlockMetadata
+		struct PageMetadata
 		{
-			int64_t AllocatedBytes;
-			FreeBlockLink* FreeList;
+			int64_t PageIndex;
+			int64_t AllocatedBytes; // Only touched by the owner. Remote frees count once reclaimed
+			size_t AssignedSize;
+			size_t BumpOffset; // Blocks below this offset have been handed out at least once
+			PageMetadata* NextFreePage;
+			ThreadHeap* Owner;
+			FreeBlockLink* LocalFreeList;
+			FreeBlockLink* RemoteFreeList;
+			PageMetadata* PrevHeapPage;
+			PageMetadata* NextHeapPage;
 		};
 
 		static constexpr uint32_t SMALL_SIZE_ALLOCATOR_MAGIC = 0xDEADBEEF;
@@ -43,48 +52,84 @@ namespace bit
 		static constexpr size_t NUM_OF_PAGES = ADDRESS_SPACE_SIZE / PAGE_SIZE;
 		static constexpr size_t SIZE_OF_BOOKKEEPING = sizeof(PageMetadata) * NUM_OF_PAGES;
 		static constexpr size_t TOTAL_ADDRESS_SPACE_SIZE = ADDRESS_SPACE_SIZE + SIZE_OF_BOOKKEEPING;
-		static constexpr size_t MIN_ALLOCATION_SIZE = sizeof(FreeBlockLink);
+		static constexpr size_t MIN_ALLOCATION_SIZE = 16;
 		static constexpr size_t MAX_ALLOCATION_SIZE = 32 * 1024;
-		static constexpr size_t NUM_OF_SIZES = MAX_ALLOCATION_SIZE / MIN_ALLOCATION_SIZE;
-		static_assert((MAX_ALLOCATION_SIZE% MIN_ALLOCATION_SIZE) == 0, "MAX_ALLOCATION_SIZE must be divisible by MIN_ALLOCATION_SIZE");
+		static constexpr size_t SIZE_CLASSES_PER_DOUBLING = 4;
+		typedef SizeClassTable<MIN_ALLOCATION_SIZE, MAX_ALLOCATION_SIZE, SIZE_CLASSES_PER_DOUBLING> SizeClasses_t;
+		static constexpr size_t NUM_OF_SIZES = SizeClasses_t::NUM_OF_CLASSES;
+		static constexpr int64_t MAX_RECLAIM_SCAN = 8; // Pages visited looking for reclaimable blocks before taking a new page
+		static_assert(MIN_ALLOCATION_SIZE >= sizeof(FreeBlockLink), "MIN_ALLOCATION_SIZE must fit a FreeBlockLink");
+
+		/* Circular list of owned pages per size class. The head is the page we allocate from. */
+		struct ThreadHeap
+		{
+			ThreadHeap(void* Context);
+			void* GetContext() const { return Context; }
+
+			PageMetadata* Pages[NUM_OF_SIZES];
+			void* Context;
+		};
 
 		SmallBlockAllocator();
+		~SmallBlockAllocator();
+		/* Allocates and frees through the shared heap. Used when the caller has no heap. */
 		void* Allocate(size_t Size, size_t Alignment);
 		void Free(void* Pointer);
+		/* Heap must only be used by the calling thread. Free accepts a null heap.
+		   Allocate returns null once the address space is used up. */
+		void* Allocate(ThreadHeap* Heap, size_t Size, size_t Alignment);
+		void Free(ThreadHeap* Heap, void* Pointer);
+		/* Reclaims remote frees and returns empty pages of the heap to the page pool */
+		void CollectHeap(ThreadHeap* Heap);
+		/* Releases empty pages and hands the rest over to the shared heap. Heap can be destroyed afterwards. */
+		void AbandonHeap(ThreadHeap* Heap);
 		size_t GetSize(void* Pointer);
+		/* Size of the block an allocation of Size and Alignment would be given. Size must pass CanAllocate. */
+		size_t GetAllocationSize(size_t Size, size_t Alignment);
 		AllocatorMemoryInfo GetMemoryUsageInfo();
 		bool CanAllocate(size_t Size, size_t Alignment);
 		bool OwnsAllocation(const void* Ptr);
 		size_t Compact();
+		void GetStats(AllocatorStats& OutStats);
+		/* Returns the number of classes written */
+		size_t GetSizeClassStats(SizeClassStats* OutStats, size_t MaxCount);
 
 	private:
 		size_t GetBlockSize(size_t BlockIndex);
 		size_t GetBlockIndex(size_t BlockSize);
-		FreeBlockLink* GetFreeBlock(size_t BlockIndex);
-		FreeBlockLink* GetFreeBlockFromNewPage(size_t BlockIndex);
+		bool HasFreeBlocks(const PageMetadata* PageData) const;
+		PageMetadata* FindPageWithFreeBlocks(ThreadHeap* Heap, size_t BlockIndex);
+		PageMetadata* AcquirePage(ThreadHeap* Heap, size_t BlockIndex);
+		void ReleasePage(ThreadHeap* Heap, PageMetadata* PageData);
+		void LinkHeapPage(ThreadHeap* Heap, size_t BlockIndex, PageMetadata* PageData);
+		void UnlinkHeapPage(ThreadHeap* Heap, size_t BlockIndex, PageMetadata* PageData);
+		void ReclaimRemoteFrees(PageMetadata* PageData);
+		void FreeLocal(ThreadHeap* Heap, PageMetadata* PageData, void* Pointer);
+		void FreeRemote(PageMetadata* PageData, void* Pointer);
 		FreePageLink* AllocateNewPage();
 		FreePageLink* GetFreePage();
-		void PushBlockToFreeList(size_t BlockIndex, FreeBlockLink* FreeBlock);
-		FreeBlockLink* UnlinkFreeBlock(size_t BlockIndex, FreeBlockLink* FreeBlock);
 		PageMetadata* GetPageData(const void* Ptr);
 		void* GetPageBaseByAddress(const void* Ptr);
 		void* GetPageBaseByAddressByIndex(size_t PageIndex);
 		size_t GetPageDataIndex(const void* Ptr);
-		void OnAlloc(size_t BlockIndex, size_t PageIndex);
-		void OnFree(size_t BlockIndex, size_t PageIndex);
+		void OnAlloc(size_t BlockIndex, int64_t Count);
+		void OnFree(size_t BlockIndex, int64_t Count);
 		void FreePage(size_t PageIndex);
 		size_t DecommitFreePages();
 
 	private:
-		BlockMetadata Blocks[NUM_OF_SIZES];
+		SizeClassCounters ClassCounters[NUM_OF_SIZES];
+		AllocatorCounters Counters;
 		PageMetadata Pages[NUM_OF_PAGES];
+		ThreadHeap SharedHeap;
+		StatsMutex SharedHeapLock;
+		StatsMutex PageLock;
 		VirtualMemoryBlock Memory;
 		PageMetadata* PageDecommitList;
 		FreePageLink* PageFreeList;
 		void* BaseVirtualAddress;
 		int64_t BaseVirtualAddressOffset;
 		int64_t PageFreeListBytes;
-		int64_t AllocatedBytes;
 		int64_t CommittedBytes;
 	};
-}
\ No newline at end of file
+}
@@ -1,5 +1,6 @@
 #include <bit/core/os/virtual_memory.h>
 #include <bit/core/memory/allocator.h>
+#include <bit/core/memory/system/allocator_stats.h>
 #include <bit/core/os/mutex.h>
 
 namespace bit
@@ -12,6 +13,7 @@ namespace bit
 		static constexpr uint64_t MAX_ALLOCATION_SIZE = 10 MiB;
 		static constexpr uint64_t ADDRESS_SPACE_SIZE = 8 GiB;
 		static constexpr uint64_t SLI = 5; // How many bits we assign for second level index
+		static constexpr size_t MAX_FREE_RANGES = 256; // Decommitted address ranges tracked for reuse
 
 	private:
 		struct BITLIB_API BlockHeader
@@ -45,6 +47,13 @@ namespace bit
 			VirtualPage* Next;
 		};
 
+		/* Decommitted part of the reserved address space that can be committed again */
+		struct BITLIB_API VirtualRange
+		{
+			size_t Offset;
+			size_t Size;
+		};
+
 		struct BITLIB_API BlockMap
 		{
 			uint64_t FL;
@@ -60,17 +69,26 @@ namespace bit
 		~TLSFAllocator();
 
 		void* Allocate(size_t Size, size_t Alignment);
+		/* Grows into a free right neighbour or splits off the tail when possible. 
+		   Only moves the block when it can't be resized in place. */
 		void* Reallocate(void* Pointer, size_t Size, size_t Alignment);
+		bool ResizeInPlace(void* Pointer, size_t Size);
 		void Free(void* Pointer);
 		size_t GetSize(void* Pointer);
 		AllocatorMemoryInfo GetMemoryUsageInfo();
 		bool CanAllocate(size_t Size, size_t Alignment);
 		bool OwnsAllocation(const void* Ptr);
 		size_t Compact();
+		void GetStats(AllocatorStats& OutStats);
+		/* Size classes are the first level ranges. Returns the number of classes written. */
+		size_t GetSizeClassStats(SizeClassStats* OutStats, size_t MaxCount);
 	
 	private:
 		void AllocateVirtualMemory(size_t Size);
 		bool FreeVirtualMemory(BlockFreeHeader* FreeBlock);
+		bool AcquireVirtualRange(size_t Size, size_t& OutOffset);
+		bool ReleaseVirtualRange(size_t Offset, size_t Size);
+		void RemoveVirtualRange(size_t Index);
 		size_t RoundToSlotSize(size_t Size);
 		void* AllocateAligned(uint64_t Size, uint64_t Alignment);
 		BlockMap MappingNoOffset(size_t Size) const;
@@ -86,18 +104,26 @@ namespace bit
 		void InsertBlock(BlockFreeHeader* Block, BlockMap Map);
 		BlockFreeHeader* MergeBlocks(BlockFreeHeader* Left, BlockFreeHeader* Right);
 		BlockFreeHeader* GetNextBlock(BlockFreeHeader* Block) const;
+		void ShrinkBlock(BlockFreeHeader* Block, uint64_t Size);
+		bool GrowBlock(BlockFreeHeader* Block, uint64_t Size);
 		size_t AdjustSize(size_t Size);
 		void FillBlock(BlockHeader* Block, uint8_t Value) const;
+		void OnBlockAllocated(uint64_t BlockSize);
+		void OnBlockFreed(uint64_t BlockSize);
 
 		uint64_t FLBitmap;
 		uint64_t SLBitmap[FL_COUNT];
 		BlockFreeHeader* FreeBlocks[FL_COUNT][SL_COUNT];
 		VirtualPage* PagesInUse;
+		VirtualRange FreeRanges[MAX_FREE_RANGES]; // Sorted by offset
+		size_t FreeRangeCount;
 		VirtualMemoryBlock Memory;
 		void* VirtualMemoryBaseAddress;
 		size_t PagesInUseCount;
 		size_t VirtualMemoryBaseOffset;
 		size_t UsedSpaceInBytes;
 		size_t AvailableSpaceInBytes;
+		AllocatorCounters Counters;
+		SizeClassCounters ClassCounters[FL_COUNT];
 	};
 }
@@ -2,6 +2,10 @@
 
 #include <bit/core/types.h>
 
+#if BIT_PLATFORM_WINDOWS
+#include <intrin.h>
+#endif
+
 namespace bit
 {
 	BITLIB_API int64_t AtomicExchange(int64_t* Target, int64_t Value);
@@ -12,6 +16,9 @@ namespace bit
 	BITLIB_API int64_t AtomicDecrement(int64_t* Target);
 	BITLIB_API int64_t AtomicPostIncrement(int64_t* Target);
 	BITLIB_API int64_t AtomicPostDecrement(int64_t* Target);
+	/* Acquire load and release store. Cheaper than a read-modify-write for publishing data. */
+	BITLIB_API int64_t AtomicLoad(const int64_t* Target);
+	BITLIB_API void AtomicStore(int64_t* Target, int64_t Value);
 
 	BITLIB_API int32_t AtomicExchange(int32_t* Target, int32_t Value);
 	BITLIB_API int32_t AtomicCompareExchange(int32_t* Target, int32_t Value, int32_t Comperand);
@@ -21,4 +28,63 @@ namespace bit
 	BITLIB_API int32_t AtomicDecrement(int32_t* Target);
 	BITLIB_API int32_t AtomicPostIncrement(int32_t* Target);
 	BITLIB_API int32_t AtomicPostDecrement(int32_t* Target);
+	BITLIB_API int32_t AtomicLoad(const int32_t* Target);
+	BITLIB_API void AtomicStore(int32_t* Target, int32_t Value);
+
+	BITLIB_API void* AtomicExchange(void** Target, void* Value);
+	BITLIB_API void* AtomicCompareExchange(void** Target, void* Value, void* Comperand);
+	BITLIB_API void* AtomicLoad(void* const* Target);
+	BITLIB_API void AtomicStore(void** Target, void* Value);
+
+	/* Full barrier. Orders a store before later loads, which acquire and release don't. */
+	BITLIB_API void AtomicFence();
+
+	/* Acquire load and release store compiled into the caller, for lock-free read paths
+	   where the call to AtomicLoad costs more than the load itself. T is a pointer or a
+	   4 or 8 byte integer. */
+	template<typename T>
+	BIT_FORCEINLINE T AtomicLoadInline(const T* Target)
+	{
+		static_assert(sizeof(T) == sizeof(int32_t) || sizeof(T) == sizeof(int64_t), "Only 4 and 8 byte values can be loaded atomically");
+	#if BIT_PLATFORM_WINDOWS
+		BIT_IF_CONSTEXPR (BIT_PLATFORM_X86 && sizeof(T) == sizeof(int64_t))
+		{
+			// A plain 8 byte load can tear on 32 bit x86
+			int64_t Bits = _InterlockedCompareExchange64((volatile long long*)Target, 0, 0);
+			return *(const T*)&Bits;
+		}
+		else
+		{
+			T Value = *(const volatile T*)Target;
+			_ReadWriteBarrier();
+			return Value;
+		}
+	#else
+		return __atomic_load_n(Target, __ATOMIC_ACQUIRE);
+	#endif
+	}
+
+	template<typename T>
+	BIT_FORCEINLINE void AtomicStoreInline(T* Target, T Value)
+	{
+		static_assert(sizeof(T) == sizeof(int32_t) || sizeof(T) == sizeof(int64_t), "Only 4 and 8 byte values can be stored atomically");
+	#if BIT_PLATFORM_WINDOWS
+		BIT_IF_CONSTEXPR (BIT_PLATFORM_X86 && sizeof(T) == sizeof(int64_t))
+		{
+			long long Bits = *(const long long*)&Value;
+			long long Seen = *(volatile long long*)Target;
+			for (long long Previous; (Previous = _InterlockedCompareExchange64((volatile long long*)Target, Bits, Seen)) != Seen;)
+			{
+				Seen = Previous;
+			}
+		}
+		else
+		{
+			_ReadWriteBarrier();
+			*(volatile T*)Target = Value;
+		}
+	#else
+		__atomic_store_n(Target, Value, __ATOMIC_RELEASE);
+	#endif
+	}
 }
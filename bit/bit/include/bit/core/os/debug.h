@@ -18,11 +18,11 @@ namespace bit
 #define BIT_ASSERT(Condition) if (!(Condition)) { BIT_DEBUG_BREAK(); }
 #else
 #define BIT_ALERT(Fmt, ...)
-#define BIT_ASSERT_MSG(Condition, Fmt, ...) (Condition)
+#define BIT_ASSERT_MSG(Condition, Fmt, ...) ((void)(Condition))
 #define BIT_LOG(Fmt, ...) 
 #define BIT_PANIC_MSG(Fmt, ...) 
 #define BIT_PANIC() 
-#define BIT_ASSERT(Condition) (Condition)
+#define BIT_ASSERT(Condition) ((void)(Condition))
 #endif
 
 #define BIT_ALWAYS_ALERT(Fmt, ...) bit::Alert(Fmt "\n", ##__VA_ARGS__); BIT_DEBUG_BREAK();
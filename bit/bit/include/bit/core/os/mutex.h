@@ -10,6 +10,7 @@ namespace bit
 		~Mutex();
 
 		void Lock();
+		bool TryLock();
 		void Unlock();
 
 	private:
@@ -26,6 +26,18 @@ namespace bit
 		size_t AllocationGranularity;
 	};
 
+	/* Instruction set extensions the memory and string routines dispatch on. All false
+	   on anything that isn't x86. */
+	struct BITLIB_API ProcessorFeatures
+	{
+		bool bSSE2;
+		bool bSSE42;
+		bool bAVX2; // Also requires the OS to save the YMM registers
+		bool bERMS; // Enhanced rep movsb/stosb
+		bool bFSRM; // Fast short rep movsb
+		size_t LastLevelCacheSize; // 0 when unknown
+	};
+
 	BITLIB_API void ExitProgram(int32_t ExitCode);
 	BITLIB_API double GetSeconds();
 	BITLIB_API int32_t GetOSErrorCode();
@@ -35,5 +47,6 @@ namespace bit
 	BITLIB_API void* GetOSMaxAddress();
 	BITLIB_API int32_t GetOSProcessorCount();
 	BITLIB_API ProcessorArch GetOSProcessorArch();
+	BITLIB_API const ProcessorFeatures& GetOSProcessorFeatures();
 	BITLIB_API ProcessMemoryInfo GetOSProcessMemoryInfo();
 }
@@ -7,8 +7,12 @@
 namespace bit
 {
 	typedef uint32_t TlsHandle;
+	typedef void(*TlsDestructor_t)(void* Value);
 
-	BITLIB_API TlsHandle TlsAllocSlot();
+	static constexpr TlsHandle INVALID_TLS_HANDLE = 0xFFFFFFFF;
+
+	/* If a destructor is given it'll be called on thread exit for every thread that has a non null value in the slot */
+	BITLIB_API TlsHandle TlsAllocSlot(TlsDestructor_t Destructor = nullptr);
 	BITLIB_API void TlsFreeSlot(TlsHandle Handle);
 	BITLIB_API void TlsSetValue(TlsHandle Handle, void* Value);
 	BITLIB_API void* TlsGetValue(TlsHandle Handle);
@@ -11,8 +11,20 @@ namespace bit
 		PROTECTION_TYPE_READ_ONLY
 	};
 
+	enum class LargePageType
+	{
+		LARGE_PAGE_TYPE_NONE, /* Regular pages */
+		LARGE_PAGE_TYPE_TRANSPARENT, /* Regular pages the OS may promote to huge pages */
+		LARGE_PAGE_TYPE_2MIB,
+		LARGE_PAGE_TYPE_1GIB
+	};
+
 	struct BITLIB_API VirtualMemoryBlock
 	{
+		/* Below this ZeroPages only streams zeros, the page faults on the next touch
+		   would cost more than the stores */
+		static constexpr size_t ZERO_PAGES_MIN_SIZE = 64 KiB;
+
 		VirtualMemoryBlock();
 		VirtualMemoryBlock(void* BaseAddress, size_t ReservedSize);
 		VirtualMemoryBlock(VirtualMemoryBlock&& Move);
@@ -25,6 +37,13 @@ namespace bit
 		void* CommitPagesByOffset(size_t Offset, size_t Size);
 		bool DecommitPagesByOffset(size_t Offset, size_t Size);
 		bool ProtectPagesByOffset(size_t Offset, size_t Size, PageProtectionType Protection);
+		/* Zero fills committed memory without pulling it into the cache. Whole pages are
+		   handed back to the OS and come back zero filled on the next touch, the partial
+		   pages at the ends are cleared with StreamZero. The range stays committed. Every
+		   page faults again when touched, so this pays off when most of the range won't
+		   be used again soon, otherwise StreamZero is cheaper overall. */
+		bool ZeroPagesByAddress(void* Address, size_t Size);
+		bool ZeroPagesByOffset(size_t Offset, size_t Size);
 		void* GetBaseAddress() const;
 		void* GetAddress(size_t Offset) const;
 		void* GetEndAddress() const;
@@ -47,4 +66,10 @@ namespace bit
 	BITLIB_API bool VirtualAllocateBlock(void* Address, size_t Size, VirtualMemoryBlock& OutVirtualMemorySpace);
 	BITLIB_API bool VirtualAllocateBlock(size_t Size, VirtualMemoryBlock& OutVirtualMemorySpace);
 	BITLIB_API void VirtualFreeBlock(VirtualMemoryBlock& VirtualMemorySpace);
+
+	/* Maps committed memory backed by large pages if the OS allows it, falling back
+	   to regular pages otherwise. OutSize is the mapped size and must be passed to 
+	   VirtualFreeLargePages. */
+	BITLIB_API void* VirtualAllocateLargePages(size_t Size, size_t& OutSize, LargePageType& OutPageType);
+	BITLIB_API void VirtualFreeLargePages(void* Address, size_t Size);
 }
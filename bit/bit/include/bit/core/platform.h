@@ -2,6 +2,8 @@
 
 #if defined(_WIN32) || defined(_WIN64)
 #include <bit/core/platform_windows.h>
+#elif defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+#include <bit/core/platform_posix.h>
 #else
 #include <bit/core/platform_null.h>
 #endif
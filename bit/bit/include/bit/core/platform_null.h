@@ -1,14 +1,21 @@
 #pragma once
 
 #define BIT_PLATFORM_WINDOWS 0
+#define BIT_PLATFORM_POSIX 0
+#define BIT_PLATFORM_LINUX 0
 #define BIT_PLATFORM_X64 0
 #define BIT_PLATFORM_X86 0
+#define BIT_SIMD_SSE2 0
+#define BIT_TARGET_AVX2
 #define BIT_DEBUG_BREAK()
 #define BIT_BUILD_DEBUG 0
 #define BIT_BUILD_RELEASE 0
 #define BITLIB_API
 #define BIT_FORCEINLINE
 #define BIT_FORCENOINLINE
+#define BIT_RETURN_ADDRESS() nullptr
+#define BIT_NO_SANITIZE_ADDRESS
+#define BIT_THREAD_LOCAL
 #define BIT_CPP_VER 0
 #define BIT_CPP17 0
 #define BIT_CPP14 0
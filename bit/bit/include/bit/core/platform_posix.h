@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stddef.h>
+
+#define BIT_PLATFORM_WINDOWS 0
+#define BIT_PLATFORM_POSIX 1
+
+#if defined(__linux__)
+#define BIT_PLATFORM_LINUX 1
+#else
+#define BIT_PLATFORM_LINUX 0
+#endif
+
+#if defined(__x86_64__) || defined(__aarch64__)
+#define BIT_PLATFORM_X64 1
+#define BIT_PLATFORM_X86 0
+#define BIT_INVALID_ADDRESS ((void*)0xDEADBEEFDEADBEEF)
+#else
+#define BIT_PLATFORM_X64 0
+#define BIT_PLATFORM_X86 1
+#define BIT_INVALID_ADDRESS ((void*)0xDEADBEEF)
+#endif
+
+#if defined(__SSE2__)
+#define BIT_SIMD_SSE2 1
+#define BIT_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define BIT_SIMD_SSE2 0
+#define BIT_TARGET_AVX2
+#endif
+
+#define BIT_DEBUG_BREAK() __builtin_trap()
+
+#if defined(_DEBUG) || !defined(NDEBUG)
+#define BIT_BUILD_DEBUG 1
+#define BIT_BUILD_RELEASE 0
+#else
+#define BIT_BUILD_DEBUG 0
+#define BIT_BUILD_RELEASE 1
+#endif
+
+#ifndef BIT_STATIC_LIB
+#define BITLIB_API __attribute__((visibility("default")))
+#define BITLIB_API_TEMPLATE_CLASS template class BITLIB_API
+#define BITLIB_API_TEMPLATE_STRUCT template struct BITLIB_API
+#else
+#define BITLIB_API
+#define BITLIB_API_TEMPLATE_CLASS template class
+#define BITLIB_API_TEMPLATE_STRUCT template struct
+#endif
+
+#define BIT_FORCEINLINE inline __attribute__((always_inline))
+#define BIT_FORCENOINLINE __attribute__((noinline))
+#define BIT_ALIGN(N) __attribute__((aligned(N)))
+#define BIT_RESTRICT __restrict__
+#define BIT_DEPRECATED(Info) __attribute__((deprecated(Info)))
+#define BIT_ALLOCATOR __attribute__((malloc))
+#define BIT_RETURN_ADDRESS() __builtin_return_address(0)
+#define BIT_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+// Initial exec skips the __tls_get_addr call a shared library pays for every thread_local access
+#define BIT_THREAD_LOCAL thread_local __attribute__((tls_model("initial-exec")))
+
+#if defined(__cplusplus) && __cplusplus >= 201103L
+#define BIT_CPP_VER __cplusplus
+#define BIT_CPP17 201703L
+#define BIT_CPP14 201402L
+#define BIT_CPP11 201103L
+#else
+#error "This is a C++ library. Requires > C++11."
+#endif
+
+#if BIT_CPP_VER >= BIT_CPP17
+#define BIT_IF_CONSTEXPR if constexpr
+#else
+#define BIT_IF_CONSTEXPR if
+#endif
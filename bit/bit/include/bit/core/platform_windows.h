@@ -1,6 +1,8 @@
 #pragma once
 
 #define BIT_PLATFORM_WINDOWS 1
+#define BIT_PLATFORM_POSIX 0
+#define BIT_PLATFORM_LINUX 0
 
 #if defined(_WIN64) && _WIN64
 #define BIT_PLATFORM_X64 1
@@ -12,6 +14,13 @@
 #define BIT_INVALID_ADDRESS ((void*)0xDEADBEEF)
 #endif
 
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BIT_SIMD_SSE2 1
+#else
+#define BIT_SIMD_SSE2 0
+#endif
+#define BIT_TARGET_AVX2 /* MSVC allows AVX2 intrinsics in any function */
+
 #define BIT_DEBUG_BREAK() __debugbreak()
 
 #if _DEBUG
@@ -41,6 +50,12 @@
 #define BIT_RESTRICT __declspec(restrict)
 #define BIT_DEPRECATED(Info) __declspec(deprecated(Info))
 #define BIT_ALLOCATOR __declspec(allocator)
+#define BIT_NO_SANITIZE_ADDRESS __declspec(no_sanitize_address)
+#define BIT_THREAD_LOCAL thread_local
+
+extern "C" void* _ReturnAddress(void);
+#pragma intrinsic(_ReturnAddress)
+#define BIT_RETURN_ADDRESS() _ReturnAddress()
 
 #if defined(__cplusplus) && __cplusplus >= 201103L
 #define BIT_CPP_VER __cplusplus
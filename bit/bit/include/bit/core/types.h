@@ -2,7 +2,12 @@
 
 #include <bit/core/platform.h>
 
-#ifndef _STDINT
+#if BIT_PLATFORM_POSIX
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/types.h>
+typedef size_t usize_t;
+#elif !defined(_STDINT)
 typedef signed char        int8_t;
 typedef short              int16_t;
 typedef int                int32_t;
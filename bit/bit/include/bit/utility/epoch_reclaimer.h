@@ -0,0 +1,74 @@
+#pragma once
+
+#include <bit/core/types.h>
+#include <bit/core/os/mutex.h>
+#include <bit/utility/utility.h>
+
+namespace bit
+{
+	struct IAllocator;
+
+	/* Epoch based reclamation for lock-free readers. Readers announce the global epoch
+	   in a reader slot while they touch shared data. Writers unlink data first and
+	   retire it, and it's only freed once every reader that could still see it has
+	   left. The epoch only advances when all active readers announced the current one,
+	   so anything retired two epochs ago is unreachable. */
+	struct BITLIB_API EpochReclaimer : public NonCopyable
+	{
+		typedef void(*Deleter_t)(void* Context, void* Pointer);
+
+		static constexpr int32_t READER_SLOT_COUNT = 64;
+		static constexpr int32_t LEASED_SLOT_COUNT = 48; // Slots owned by one thread each, the rest are shared
+		static constexpr int64_t COLLECT_INTERVAL = 64; // Retired pointers between automatic collections
+
+		EpochReclaimer(IAllocator& Allocator);
+		/* Frees everything still retired. There can't be any readers left. */
+		~EpochReclaimer();
+		/* Returns the reader slot to pass to Exit. A thread leases the same slot index in every
+		   reclaimer for its lifetime and enters through it with a store and a fence. Nested
+		   readers and threads without a lease take a shared slot and spin if every one is taken. */
+		int32_t Enter();
+		void Exit(int32_t Slot);
+		void Retire(void* Pointer, Deleter_t Deleter, void* Context);
+		/* Frees retired pointers no reader can reach anymore and returns how many were freed */
+		size_t Collect();
+		/* Frees every retired pointer. Only valid when no reader is active. */
+		void Clear();
+
+	private:
+		struct BIT_ALIGN(64) ReaderSlot
+		{
+			int64_t State; // (Epoch << 1) | 1 while a reader is inside, 0 when free
+		};
+
+		struct RetiredPointer
+		{
+			void* Pointer;
+			Deleter_t Deleter;
+			void* Context;
+			int64_t Epoch;
+		};
+
+		bool TryAdvance();
+		size_t FreeRetired(int64_t MaxEpoch);
+
+		ReaderSlot Slots[READER_SLOT_COUNT];
+		int64_t GlobalEpoch;
+		Mutex RetireLock;
+		RetiredPointer* Retired;
+		int64_t RetiredCount;
+		int64_t RetiredCapacity;
+		int64_t RetiresSinceCollect;
+		IAllocator* Allocator;
+	};
+
+	struct BITLIB_API EpochGuard
+	{
+		EpochGuard(EpochReclaimer& InReclaimer) : Reclaimer(InReclaimer), Slot(InReclaimer.Enter()) {}
+		~EpochGuard() { Reclaimer.Exit(Slot); }
+
+	private:
+		EpochReclaimer& Reclaimer;
+		int32_t Slot;
+	};
+}
@@ -1,16 +1,62 @@
 #pragma once
 
 #include <bit/utility/murmur_hash.h>
+#include <bit/utility/wy_hash.h>
 
 namespace bit
 {
+	/* Hashes the bytes of the value. Integers and pointers have their own mixers below. */
 	template<typename T>
 	struct Hash
 	{
 		typedef size_t HashType_t;
 		HashType_t operator()(const T& Value) const
 		{
-			return bit::MurmurHash(&Value, sizeof(T), bit::DEFAULT_HASH_SEED);
+			return bit::WyHash(&Value, sizeof(T), bit::DEFAULT_HASH_SEED);
 		}
 	};
+
+	template<typename T>
+	struct Hash<T*>
+	{
+		typedef size_t HashType_t;
+		HashType_t operator()(const T* Value) const
+		{
+			return bit::HashInteger((uint64_t)(uintptr_t)Value);
+		}
+	};
+
+	/* What HashTable converts a lookup key to before it hashes and probes with it. The key
+	   is used as is unless comparing it against every probed slot would repeat work. */
+	template<typename TKey, typename TLookupKey>
+	struct HashLookupKey
+	{
+		typedef const TLookupKey& Type;
+	};
+
+#define BIT_INTEGER_HASH(Type) \
+	template<> \
+	struct Hash<Type> \
+	{ \
+		typedef size_t HashType_t; \
+		HashType_t operator()(Type Value) const { return bit::HashInteger((uint64_t)Value); } \
+	}
+
+	BIT_INTEGER_HASH(bool);
+	BIT_INTEGER_HASH(char);
+	BIT_INTEGER_HASH(signed char);
+	BIT_INTEGER_HASH(unsigned char);
+	BIT_INTEGER_HASH(wchar_t);
+	BIT_INTEGER_HASH(char16_t);
+	BIT_INTEGER_HASH(char32_t);
+	BIT_INTEGER_HASH(short);
+	BIT_INTEGER_HASH(unsigned short);
+	BIT_INTEGER_HASH(int);
+	BIT_INTEGER_HASH(unsigned int);
+	BIT_INTEGER_HASH(long);
+	BIT_INTEGER_HASH(unsigned long);
+	BIT_INTEGER_HASH(long long);
+	BIT_INTEGER_HASH(unsigned long long);
+
+#undef BIT_INTEGER_HASH
 }
@@ -191,13 +191,16 @@ namespace bit
 		UniquePtr(const SelfType&) = delete;
 		UniquePtr operator=(const SelfType&) = delete;
 
-		template<typename T>
+		template<typename TOther>
 		friend struct TSharedPtr;
 
 		TDeleter Deleter;
 		T* Ptr;
 	};
 
+	template<typename T, typename TDeleter>
+	struct IsTriviallyRelocatable<UniquePtr<T, TDeleter>> : public ConstValue<bool, IsTriviallyRelocatable<TDeleter>::Value> {};
+
 	template<typename T>
 	struct TWeakPtr;
 	
@@ -302,7 +305,7 @@ namespace bit
 		BIT_FORCEINLINE T* Get() { return IsValid() ? CtrlBlock->Ptr : nullptr; }
 
 	private:
-		template<typename T>
+		template<typename TOther>
 		friend struct TWeakPtr;
 
 		TSharedPtr(ControlBlockBaseType_t* OtherControlBlock)
@@ -41,6 +41,15 @@ namespace bit
 	template<typename T> struct IsLValueRef : public ConstValue<bool, false> {};
 	template<typename T> struct IsLValueRef<T&> : public ConstValue<bool, true> {};
 
+	template<typename T> struct IsTriviallyCopyable : public ConstValue<bool, __is_trivially_copyable(T)> {};
+	template<typename T> struct IsCopyConstructible : public ConstValue<bool, __is_constructible(T, const T&)> {};
+
+	/* Types that can be moved to a new address with a plain memory copy, leaving nothing
+	   to destroy at the old one. Containers relocate these with Realloc and Memmove instead
+	   of a move construct and destroy per element. Specialize it for types that own
+	   resources but don't point into themselves, like UniquePtr. */
+	template<typename T> struct IsTriviallyRelocatable : public ConstValue<bool, IsTriviallyCopyable<T>::Value> {};
+
 	template <typename T>
 	typename RemoveRef<T>::Type&& Move(T&& Arg) noexcept
 	{
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <bit/core/types.h>
+
+#if BIT_PLATFORM_WINDOWS && BIT_PLATFORM_X64
+#include <intrin.h>
+#endif
+
+namespace bit
+{
+	/* Folds the 128-bit product of A and B into 64 bits. Every input bit can
+	   reach every output bit, which is what makes a single multiply a good mixer. */
+	BIT_FORCEINLINE uint64_t MultiplyFold(uint64_t A, uint64_t B)
+	{
+	#if defined(__SIZEOF_INT128__)
+		__uint128_t Product = (__uint128_t)A * B;
+		return (uint64_t)Product ^ (uint64_t)(Product >> 64);
+	#elif BIT_PLATFORM_WINDOWS && BIT_PLATFORM_X64
+		uint64_t High = 0;
+		uint64_t Low = _umul128(A, B, &High);
+		return Low ^ High;
+	#else
+		uint64_t LowLow = (A & 0xFFFFFFFF) * (B & 0xFFFFFFFF);
+		uint64_t LowHigh = (A & 0xFFFFFFFF) * (B >> 32);
+		uint64_t HighLow = (A >> 32) * (B & 0xFFFFFFFF);
+		uint64_t HighHigh = (A >> 32) * (B >> 32);
+		uint64_t Middle = (LowLow >> 32) + (LowHigh & 0xFFFFFFFF) + (HighLow & 0xFFFFFFFF);
+		uint64_t Low = (Middle << 32) | (LowLow & 0xFFFFFFFF);
+		uint64_t High = HighHigh + (LowHigh >> 32) + (HighLow >> 32) + (Middle >> 32);
+		return Low ^ High;
+	#endif
+	}
+
+	/* Mixer for integer and pointer keys, one multiply */
+	BIT_FORCEINLINE size_t HashInteger(uint64_t Value)
+	{
+		return (size_t)MultiplyFold(Value ^ 0x2D358DCCAA6C78A5ULL, 0x8BB84B93962EACC9ULL);
+	}
+
+	/* wyhash (final version 4) by Wang Yi. Reads 48 bytes per step in three
+	   independent lanes so long inputs aren't bound by multiply latency. */
+	BITLIB_API size_t WyHash(const void* Key, size_t Len, size_t Seed);
+
+	/* WyHash fed piece by piece. Any split of the same bytes over Update calls gives
+	   the same result as a single WyHash call with the same seed. Large updates are
+	   hashed in place, only the last stripe is buffered. */
+	struct BITLIB_API WyHasher
+	{
+		static constexpr size_t STRIPE_SIZE = 48;
+		static constexpr size_t HISTORY_SIZE = 16;
+
+		WyHasher(size_t Seed);
+		void Init(size_t Seed);
+		void Update(const void* Data, size_t Len);
+		/* Doesn't change the state, more data can still be added afterwards */
+		size_t Final() const;
+
+	private:
+		void ConsumeStripe(const uint8_t* Stripe);
+
+		uint64_t Seed;
+		uint64_t State;
+		uint64_t Lanes[2];
+		size_t TotalLength;
+		size_t PendingLength;
+		uint8_t History[HISTORY_SIZE]; // Last bytes before Pending, the final read can reach back into them
+		uint8_t Pending[STRIPE_SIZE]; // A stripe is only consumed once it's known that more data follows
+	};
+}
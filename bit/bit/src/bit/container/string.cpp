@@ -16,6 +16,10 @@ bit::String::String(const CharType_t * RawStr, SizeType_t Len)
 	Copy(RawStr, Len);
 }
 
+bit::String::String(const StringView& View) :
+	String(*View, View.GetLength())
+{}
+
 bit::String::String(const String& Other)
 {
 	Storage.Add(Other.Storage);
@@ -33,6 +37,20 @@ bit::SizeType_t bit::String::GetLength() const
 	return 0;
 }
 
+bool bit::String::Contains(const StringView& SubStr, SizeType_t* Offset) const
+{
+	size_t FoundOffset = 0;
+	if (bit::StrFind(**this, GetLength(), *SubStr, SubStr.GetLength(), &FoundOffset))
+	{
+		if (Offset != nullptr)
+		{
+			*Offset = (SizeType_t)FoundOffset;
+		}
+		return true;
+	}
+	return false;
+}
+
 void bit::String::Copy(const CharType_t* RawStr, SizeType_t Len)
 {
 	Storage.Clear();
@@ -56,7 +74,7 @@ void bit::String::Append(const CharType_t* RawStr, SizeType_t Len)
 void bit::String::Append(const String& Other)
 {
 	Storage.PopLast();
-	Storage.Add(Other.Storage);
+	Storage.Append(*Other, Other.GetLength());
 	Storage.AddEmpty();
 }
 
@@ -68,12 +86,23 @@ bit::StringStorage_t& bit::String::GetStorage()
 /*static*/ bit::String bit::String::Format(const CharType_t* Fmt, ...)
 {
 	char Buffer[1024];
-	String Output;
 	va_list VaList;
+	va_list VaListCopy;
 	va_start(VaList, Fmt);
-	int32_t WriteSize = vsprintf_s(Buffer, 1024, Fmt, VaList);
+	va_copy(VaListCopy, VaList);
+	int32_t WriteSize = vsnprintf(Buffer, sizeof(Buffer), Fmt, VaList);
 	va_end(VaList);
-	return String(Buffer, WriteSize);
+	if (WriteSize < (int32_t)sizeof(Buffer))
+	{
+		va_end(VaListCopy);
+		return String(Buffer, bit::Max(WriteSize, 0));
+	}
+	// Too long for the stack buffer, format again straight into the storage
+	String Output;
+	Output.Storage.SetCountUninitialized(WriteSize + 1);
+	vsnprintf(Output.Storage.GetData(), (size_t)WriteSize + 1, Fmt, VaListCopy);
+	va_end(VaListCopy);
+	return Output;
 }
 
 const bit::CharType_t* bit::String::operator*() const
@@ -121,6 +150,41 @@ bool bit::operator!=(const String& LHS, const String& RHS)
 	return !(LHS == RHS);
 }
 
+bool bit::operator==(const String& LHS, const StringView& RHS)
+{
+	return LHS.GetLength() == RHS.GetLength() && bit::Memcmp(*LHS, *RHS, LHS.GetLength());
+}
+
+bool bit::operator==(const StringView& LHS, const String& RHS)
+{
+	return RHS == LHS;
+}
+
+bool bit::operator==(const String& LHS, const CharType_t* RHS)
+{
+	return LHS == StringView(RHS);
+}
+
+bool bit::operator!=(const String& LHS, const StringView& RHS)
+{
+	return !(LHS == RHS);
+}
+
+bool bit::operator!=(const StringView& LHS, const String& RHS)
+{
+	return !(RHS == LHS);
+}
+
+bool bit::operator!=(const String& LHS, const CharType_t* RHS)
+{
+	return !(LHS == RHS);
+}
+
+bit::StringView::StringView(const String& Str) :
+	Data(*Str),
+	Length(Str.GetLength())
+{}
+
 BITLIB_API bit::String bit::FormatSize(size_t Size)
 {
 	if (Size >= 1 KiB && Size < 1 MiB) return String::Format("%.3lf KiB", FromKiB(Size));
@@ -1,4 +1,5 @@
 #include <bit/core/memory.h>
+#include <bit/core/memory/system/memory_manager.h>
 #include <bit/core/os/debug.h>
 
 double bit::FromKiB(size_t Value) { return (double)Value / 1024.0; }
@@ -8,7 +9,7 @@ double bit::FromTiB(size_t Value) { return FromGiB(Value) / 1024.0; }
 
 void* bit::Malloc(size_t Size, size_t Alignment)
 {
-	return GetGlobalAllocator().Allocate(Size, Alignment);
+	return static_cast<MemoryManager&>(GetGlobalAllocator()).TracedAllocate(Size, Alignment, BIT_RETURN_ADDRESS());
 }
 
 void* bit::Realloc(void* Pointer, size_t Size, size_t Alignment)
@@ -32,15 +33,12 @@ void* bit::Realloc(void* Pointer, size_t Size, size_t Alignment)
 	{
 		return Pointer;
 	}
-	void* NewBlock = Malloc(Size, Alignment);
-	Memcpy(NewBlock, Pointer, Min(Size, OldSize));
-	Free(Pointer);
-	return NewBlock;
+	return static_cast<MemoryManager&>(GetGlobalAllocator()).TracedReallocate(Pointer, Size, Alignment, BIT_RETURN_ADDRESS());
 }
 
 void bit::Free(void* Pointer)
 {
-	return GetGlobalAllocator().Free(Pointer);
+	static_cast<MemoryManager&>(GetGlobalAllocator()).TracedFree(Pointer, BIT_RETURN_ADDRESS());
 }
 
 size_t bit::CompactMemory()
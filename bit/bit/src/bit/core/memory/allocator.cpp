@@ -11,6 +11,23 @@ bit::IAllocator::IAllocator(const char* InName)
 #endif
 }
 
+void* bit::IAllocator::Reallocate(void* Pointer, size_t Size, size_t Alignment)
+{
+	if (Pointer == nullptr) return Allocate(Size, Alignment);
+	size_t BlockSize = GetSize(Pointer);
+	void* NewBlock = Allocate(Size, Alignment);
+	if (NewBlock != nullptr)
+	{
+		bit::Memcpy(NewBlock, Pointer, bit::Min(BlockSize, Size));
+		Free(Pointer);
+	}
+	return NewBlock;
+}
+
+bool bit::IAllocator::ResizeInPlace(void* Pointer, size_t Size)
+{
+	return Pointer != nullptr && GetSize(Pointer) >= Size;
+}
 
 bit::MemoryArena::~MemoryArena()
 {
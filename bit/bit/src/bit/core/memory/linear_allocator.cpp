@@ -38,6 +38,12 @@ void bit::LinearAllocator::Reset()
 	BufferOffset = 0;
 }
 
+void bit::LinearAllocator::ResetAndZero()
+{
+	bit::StreamZero(Arena.GetBaseAddress(), BufferOffset);
+	BufferOffset = 0;
+}
+
 void* bit::LinearAllocator::Allocate(size_t Size, size_t Alignment)
 {
 	uint8_t* BufferCurr = (uint8_t*)bit::OffsetPtr(Arena.GetBaseAddress(), BufferOffset);
@@ -0,0 +1,476 @@
+#include <bit/core/memory/memory_ops.h>
+#include <bit/core/os/os.h>
+#include <bit/core/os/atomics.h>
+#include <bit/utility/utility.h>
+
+#if BIT_SIMD_SSE2
+#include <immintrin.h>
+#if BIT_PLATFORM_WINDOWS
+#include <intrin.h>
+#endif
+#endif
+
+/* rep movsb/stosb only overtakes the AVX2 loop after a few KiB even with ERMS, the
+   MemoryOps benchmark shows where */
+static constexpr size_t REP_MOVSB_MIN_SIZE = 4096;
+/* Copies larger than about half the last level cache would only evict data the caller
+   still needs, so they bypass the cache. Used when the cache size is unknown. */
+static constexpr size_t DEFAULT_NON_TEMPORAL_MIN_SIZE = 4 MiB;
+
+typedef void* (*CopyFunc_t)(void* Dst, const void* Src, size_t Num);
+typedef void* (*SetFunc_t)(void* Ptr, uint8_t Value, size_t Num);
+typedef bool (*CompareFunc_t)(const void* A, const void* B, size_t Num);
+
+static void* BitResolveCopy(void* Dst, const void* Src, size_t Num);
+static void* BitResolveSet(void* Ptr, uint8_t Value, size_t Num);
+static bool BitResolveCompare(const void* A, const void* B, size_t Num);
+
+/* Start at the resolvers so calls made during static initialization still work. Whichever
+   thread calls first resolves, so these only go through the inline atomics, which are
+   plain movs on x86. */
+static CopyFunc_t GCopyBulk = &BitResolveCopy;
+static SetFunc_t GSetBulk = &BitResolveSet;
+static CompareFunc_t GCompareBulk = &BitResolveCompare;
+static size_t GNonTemporalMinSize = DEFAULT_NON_TEMPORAL_MIN_SIZE;
+/* REP_MOVSB_MIN_SIZE when the CPU has ERMS, never otherwise */
+static size_t GRepMovsbMinSize = SIZE_MAX;
+
+#if BIT_SIMD_SSE2
+
+static BIT_FORCEINLINE void BitRepMovsb(uint8_t* Dst, const uint8_t* Src, size_t Num)
+{
+#if BIT_PLATFORM_WINDOWS
+	__movsb(Dst, Src, Num);
+#else
+	__asm__ volatile("rep movsb" : "+D"(Dst), "+S"(Src), "+c"(Num) : : "memory");
+#endif
+}
+
+static BIT_FORCEINLINE void BitRepStosb(uint8_t* Dst, uint8_t Value, size_t Num)
+{
+#if BIT_PLATFORM_WINDOWS
+	__stosb(Dst, Value, Num);
+#else
+	__asm__ volatile("rep stosb" : "+D"(Dst), "+c"(Num) : "a"(Value) : "memory");
+#endif
+}
+
+/* Num > 64. The first and last 64 bytes are loaded up front and written unaligned,
+   the middle is written with aligned stores. Streamed stores skip the cache. */
+template<bool bStream>
+static void BitCopySSE2(uint8_t* Dst, const uint8_t* Src, size_t Num)
+{
+	uint8_t* End = Dst + Num;
+	__m128i Head = _mm_loadu_si128((const __m128i*)Src);
+	__m128i Tail0 = _mm_loadu_si128((const __m128i*)(Src + Num - 64));
+	__m128i Tail1 = _mm_loadu_si128((const __m128i*)(Src + Num - 48));
+	__m128i Tail2 = _mm_loadu_si128((const __m128i*)(Src + Num - 32));
+	__m128i Tail3 = _mm_loadu_si128((const __m128i*)(Src + Num - 16));
+	_mm_storeu_si128((__m128i*)Dst, Head);
+	size_t Skip = 16 - ((uintptr_t)Dst & 15);
+	Dst += Skip;
+	Src += Skip;
+	Num -= Skip;
+	while (Num > 64)
+	{
+		__m128i A = _mm_loadu_si128((const __m128i*)Src);
+		__m128i B = _mm_loadu_si128((const __m128i*)(Src + 16));
+		__m128i C = _mm_loadu_si128((const __m128i*)(Src + 32));
+		__m128i D = _mm_loadu_si128((const __m128i*)(Src + 48));
+		if (bStream)
+		{
+			_mm_stream_si128((__m128i*)Dst, A);
+			_mm_stream_si128((__m128i*)(Dst + 16), B);
+			_mm_stream_si128((__m128i*)(Dst + 32), C);
+			_mm_stream_si128((__m128i*)(Dst + 48), D);
+		}
+		else
+		{
+			_mm_store_si128((__m128i*)Dst, A);
+			_mm_store_si128((__m128i*)(Dst + 16), B);
+			_mm_store_si128((__m128i*)(Dst + 32), C);
+			_mm_store_si128((__m128i*)(Dst + 48), D);
+		}
+		Dst += 64;
+		Src += 64;
+		Num -= 64;
+	}
+	if (bStream) _mm_sfence();
+	_mm_storeu_si128((__m128i*)(End - 64), Tail0);
+	_mm_storeu_si128((__m128i*)(End - 48), Tail1);
+	_mm_storeu_si128((__m128i*)(End - 32), Tail2);
+	_mm_storeu_si128((__m128i*)(End - 16), Tail3);
+}
+
+template<bool bStream>
+static void BitSetSSE2(uint8_t* Dst, uint8_t Value, size_t Num)
+{
+	uint8_t* End = Dst + Num;
+	__m128i Fill = _mm_set1_epi8((char)Value);
+	_mm_storeu_si128((__m128i*)Dst, Fill);
+	size_t Skip = 16 - ((uintptr_t)Dst & 15);
+	Dst += Skip;
+	Num -= Skip;
+	while (Num > 64)
+	{
+		if (bStream)
+		{
+			_mm_stream_si128((__m128i*)Dst, Fill);
+			_mm_stream_si128((__m128i*)(Dst + 16), Fill);
+			_mm_stream_si128((__m128i*)(Dst + 32), Fill);
+			_mm_stream_si128((__m128i*)(Dst + 48), Fill);
+		}
+		else
+		{
+			_mm_store_si128((__m128i*)Dst, Fill);
+			_mm_store_si128((__m128i*)(Dst + 16), Fill);
+			_mm_store_si128((__m128i*)(Dst + 32), Fill);
+			_mm_store_si128((__m128i*)(Dst + 48), Fill);
+		}
+		Dst += 64;
+		Num -= 64;
+	}
+	if (bStream) _mm_sfence();
+	_mm_storeu_si128((__m128i*)(End - 64), Fill);
+	_mm_storeu_si128((__m128i*)(End - 48), Fill);
+	_mm_storeu_si128((__m128i*)(End - 32), Fill);
+	_mm_storeu_si128((__m128i*)(End - 16), Fill);
+}
+
+static bool BitCompareSSE2(const uint8_t* A, const uint8_t* B, size_t Num)
+{
+	const uint8_t* EndA = A + Num;
+	const uint8_t* EndB = B + Num;
+	while (Num > 64)
+	{
+		__m128i Equal = _mm_and_si128(
+			_mm_and_si128(
+				_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)A), _mm_loadu_si128((const __m128i*)B)),
+				_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(A + 16)), _mm_loadu_si128((const __m128i*)(B + 16)))),
+			_mm_and_si128(
+				_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(A + 32)), _mm_loadu_si128((const __m128i*)(B + 32))),
+				_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(A + 48)), _mm_loadu_si128((const __m128i*)(B + 48)))));
+		if (_mm_movemask_epi8(Equal) != 0xFFFF) return false;
+		A += 64;
+		B += 64;
+		Num -= 64;
+	}
+	return bit::CompareInline(EndA - 64, EndB - 64, 64);
+}
+
+static BIT_TARGET_AVX2 void BitCopyAVX2(uint8_t* Dst, const uint8_t* Src, size_t Num)
+{
+	uint8_t* End = Dst + Num;
+	if (Num <= 128)
+	{
+		__m256i A = _mm256_loadu_si256((const __m256i*)Src);
+		__m256i B = _mm256_loadu_si256((const __m256i*)(Src + 32));
+		__m256i C = _mm256_loadu_si256((const __m256i*)(Src + Num - 64));
+		__m256i D = _mm256_loadu_si256((const __m256i*)(Src + Num - 32));
+		_mm256_storeu_si256((__m256i*)Dst, A);
+		_mm256_storeu_si256((__m256i*)(Dst + 32), B);
+		_mm256_storeu_si256((__m256i*)(End - 64), C);
+		_mm256_storeu_si256((__m256i*)(End - 32), D);
+		return;
+	}
+	__m256i Head = _mm256_loadu_si256((const __m256i*)Src);
+	__m256i Tail0 = _mm256_loadu_si256((const __m256i*)(Src + Num - 128));
+	__m256i Tail1 = _mm256_loadu_si256((const __m256i*)(Src + Num - 96));
+	__m256i Tail2 = _mm256_loadu_si256((const __m256i*)(Src + Num - 64));
+	__m256i Tail3 = _mm256_loadu_si256((const __m256i*)(Src + Num - 32));
+	_mm256_storeu_si256((__m256i*)Dst, Head);
+	size_t Skip = 32 - ((uintptr_t)Dst & 31);
+	Dst += Skip;
+	Src += Skip;
+	Num -= Skip;
+	while (Num > 128)
+	{
+		__m256i A = _mm256_loadu_si256((const __m256i*)Src);
+		__m256i B = _mm256_loadu_si256((const __m256i*)(Src + 32));
+		__m256i C = _mm256_loadu_si256((const __m256i*)(Src + 64));
+		__m256i D = _mm256_loadu_si256((const __m256i*)(Src + 96));
+		_mm256_store_si256((__m256i*)Dst, A);
+		_mm256_store_si256((__m256i*)(Dst + 32), B);
+		_mm256_store_si256((__m256i*)(Dst + 64), C);
+		_mm256_store_si256((__m256i*)(Dst + 96), D);
+		Dst += 128;
+		Src += 128;
+		Num -= 128;
+	}
+	_mm256_storeu_si256((__m256i*)(End - 128), Tail0);
+	_mm256_storeu_si256((__m256i*)(End - 96), Tail1);
+	_mm256_storeu_si256((__m256i*)(End - 64), Tail2);
+	_mm256_storeu_si256((__m256i*)(End - 32), Tail3);
+}
+
+static BIT_TARGET_AVX2 void BitSetAVX2(uint8_t* Dst, uint8_t Value, size_t Num)
+{
+	uint8_t* End = Dst + Num;
+	__m256i Fill = _mm256_set1_epi8((char)Value);
+	_mm256_storeu_si256((__m256i*)Dst, Fill);
+	_mm256_storeu_si256((__m256i*)(End - 32), Fill);
+	if (Num <= 128)
+	{
+		_mm256_storeu_si256((__m256i*)(Dst + 32), Fill);
+		_mm256_storeu_si256((__m256i*)(End - 64), Fill);
+		return;
+	}
+	size_t Skip = 32 - ((uintptr_t)Dst & 31);
+	Dst += Skip;
+	Num -= Skip;
+	while (Num > 128)
+	{
+		_mm256_store_si256((__m256i*)Dst, Fill);
+		_mm256_store_si256((__m256i*)(Dst + 32), Fill);
+		_mm256_store_si256((__m256i*)(Dst + 64), Fill);
+		_mm256_store_si256((__m256i*)(Dst + 96), Fill);
+		Dst += 128;
+		Num -= 128;
+	}
+	_mm256_storeu_si256((__m256i*)(End - 128), Fill);
+	_mm256_storeu_si256((__m256i*)(End - 96), Fill);
+	_mm256_storeu_si256((__m256i*)(End - 64), Fill);
+}
+
+static BIT_TARGET_AVX2 BIT_FORCEINLINE __m256i BitEqualAVX2(const uint8_t* A, const uint8_t* B)
+{
+	return _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)A), _mm256_loadu_si256((const __m256i*)B));
+}
+
+static BIT_TARGET_AVX2 bool BitCompareAVX2(const void* InA, const void* InB, size_t Num)
+{
+	const uint8_t* A = (const uint8_t*)InA;
+	const uint8_t* B = (const uint8_t*)InB;
+	const uint8_t* EndA = A + Num;
+	const uint8_t* EndB = B + Num;
+	if (Num <= 128)
+	{
+		__m256i Equal = _mm256_and_si256(
+			_mm256_and_si256(BitEqualAVX2(A, B), BitEqualAVX2(A + 32, B + 32)),
+			_mm256_and_si256(BitEqualAVX2(EndA - 64, EndB - 64), BitEqualAVX2(EndA - 32, EndB - 32)));
+		return (uint32_t)_mm256_movemask_epi8(Equal) == 0xFFFFFFFF;
+	}
+	// Check the head and align A so only the loads from B can split a cache line
+	if ((uint32_t)_mm256_movemask_epi8(BitEqualAVX2(A, B)) != 0xFFFFFFFF) return false;
+	size_t Skip = 32 - ((uintptr_t)A & 31);
+	A += Skip;
+	B += Skip;
+	Num -= Skip;
+	while (Num > 128)
+	{
+		__m256i Equal = _mm256_and_si256(
+			_mm256_and_si256(BitEqualAVX2(A, B), BitEqualAVX2(A + 32, B + 32)),
+			_mm256_and_si256(BitEqualAVX2(A + 64, B + 64), BitEqualAVX2(A + 96, B + 96)));
+		if ((uint32_t)_mm256_movemask_epi8(Equal) != 0xFFFFFFFF) return false;
+		A += 128;
+		B += 128;
+		Num -= 128;
+	}
+	__m256i Equal = _mm256_and_si256(
+		_mm256_and_si256(BitEqualAVX2(EndA - 128, EndB - 128), BitEqualAVX2(EndA - 96, EndB - 96)),
+		_mm256_and_si256(BitEqualAVX2(EndA - 64, EndB - 64), BitEqualAVX2(EndA - 32, EndB - 32)));
+	return (uint32_t)_mm256_movemask_epi8(Equal) == 0xFFFFFFFF;
+}
+
+static void* BitMemcpySSE2(void* Dst, const void* Src, size_t Num)
+{
+	if (Num >= bit::AtomicLoadInline(&GNonTemporalMinSize)) BitCopySSE2<true>((uint8_t*)Dst, (const uint8_t*)Src, Num);
+	else if (Num >= bit::AtomicLoadInline(&GRepMovsbMinSize)) BitRepMovsb((uint8_t*)Dst, (const uint8_t*)Src, Num);
+	else BitCopySSE2<false>((uint8_t*)Dst, (const uint8_t*)Src, Num);
+	return Dst;
+}
+
+static void* BitMemcpyAVX2(void* Dst, const void* Src, size_t Num)
+{
+	if (Num >= bit::AtomicLoadInline(&GNonTemporalMinSize)) BitCopySSE2<true>((uint8_t*)Dst, (const uint8_t*)Src, Num);
+	else if (Num >= bit::AtomicLoadInline(&GRepMovsbMinSize)) BitRepMovsb((uint8_t*)Dst, (const uint8_t*)Src, Num);
+	else BitCopyAVX2((uint8_t*)Dst, (const uint8_t*)Src, Num);
+	return Dst;
+}
+
+static void* BitMemsetSSE2(void* Ptr, uint8_t Value, size_t Num)
+{
+	if (Num >= bit::AtomicLoadInline(&GNonTemporalMinSize)) BitSetSSE2<true>((uint8_t*)Ptr, Value, Num);
+	else if (Num >= bit::AtomicLoadInline(&GRepMovsbMinSize)) BitRepStosb((uint8_t*)Ptr, Value, Num);
+	else BitSetSSE2<false>((uint8_t*)Ptr, Value, Num);
+	return Ptr;
+}
+
+static void* BitMemsetAVX2(void* Ptr, uint8_t Value, size_t Num)
+{
+	if (Num >= bit::AtomicLoadInline(&GNonTemporalMinSize)) BitSetSSE2<true>((uint8_t*)Ptr, Value, Num);
+	else if (Num >= bit::AtomicLoadInline(&GRepMovsbMinSize)) BitRepStosb((uint8_t*)Ptr, Value, Num);
+	else BitSetAVX2((uint8_t*)Ptr, Value, Num);
+	return Ptr;
+}
+
+static bool BitMemcmpSSE2(const void* A, const void* B, size_t Num)
+{
+	return BitCompareSSE2((const uint8_t*)A, (const uint8_t*)B, Num);
+}
+
+static void BitResolveMemoryOps()
+{
+	const bit::ProcessorFeatures& Features = bit::GetOSProcessorFeatures();
+	if (Features.LastLevelCacheSize > 0)
+	{
+		bit::AtomicStoreInline(&GNonTemporalMinSize, bit::Max(Features.LastLevelCacheSize / 2, (size_t)(1 MiB)));
+	}
+	if (Features.bERMS) bit::AtomicStoreInline(&GRepMovsbMinSize, REP_MOVSB_MIN_SIZE);
+	// The thresholds are published before the functions that read them
+	bit::AtomicStoreInline<CopyFunc_t>(&GCopyBulk, Features.bAVX2 ? &BitMemcpyAVX2 : &BitMemcpySSE2);
+	bit::AtomicStoreInline<SetFunc_t>(&GSetBulk, Features.bAVX2 ? &BitMemsetAVX2 : &BitMemsetSSE2);
+	bit::AtomicStoreInline<CompareFunc_t>(&GCompareBulk, Features.bAVX2 ? &BitCompareAVX2 : &BitMemcmpSSE2);
+}
+
+#else
+
+/* Word at a time fallbacks for targets without SSE2 */
+static void* BitMemcpyWords(void* Dst, const void* Src, size_t Num)
+{
+	uint8_t* D = (uint8_t*)Dst;
+	const uint8_t* S = (const uint8_t*)Src;
+	for (; Num >= 8; D += 8, S += 8, Num -= 8) bit::StoreUnaligned(D, bit::LoadUnaligned<uint64_t>(S));
+	for (; Num > 0; --Num) *D++ = *S++;
+	return Dst;
+}
+
+static void* BitMemsetWords(void* Ptr, uint8_t Value, size_t Num)
+{
+	uint8_t* D = (uint8_t*)Ptr;
+	uint64_t Fill = 0x0101010101010101ULL * Value;
+	for (; Num >= 8; D += 8, Num -= 8) bit::StoreUnaligned(D, Fill);
+	for (; Num > 0; --Num) *D++ = Value;
+	return Ptr;
+}
+
+static bool BitMemcmpWords(const void* A, const void* B, size_t Num)
+{
+	const uint8_t* PA = (const uint8_t*)A;
+	const uint8_t* PB = (const uint8_t*)B;
+	for (; Num >= 8; PA += 8, PB += 8, Num -= 8)
+	{
+		if (bit::LoadUnaligned<uint64_t>(PA) != bit::LoadUnaligned<uint64_t>(PB)) return false;
+	}
+	for (; Num > 0; --Num)
+	{
+		if (*PA++ != *PB++) return false;
+	}
+	return true;
+}
+
+static void BitResolveMemoryOps()
+{
+	bit::AtomicStoreInline<CopyFunc_t>(&GCopyBulk, &BitMemcpyWords);
+	bit::AtomicStoreInline<SetFunc_t>(&GSetBulk, &BitMemsetWords);
+	bit::AtomicStoreInline<CompareFunc_t>(&GCompareBulk, &BitMemcmpWords);
+}
+
+#endif
+
+static void* BitResolveCopy(void* Dst, const void* Src, size_t Num)
+{
+	BitResolveMemoryOps();
+	return bit::AtomicLoadInline(&GCopyBulk)(Dst, Src, Num);
+}
+
+static void* BitResolveSet(void* Ptr, uint8_t Value, size_t Num)
+{
+	BitResolveMemoryOps();
+	return bit::AtomicLoadInline(&GSetBulk)(Ptr, Value, Num);
+}
+
+static bool BitResolveCompare(const void* A, const void* B, size_t Num)
+{
+	BitResolveMemoryOps();
+	return bit::AtomicLoadInline(&GCompareBulk)(A, B, Num);
+}
+
+void* bit::MemcpyBulk(void* Dst, const void* Src, size_t Num)
+{
+	return bit::AtomicLoadInline(&GCopyBulk)(Dst, Src, Num);
+}
+
+void* bit::MemsetBulk(void* Ptr, uint8_t Value, size_t Num)
+{
+	return bit::AtomicLoadInline(&GSetBulk)(Ptr, Value, Num);
+}
+
+bool bit::MemcmpBulk(const void* A, const void* B, size_t Num)
+{
+	return bit::AtomicLoadInline(&GCompareBulk)(A, B, Num);
+}
+
+void* bit::StreamCopy(void* Dst, const void* Src, size_t Num)
+{
+	if (Num <= MEMORY_INLINE_MAX_SIZE)
+	{
+		CopyInline((uint8_t*)Dst, (const uint8_t*)Src, Num);
+		return Dst;
+	}
+#if BIT_SIMD_SSE2
+	BitCopySSE2<true>((uint8_t*)Dst, (const uint8_t*)Src, Num);
+	return Dst;
+#else
+	return bit::AtomicLoadInline(&GCopyBulk)(Dst, Src, Num);
+#endif
+}
+
+void* bit::StreamZero(void* Ptr, size_t Num)
+{
+	if (Num <= MEMORY_INLINE_MAX_SIZE)
+	{
+		SetInline((uint8_t*)Ptr, 0, Num);
+		return Ptr;
+	}
+#if BIT_SIMD_SSE2
+	BitSetSSE2<true>((uint8_t*)Ptr, 0, Num);
+	return Ptr;
+#else
+	return bit::AtomicLoadInline(&GSetBulk)(Ptr, 0, Num);
+#endif
+}
+
+void* bit::MemmoveBulk(void* Dst, const void* Src, size_t Num)
+{
+	uint8_t* D = (uint8_t*)Dst;
+	const uint8_t* S = (const uint8_t*)Src;
+	if (D + Num <= S || S + Num <= D)
+	{
+		return bit::AtomicLoadInline(&GCopyBulk)(Dst, Src, Num);
+	}
+	// Overlapping. Every block is loaded before it is stored and blocks are walked away
+	// from the side being overwritten, the remainder is done by CopyInline which loads
+	// everything first.
+	if (D < S)
+	{
+		for (; Num > MEMORY_INLINE_MAX_SIZE; D += 16, S += 16, Num -= 16)
+		{
+		#if BIT_SIMD_SSE2
+			_mm_storeu_si128((__m128i*)D, _mm_loadu_si128((const __m128i*)S));
+		#else
+			uint64_t A = LoadUnaligned<uint64_t>(S);
+			uint64_t B = LoadUnaligned<uint64_t>(S + 8);
+			StoreUnaligned(D, A);
+			StoreUnaligned(D + 8, B);
+		#endif
+		}
+		CopyInline(D, S, Num);
+	}
+	else if (D > S)
+	{
+		for (; Num > MEMORY_INLINE_MAX_SIZE; Num -= 16)
+		{
+		#if BIT_SIMD_SSE2
+			_mm_storeu_si128((__m128i*)(D + Num - 16), _mm_loadu_si128((const __m128i*)(S + Num - 16)));
+		#else
+			uint64_t A = LoadUnaligned<uint64_t>(S + Num - 16);
+			uint64_t B = LoadUnaligned<uint64_t>(S + Num - 8);
+			StoreUnaligned(D + Num - 16, A);
+			StoreUnaligned(D + Num - 8, B);
+		#endif
+		}
+		CopyInline(D, S, Num);
+	}
+	return Dst;
+}
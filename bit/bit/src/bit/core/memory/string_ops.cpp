@@ -0,0 +1,255 @@
+#include <bit/core/memory/string_ops.h>
+#include <bit/core/memory/memory_ops.h>
+#include <bit/core/os/os.h>
+#include <bit/core/os/atomics.h>
+#include <string.h>
+
+#if BIT_SIMD_SSE2
+#include <immintrin.h>
+#if BIT_PLATFORM_WINDOWS
+#include <intrin.h>
+#endif
+#endif
+
+/* Smallest page size. A read that doesn't cross a multiple of it can't fault even if
+   it goes past the end of the string. */
+static constexpr uintptr_t SCAN_PAGE_SIZE = 4096;
+
+typedef const char* (*StrFindFunc_t)(const char* Str, size_t StrLen, const char* SubStr, size_t SubStrLen);
+
+static const char* BitResolveStrFind(const char* Str, size_t StrLen, const char* SubStr, size_t SubStrLen);
+
+// Starts at the resolver so calls made during static initialization still work. Loaded
+// and stored atomically since the first calls can race on it from several threads.
+static void* GStrFind = (void*)&BitResolveStrFind;
+
+/* Checks the candidates from Index on one at a time */
+static const char* BitStrFindTail(const char* Str, size_t Index, size_t Positions, const char* SubStr, size_t SubStrLen)
+{
+	const char First = SubStr[0];
+	const char Last = SubStr[SubStrLen - 1];
+	size_t MiddleLen = SubStrLen > 2 ? SubStrLen - 2 : 0;
+	for (; Index < Positions; ++Index)
+	{
+		if (Str[Index] == First && Str[Index + SubStrLen - 1] == Last && bit::Memcmp(Str + Index + 1, SubStr + 1, MiddleLen))
+		{
+			return Str + Index;
+		}
+	}
+	return nullptr;
+}
+
+#if BIT_SIMD_SSE2
+
+static BIT_FORCEINLINE uint32_t BitLowestBit(uint64_t Mask)
+{
+#if BIT_PLATFORM_WINDOWS && BIT_PLATFORM_X64
+	unsigned long BitIndex = 0;
+	_BitScanForward64(&BitIndex, Mask);
+	return (uint32_t)BitIndex;
+#elif BIT_PLATFORM_WINDOWS
+	unsigned long BitIndex = 0;
+	if (_BitScanForward(&BitIndex, (uint32_t)Mask)) return (uint32_t)BitIndex;
+	_BitScanForward(&BitIndex, (uint32_t)(Mask >> 32));
+	return (uint32_t)BitIndex + 32;
+#else
+	return (uint32_t)__builtin_ctzll(Mask);
+#endif
+}
+
+/* Compares the middle of SubStr at every candidate in Mask. Kept out of line so the
+   block loops keep their state in registers, candidates are rare. */
+static BIT_FORCENOINLINE const char* BitStrFindCandidates(const char* Block, uint64_t Mask, const char* SubStr, size_t MiddleLen)
+{
+	do
+	{
+		const char* Candidate = Block + BitLowestBit(Mask);
+		if (bit::Memcmp(Candidate + 1, SubStr + 1, MiddleLen)) return Candidate;
+		Mask &= Mask - 1;
+	} while (Mask != 0);
+	return nullptr;
+}
+
+/* Positions among the 16 from Block where both the first and the last byte of SubStr match */
+static BIT_FORCEINLINE uint32_t BitStrFindMaskSSE2(const char* Block, size_t LastOffset, __m128i First, __m128i Last)
+{
+	__m128i BlockFirst = _mm_loadu_si128((const __m128i*)Block);
+	__m128i BlockLast = _mm_loadu_si128((const __m128i*)(Block + LastOffset));
+	return (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(BlockFirst, First), _mm_cmpeq_epi8(BlockLast, Last)));
+}
+
+/* Under 16 positions. When neither load reaches the next page a single block covers
+   them all and the positions past the last one are masked off. */
+static BIT_NO_SANITIZE_ADDRESS const char* BitStrFindFew(const char* Str, size_t Positions, const char* SubStr, size_t SubStrLen)
+{
+	if (((uintptr_t)Str & (SCAN_PAGE_SIZE - 1)) + SubStrLen + 15 > SCAN_PAGE_SIZE) return BitStrFindTail(Str, 0, Positions, SubStr, SubStrLen);
+	uint32_t Mask = BitStrFindMaskSSE2(Str, SubStrLen - 1, _mm_set1_epi8(SubStr[0]), _mm_set1_epi8(SubStr[SubStrLen - 1])) & ((1u << Positions) - 1);
+	return Mask != 0 ? BitStrFindCandidates(Str, Mask, SubStr, SubStrLen > 2 ? SubStrLen - 2 : 0) : nullptr;
+}
+
+/* 16 to 32 positions. Two overlapping blocks cover them, positions rejected by the
+   first block are just rejected again by the second. */
+static const char* BitStrFindShortSSE2(const char* Str, size_t Positions, const char* SubStr, size_t SubStrLen)
+{
+	const __m128i First = _mm_set1_epi8(SubStr[0]);
+	const __m128i Last = _mm_set1_epi8(SubStr[SubStrLen - 1]);
+	size_t MiddleLen = SubStrLen > 2 ? SubStrLen - 2 : 0;
+	uint32_t Mask = BitStrFindMaskSSE2(Str, SubStrLen - 1, First, Last);
+	if (Mask != 0)
+	{
+		if (const char* Found = BitStrFindCandidates(Str, Mask, SubStr, MiddleLen)) return Found;
+	}
+	Mask = BitStrFindMaskSSE2(Str + Positions - 16, SubStrLen - 1, First, Last);
+	return Mask != 0 ? BitStrFindCandidates(Str + Positions - 16, Mask, SubStr, MiddleLen) : nullptr;
+}
+
+static const char* BitStrFindSSE2(const char* Str, size_t StrLen, const char* SubStr, size_t SubStrLen)
+{
+	size_t Positions = StrLen - SubStrLen + 1;
+	if (Positions <= 32) return BitStrFindShortSSE2(Str, Positions, SubStr, SubStrLen);
+	const __m128i First = _mm_set1_epi8(SubStr[0]);
+	const __m128i Last = _mm_set1_epi8(SubStr[SubStrLen - 1]);
+	size_t MiddleLen = SubStrLen > 2 ? SubStrLen - 2 : 0;
+	size_t Index = 0;
+	for (; Index + 16 <= Positions; Index += 16)
+	{
+		uint32_t Mask = BitStrFindMaskSSE2(Str + Index, SubStrLen - 1, First, Last);
+		if (Mask != 0)
+		{
+			if (const char* Found = BitStrFindCandidates(Str + Index, Mask, SubStr, MiddleLen)) return Found;
+		}
+	}
+	if (Index == Positions) return nullptr;
+	// The last block ends at the last position and overlaps the previous one
+	uint32_t Mask = BitStrFindMaskSSE2(Str + Positions - 16, SubStrLen - 1, First, Last);
+	return Mask != 0 ? BitStrFindCandidates(Str + Positions - 16, Mask, SubStr, MiddleLen) : nullptr;
+}
+
+static BIT_TARGET_AVX2 BIT_FORCEINLINE __m256i BitStrFindMatchAVX2(const char* Block, size_t LastOffset, __m256i First, __m256i Last)
+{
+	__m256i BlockFirst = _mm256_loadu_si256((const __m256i*)Block);
+	__m256i BlockLast = _mm256_loadu_si256((const __m256i*)(Block + LastOffset));
+	return _mm256_and_si256(_mm256_cmpeq_epi8(BlockFirst, First), _mm256_cmpeq_epi8(BlockLast, Last));
+}
+
+static BIT_TARGET_AVX2 const char* BitStrFindAVX2(const char* Str, size_t StrLen, const char* SubStr, size_t SubStrLen)
+{
+	size_t Positions = StrLen - SubStrLen + 1;
+	if (Positions <= 32) return BitStrFindShortSSE2(Str, Positions, SubStr, SubStrLen);
+	const __m256i First = _mm256_set1_epi8(SubStr[0]);
+	const __m256i Last = _mm256_set1_epi8(SubStr[SubStrLen - 1]);
+	size_t LastOffset = SubStrLen - 1;
+	size_t MiddleLen = SubStrLen > 2 ? SubStrLen - 2 : 0;
+	const char* End = Str + Positions;
+	uint32_t Mask = (uint32_t)_mm256_movemask_epi8(BitStrFindMatchAVX2(Str, LastOffset, First, Last));
+	if (Mask != 0)
+	{
+		if (const char* Found = BitStrFindCandidates(Str, Mask, SubStr, MiddleLen)) return Found;
+	}
+	// From here the loads of the first byte are aligned and only the ones of the last
+	// byte can split a cache line. 64 positions per step.
+	const char* Block = (const char*)(((uintptr_t)Str + 32) & ~(uintptr_t)31);
+	for (; Block + 64 <= End; Block += 64)
+	{
+		__m256i Low = BitStrFindMatchAVX2(Block, LastOffset, First, Last);
+		__m256i High = BitStrFindMatchAVX2(Block + 32, LastOffset, First, Last);
+		__m256i Any = _mm256_or_si256(Low, High);
+		if (!_mm256_testz_si256(Any, Any))
+		{
+			uint64_t BlockMask = (uint64_t)(uint32_t)_mm256_movemask_epi8(Low) | ((uint64_t)(uint32_t)_mm256_movemask_epi8(High) << 32);
+			if (const char* Found = BitStrFindCandidates(Block, BlockMask, SubStr, MiddleLen)) return Found;
+		}
+	}
+	// Under 64 positions left. At most two more blocks, the last one ends at the last position.
+	for (; Block < End; Block += 32)
+	{
+		const char* Tail = Block + 32 <= End ? Block : End - 32;
+		Mask = (uint32_t)_mm256_movemask_epi8(BitStrFindMatchAVX2(Tail, LastOffset, First, Last));
+		if (Mask != 0)
+		{
+			if (const char* Found = BitStrFindCandidates(Tail, Mask, SubStr, MiddleLen)) return Found;
+		}
+	}
+	return nullptr;
+}
+
+static void BitResolveStringOps()
+{
+	const bit::ProcessorFeatures& Features = bit::GetOSProcessorFeatures();
+	StrFindFunc_t StrFind = Features.bAVX2 ? &BitStrFindAVX2 : &BitStrFindSSE2;
+	bit::AtomicStore(&GStrFind, (void*)StrFind);
+}
+
+#else
+
+/* Position at a time fallbacks for targets without SSE2 */
+static const char* BitStrFindFew(const char* Str, size_t Positions, const char* SubStr, size_t SubStrLen)
+{
+	return BitStrFindTail(Str, 0, Positions, SubStr, SubStrLen);
+}
+
+static const char* BitStrFindBytes(const char* Str, size_t StrLen, const char* SubStr, size_t SubStrLen)
+{
+	return BitStrFindTail(Str, 0, StrLen - SubStrLen + 1, SubStr, SubStrLen);
+}
+
+static void BitResolveStringOps()
+{
+	bit::AtomicStore(&GStrFind, (void*)&BitStrFindBytes);
+}
+
+#endif
+
+static const char* BitResolveStrFind(const char* Str, size_t StrLen, const char* SubStr, size_t SubStrLen)
+{
+	BitResolveStringOps();
+	return ((StrFindFunc_t)bit::AtomicLoad(&GStrFind))(Str, StrLen, SubStr, SubStrLen);
+}
+
+/* The C runtime versions are already vectorized and measure faster than a block scan
+   that has to stay inside the page of the terminator */
+size_t bit::Strlen(const char* Str)
+{
+	return strlen(Str);
+}
+
+bool bit::StrContains(const char* A, const char* B, size_t* Offset)
+{
+	const char* Found = strstr(A, B);
+	if (Found != nullptr)
+	{
+		if (Offset != nullptr)
+		{
+			*Offset = (size_t)(Found - A);
+		}
+		return true;
+	}
+	return false;
+}
+
+bool bit::Strcmp(const char* A, const char* B)
+{
+	return strcmp(A, B) == 0;
+}
+
+bool bit::StrFind(const char* Str, size_t StrLen, const char* SubStr, size_t SubStrLen, size_t* Offset)
+{
+	if (SubStrLen > StrLen) return false;
+	const char* Found = Str;
+	if (SubStrLen > 0)
+	{
+		// Few positions are checked here without going through the resolved function
+		size_t Positions = StrLen - SubStrLen + 1;
+		Found = Positions < 16 ? BitStrFindFew(Str, Positions, SubStr, SubStrLen) :
+			((StrFindFunc_t)bit::AtomicLoad(&GStrFind))(Str, StrLen, SubStr, SubStrLen);
+	}
+	if (Found != nullptr)
+	{
+		if (Offset != nullptr)
+		{
+			*Offset = (size_t)(Found - Str);
+		}
+		return true;
+	}
+	return false;
+}
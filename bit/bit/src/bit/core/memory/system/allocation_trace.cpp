@@ -0,0 +1,169 @@
+#include <bit/core/memory/system/allocation_trace.h>
+#include <bit/core/os/atomics.h>
+#include <bit/core/os/debug.h>
+#include <bit/core/os/os.h>
+#include <bit/utility/scope_lock.h>
+#include <stdio.h>
+
+bit::AllocationTraceRecorder::AllocationTraceRecorder() :
+	Ring(nullptr),
+	File(nullptr),
+	StartSeconds(0.0),
+	Head(0),
+	Tail(0),
+	bRecording(0)
+{
+}
+
+bit::AllocationTraceRecorder::~AllocationTraceRecorder()
+{
+	Stop();
+	if (Ring != nullptr)
+	{
+		VirtualFreeBlock(RingMemory);
+	}
+}
+
+bool bit::AllocationTraceRecorder::Start(const char* Path)
+{
+	if (IsRecording()) return false;
+	if (Ring == nullptr)
+	{
+		// The ring lives outside the global allocator so recording never feeds back into it
+		if (!VirtualAllocateBlock(sizeof(AllocationEvent) * RING_CAPACITY, RingMemory)) return false;
+		Ring = (AllocationEvent*)RingMemory.CommitAll();
+		if (Ring == nullptr) return false;
+	}
+	FILE* TraceFile = fopen(Path, "wb");
+	if (TraceFile == nullptr) return false;
+	AllocationTraceHeader Header = { AllocationTraceHeader::MAGIC, AllocationTraceHeader::VERSION, (uint32_t)sizeof(AllocationEvent), 0 };
+	fwrite(&Header, sizeof(Header), 1, TraceFile);
+
+	File = TraceFile;
+	Head = 0;
+	Tail = 0;
+	StartSeconds = GetSeconds();
+	AtomicExchange(&bRecording, 1);
+	Writer.Start(&AllocationTraceRecorder::WriterMain, 0, this);
+	return true;
+}
+
+void bit::AllocationTraceRecorder::Stop()
+{
+	if (AtomicExchange(&bRecording, 0) == 0) return;
+	Writer.Join();
+	// A thread that found the ring full may still be flushing. Holding the lock until
+	// File is cleared makes later flushes drop their events instead of writing to a closed file.
+	ScopedLock<Mutex> FlushScope(&FlushLock);
+	WriteRing();
+	fclose((FILE*)File);
+	File = nullptr;
+}
+
+void bit::AllocationTraceRecorder::Record(AllocationEventType Type, const void* Address, const void* PrevAddress, size_t Size, size_t Alignment, const void* CallSite)
+{
+	if (!IsRecording()) return;
+	AllocationEvent Event = {};
+	Event.Timestamp = (uint64_t)((GetSeconds() - StartSeconds) * 1000000000.0);
+	Event.Address = (uint64_t)(uintptr_t)Address;
+	Event.PrevAddress = (uint64_t)(uintptr_t)PrevAddress;
+	Event.Size = (uint64_t)Size;
+	Event.CallSite = (uint64_t)(uintptr_t)CallSite;
+	Event.ThreadId = Thread::GetCurrentThreadId();
+	Event.AlignmentShift = Alignment > 0 ? (uint8_t)BitScanReverse((uint64_t)Alignment) : 0;
+	Event.Type = Type;
+	for (;;)
+	{
+		{
+			ScopedLock<Mutex> Lock(&RingLock);
+			if (Head - Tail < RING_CAPACITY)
+			{
+				Ring[Head % RING_CAPACITY] = Event;
+				Head += 1;
+				return;
+			}
+		}
+		Flush();
+	}
+}
+
+/*static*/ int32_t bit::AllocationTraceRecorder::WriterMain(void* UserData)
+{
+	AllocationTraceRecorder* Recorder = (AllocationTraceRecorder*)UserData;
+	while (Recorder->IsRecording())
+	{
+		Thread::SleepThread(WRITE_INTERVAL_MS);
+		Recorder->Flush();
+	}
+	return 0;
+}
+
+void bit::AllocationTraceRecorder::Flush()
+{
+	ScopedLock<Mutex> FlushScope(&FlushLock);
+	WriteRing();
+}
+
+void bit::AllocationTraceRecorder::WriteRing()
+{
+	int64_t Begin = 0;
+	int64_t End = 0;
+	{
+		ScopedLock<Mutex> Lock(&RingLock);
+		Begin = Tail;
+		End = Head;
+	}
+	// Events in [Begin, End) can't be overwritten until Tail moves past them
+	FILE* TraceFile = (FILE*)File;
+	while (Begin < End)
+	{
+		int64_t Index = Begin % RING_CAPACITY;
+		int64_t Count = Min(End - Begin, RING_CAPACITY - Index);
+		if (TraceFile != nullptr) fwrite(&Ring[Index], sizeof(AllocationEvent), (size_t)Count, TraceFile);
+		Begin += Count;
+	}
+	ScopedLock<Mutex> Lock(&RingLock);
+	Tail = End;
+}
+
+bit::AllocationTraceReader::AllocationTraceReader() :
+	File(nullptr)
+{
+}
+
+bit::AllocationTraceReader::~AllocationTraceReader()
+{
+	Close();
+}
+
+bool bit::AllocationTraceReader::Open(const char* Path)
+{
+	Close();
+	FILE* TraceFile = fopen(Path, "rb");
+	if (TraceFile == nullptr) return false;
+	AllocationTraceHeader Header = {};
+	if (fread(&Header, sizeof(Header), 1, TraceFile) != 1 ||
+		Header.Magic != AllocationTraceHeader::MAGIC ||
+		Header.Version != AllocationTraceHeader::VERSION ||
+		Header.EventSize != sizeof(AllocationEvent))
+	{
+		fclose(TraceFile);
+		return false;
+	}
+	File = TraceFile;
+	return true;
+}
+
+bool bit::AllocationTraceReader::Read(AllocationEvent& OutEvent)
+{
+	return File != nullptr && fread(&OutEvent, sizeof(AllocationEvent), 1, (FILE*)File) == 1;
+}
+
+void bit::AllocationTraceReader::Close()
+{
+	if (File != nullptr)
+	{
+		fclose((FILE*)File);
+		File = nullptr;
+	}
+}
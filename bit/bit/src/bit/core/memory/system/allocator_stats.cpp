@@ -0,0 +1,111 @@
+#include <bit/core/memory/system/allocator_stats.h>
+#include <bit/core/os/os.h>
+#include <stdio.h>
+#include <stdarg.h>
+
+namespace bit
+{
+	/* Appends formatted text and keeps counting once the buffer is full */
+	struct StatsJsonWriter
+	{
+		void Write(const char* Fmt, ...)
+		{
+			size_t Remaining = Length < BufferSize ? BufferSize - Length : 0;
+			va_list VaArgs;
+			va_start(VaArgs, Fmt);
+			int32_t Written = vsnprintf(Remaining > 0 ? Buffer + Length : nullptr, Remaining, Fmt, VaArgs);
+			va_end(VaArgs);
+			if (Written > 0) Length += (size_t)Written;
+		}
+
+		void WriteAllocator(const char* Name, const AllocatorStats& Stats, const SizeClassStats* Classes, size_t ClassCount)
+		{
+			Write("\"%s\":{\"AllocatedBytes\":%zu,\"CommittedBytes\":%zu,\"ReservedBytes\":%zu,", Name,
+				Stats.MemoryInfo.AllocatedBytes, Stats.MemoryInfo.CommittedBytes, Stats.MemoryInfo.ReservedBytes);
+			Write("\"AllocCount\":%lld,\"FreeCount\":%lld,\"PeakAllocatedBytes\":%lld,\"CommitCount\":%lld,\"DecommitCount\":%lld,",
+				(long long)Stats.AllocCount, (long long)Stats.FreeCount, (long long)Stats.PeakAllocatedBytes,
+				(long long)Stats.CommitCount, (long long)Stats.DecommitCount);
+			Write("\"LockWaitCount\":%lld,\"LockWaitNanoseconds\":%lld,\"FragmentationRatio\":%.4f",
+				(long long)Stats.LockWaitCount, (long long)Stats.LockWaitNanoseconds, Stats.FragmentationRatio);
+			if (Classes != nullptr)
+			{
+				Write(",\"SizeClasses\":[");
+				for (size_t Index = 0; Index < ClassCount; ++Index)
+				{
+					const SizeClassStats& Class = Classes[Index];
+					Write("%s{\"BlockSize\":%zu,\"AllocCount\":%lld,\"FreeCount\":%lld,\"LiveBytes\":%lld,\"PeakBytes\":%lld}",
+						Index > 0 ? "," : "", Class.BlockSize, (long long)Class.AllocCount, (long long)Class.FreeCount,
+						(long long)Class.LiveBytes, (long long)Class.PeakBytes);
+				}
+				Write("]");
+			}
+			Write("}");
+		}
+
+		char* Buffer;
+		size_t BufferSize;
+		size_t Length;
+	};
+}
+
+size_t bit::MemoryStats::WriteJson(char* Buffer, size_t BufferSize) const
+{
+	StatsJsonWriter Writer = { Buffer, BufferSize, 0 };
+	Writer.Write("{\"Enabled\":%s,", bEnabled ? "true" : "false");
+	Writer.WriteAllocator("Total", Total, nullptr, 0);
+	Writer.Write(",");
+	Writer.WriteAllocator("Small", Small, SmallClasses, SmallClassCount);
+	Writer.Write(",");
+	Writer.WriteAllocator("Medium", Medium, MediumClasses, MediumClassCount);
+	Writer.Write(",");
+	Writer.WriteAllocator("Large", Large, nullptr, 0);
+	Writer.Write("}");
+	return Writer.Length;
+}
+
+double bit::GetFragmentationRatio(const AllocatorMemoryInfo& Info)
+{
+	if (Info.CommittedBytes == 0 || Info.AllocatedBytes >= Info.CommittedBytes) return 0.0;
+	return 1.0 - (double)Info.AllocatedBytes / (double)Info.CommittedBytes;
+}
+
+bit::SizeClassStats bit::SizeClassCounters::Read(size_t BlockSize) const
+{
+	SizeClassStats Stats = {};
+	Stats.BlockSize = BlockSize;
+	Stats.AllocCount = AllocCount;
+	Stats.FreeCount = FreeCount;
+	Stats.LiveBytes = LiveBytes;
+	Stats.PeakBytes = PeakBytes;
+	return Stats;
+}
+
+void bit::AllocatorCounters::Read(AllocatorStats& OutStats) const
+{
+	OutStats.AllocCount = AllocCount;
+	OutStats.FreeCount = FreeCount;
+	OutStats.PeakAllocatedBytes = PeakBytes;
+	OutStats.CommitCount = CommitCount;
+	OutStats.DecommitCount = DecommitCount;
+}
+
+void bit::StatsMutex::Lock()
+{
+#if BIT_ALLOCATOR_STATS
+	if (!Handle.TryLock())
+	{
+		double Start = GetSeconds();
+		Handle.Lock();
+		AtomicIncrement(&WaitCount);
+		AtomicAdd(&WaitNanoseconds, (int64_t)((GetSeconds() - Start) * 1000000000.0));
+	}
+#else
+	Handle.Lock();
+#endif
+}
+
+void bit::StatsMutex::Read(AllocatorStats& OutStats) const
+{
+	OutStats.LockWaitCount += WaitCount;
+	OutStats.LockWaitNanoseconds += WaitNanoseconds;
+}
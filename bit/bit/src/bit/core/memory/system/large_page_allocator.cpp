@@ -0,0 +1,169 @@
+#include <bit/core/memory/system/large_page_allocator.h>
+#include <bit/core/memory.h>
+#include <bit/core/os/debug.h>
+#include <bit/core/os/os.h>
+
+bit::LargePageAllocator::LargePageAllocator() :
+	IAllocator("LargePageAllocator"),
+	AllocationMap(nullptr),
+	AllocationCount(0),
+	AllocatedBytes(0),
+	CommittedBytes(0),
+	LargePageBytes(0)
+{
+	BIT_ASSERT(bit::VirtualAllocateBlock(sizeof(AllocationEntry) * TABLE_SIZE, AllocationMapBackstore));
+	AllocationMap = (AllocationEntry*)AllocationMapBackstore.CommitAll();
+	BIT_ASSERT(AllocationMap != nullptr);
+	bit::Memset(AllocationMap, 0, sizeof(AllocationEntry) * TABLE_SIZE);
+}
+
+bit::LargePageAllocator::~LargePageAllocator()
+{
+	for (size_t Index = 0; Index < TABLE_SIZE; ++Index)
+	{
+		AllocationEntry& Entry = AllocationMap[Index];
+		if (Entry.Address != nullptr)
+		{
+			bit::VirtualFreeLargePages(Entry.Address, Entry.CommittedBytes);
+		}
+	}
+	bit::VirtualFreeBlock(AllocationMapBackstore);
+}
+
+void* bit::LargePageAllocator::Allocate(size_t Size, size_t Alignment)
+{
+	if (!CanAllocate(Size, Alignment)) return nullptr;
+
+	size_t MappedSize = 0;
+	LargePageType PageType = LargePageType::LARGE_PAGE_TYPE_NONE;
+	void* Address = bit::VirtualAllocateLargePages(Size, MappedSize, PageType);
+	if (Address == nullptr) return nullptr;
+	Counters.OnCommit();
+	Counters.OnAlloc((int64_t)Size);
+
+	AllocationEntry* Entry = InsertEntry(Address);
+	Entry->AllocatedBytes = Size;
+	Entry->CommittedBytes = MappedSize;
+	Entry->PageType = PageType;
+	AllocatedBytes += Size;
+	CommittedBytes += MappedSize;
+	if (PageType != LargePageType::LARGE_PAGE_TYPE_NONE)
+	{
+		LargePageBytes += MappedSize;
+	}
+	return Address;
+}
+
+void bit::LargePageAllocator::Free(void* Pointer)
+{
+	AllocationEntry* Entry = FindEntry(Pointer);
+	if (Entry != nullptr)
+	{
+		AllocatedBytes -= Entry->AllocatedBytes;
+		CommittedBytes -= Entry->CommittedBytes;
+		if (Entry->PageType != LargePageType::LARGE_PAGE_TYPE_NONE)
+		{
+			LargePageBytes -= Entry->CommittedBytes;
+		}
+		bit::VirtualFreeLargePages(Entry->Address, Entry->CommittedBytes);
+		Counters.OnDecommit();
+		Counters.OnFree((int64_t)Entry->AllocatedBytes);
+		RemoveEntry(Entry);
+	}
+}
+
+size_t bit::LargePageAllocator::GetSize(void* Pointer)
+{
+	AllocationEntry* Entry = FindEntry(Pointer);
+	if (Entry != nullptr)
+	{
+		return Entry->CommittedBytes;
+	}
+	return 0;
+}
+
+bit::AllocatorMemoryInfo bit::LargePageAllocator::GetMemoryUsageInfo()
+{
+	AllocatorMemoryInfo Info = {};
+	Info.AllocatedBytes = AllocatedBytes;
+	Info.CommittedBytes = CommittedBytes + AllocationMapBackstore.GetCommittedSize();
+	Info.ReservedBytes = CommittedBytes + AllocationMapBackstore.GetReservedSize();
+	return Info;
+}
+
+void bit::LargePageAllocator::GetStats(AllocatorStats& OutStats)
+{
+	OutStats = {};
+	OutStats.MemoryInfo = GetMemoryUsageInfo();
+	OutStats.FragmentationRatio = GetFragmentationRatio(OutStats.MemoryInfo);
+	Counters.Read(OutStats);
+}
+
+bool bit::LargePageAllocator::CanAllocate(size_t Size, size_t Alignment)
+{
+	return Size > 0 && Alignment <= bit::GetOSPageSize() && AllocationCount < MAX_ALLOCATION_COUNT;
+}
+
+bool bit::LargePageAllocator::OwnsAllocation(const void* Ptr)
+{
+	return FindEntry(Ptr) != nullptr;
+}
+
+size_t bit::LargePageAllocator::GetSlotIndex(const void* Ptr) const
+{
+	// Mappings are at least page aligned so the low bits carry no information
+	uint64_t Key = (uint64_t)(uintptr_t)Ptr >> 12;
+	return (size_t)((Key * 0x9E3779B97F4A7C15ULL) >> 32) & (TABLE_SIZE - 1);
+}
+
+bit::LargePageAllocator::AllocationEntry* bit::LargePageAllocator::FindEntry(const void* Ptr)
+{
+	if (Ptr == nullptr || AllocationCount == 0) return nullptr;
+	size_t Index = GetSlotIndex(Ptr);
+	for (size_t Probe = 0; Probe < TABLE_SIZE; ++Probe, Index = (Index + 1) & (TABLE_SIZE - 1))
+	{
+		AllocationEntry* Entry = &AllocationMap[Index];
+		if (Entry->Address == Ptr) return Entry;
+		if (Entry->Address == nullptr) return nullptr;
+	}
+	return nullptr;
+}
+
+bit::LargePageAllocator::AllocationEntry* bit::LargePageAllocator::InsertEntry(void* Ptr)
+{
+	BIT_ASSERT(AllocationCount < MAX_ALLOCATION_COUNT);
+	for (size_t Index = GetSlotIndex(Ptr); ; Index = (Index + 1) & (TABLE_SIZE - 1))
+	{
+		AllocationEntry* Entry = &AllocationMap[Index];
+		if (Entry->Address == nullptr)
+		{
+			Entry->Address = Ptr;
+			AllocationCount += 1;
+			return Entry;
+		}
+	}
+}
+
+void bit::LargePageAllocator::RemoveEntry(AllocationEntry* Entry)
+{
+	// Backward shift deletion. Moves entries of the same probe chain into 
+	// the hole so lookups never need tombstones.
+	size_t Hole = (size_t)(Entry - AllocationMap);
+	size_t Index = Hole;
+	for (;;)
+	{
+		Index = (Index + 1) & (TABLE_SIZE - 1);
+		AllocationEntry* Next = &AllocationMap[Index];
+		if (Next->Address == nullptr) break;
+		size_t Ideal = GetSlotIndex(Next->Address);
+		size_t DistanceToHole = (Hole - Ideal) & (TABLE_SIZE - 1);
+		size_t DistanceToIndex = (Index - Ideal) & (TABLE_SIZE - 1);
+		if (DistanceToHole < DistanceToIndex)
+		{
+			AllocationMap[Hole] = *Next;
+			Hole = Index;
+		}
+	}
+	bit::Memset(&AllocationMap[Hole], 0, sizeof(AllocationEntry));
+	AllocationCount -= 1;
+}
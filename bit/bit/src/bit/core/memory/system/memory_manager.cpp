@@ -3,73 +3,303 @@
 #include <bit/core/memory.h>
 #include <bit/utility/scope_lock.h>
 
+namespace bit
+{
+	/* Fast path for the heap of the calling thread. The TLS slot still owns the heap
+	   and runs its destructor, this only skips the TlsGetValue call per allocation. */
+	static BIT_THREAD_LOCAL SmallBlockAllocator::ThreadHeap* GCachedThreadHeap = nullptr;
+}
+
 bit::MemoryManager::MemoryManager() :
 	IAllocator("MemoryManager"),
-	BaseAllocator()
+	SmallAllocator(),
+	MediumAllocator(),
+	LargeAllocator(),
+	ThreadHeapSlot(bit::TlsAllocSlot(&MemoryManager::OnThreadExit))
 {
 }
 
 void* bit::MemoryManager::Allocate(size_t Size, size_t Alignment)
 {
-	bit::ScopedLock<bit::Mutex> Lock(&AccessLock);
-	if (BaseAllocator.CanAllocate(Size, Alignment))
+	return TracedAllocate(Size, Alignment, BIT_RETURN_ADDRESS());
+}
+void* bit::MemoryManager::Reallocate(void* Pointer, size_t Size, size_t Alignment)
+{
+	return TracedReallocate(Pointer, Size, Alignment, BIT_RETURN_ADDRESS());
+}
+bool bit::MemoryManager::ResizeInPlace(void* Pointer, size_t Size)
+{
+	if (Pointer == nullptr) return false;
+	bool bResized = false;
+	if (MediumAllocator.OwnsAllocation(Pointer))
+	{
+		if (MediumAllocator.CanAllocate(Size, bit::DEFAULT_ALIGNMENT))
+		{
+			bit::ScopedLock<bit::StatsMutex> Lock(&AccessLock);
+			bResized = MediumAllocator.ResizeInPlace(Pointer, Size);
+		}
+	}
+	else
+	{
+		bResized = GetSize(Pointer) >= Size;
+	}
+	if (bResized)
+	{
+		TraceRecorder.Record(AllocationEventType::EVENT_REALLOCATE, Pointer, Pointer, Size, bit::DEFAULT_ALIGNMENT, BIT_RETURN_ADDRESS());
+	}
+	return bResized;
+}
+void bit::MemoryManager::Free(void* Pointer)
+{
+	TracedFree(Pointer, BIT_RETURN_ADDRESS());
+}
+void* bit::MemoryManager::TracedAllocate(size_t Size, size_t Alignment, const void* CallSite)
+{
+	void* Block = AllocateBlock(Size, Alignment);
+	if (TraceRecorder.IsRecording())
 	{
-		return BaseAllocator.Allocate(Size, Alignment);
+		TraceRecorder.Record(AllocationEventType::EVENT_ALLOCATE, Block, nullptr, Size, Alignment, CallSite);
+	}
+	return Block;
+}
+void* bit::MemoryManager::TracedReallocate(void* Pointer, size_t Size, size_t Alignment, const void* CallSite)
+{
+	return ReallocateBlock(Pointer, Size, Alignment, CallSite);
+}
+void bit::MemoryManager::TracedFree(void* Pointer, const void* CallSite)
+{
+	if (Pointer == nullptr) return;
+	// Recorded before the block is released so a replay never sees its address reused first
+	if (TraceRecorder.IsRecording())
+	{
+		TraceRecorder.Record(AllocationEventType::EVENT_FREE, Pointer, nullptr, 0, 0, CallSite);
+	}
+	FreeBlock(Pointer);
+}
+bool bit::MemoryManager::StartTrace(const char* Path)
+{
+	return TraceRecorder.Start(Path);
+}
+void bit::MemoryManager::StopTrace()
+{
+	TraceRecorder.Stop();
+}
+
+void* bit::MemoryManager::AllocateBlock(size_t Size, size_t Alignment)
+{
+	if (SmallAllocator.CanAllocate(Size, Alignment))
+	{
+		SmallBlockAllocator::ThreadHeap* Heap = GetThreadHeap();
+		void* Block = Heap != nullptr ? SmallAllocator.Allocate(Heap, Size, Alignment) : SmallAllocator.Allocate(Size, Alignment);
+		// Once the small block address space is used up the medium allocator takes over
+		if (Block != nullptr) return Block;
+	}
+
+	bit::ScopedLock<bit::StatsMutex> Lock(&AccessLock);
+	if (MediumAllocator.CanAllocate(Size, Alignment))
+	{
+		return MediumAllocator.Allocate(Size, Alignment);
+	}
+	else if (LargeAllocator.CanAllocate(Size, Alignment))
+	{
+		return LargeAllocator.Allocate(Size, Alignment);
 	}
 	return nullptr;
 }
-void* bit::MemoryManager::Reallocate(void* Pointer, size_t Size, size_t Alignment)
+void* bit::MemoryManager::ReallocateBlock(void* Pointer, size_t Size, size_t Alignment, const void* CallSite)
 {
-	if (Pointer == nullptr) return Allocate(Size, Alignment);
-	size_t BlockSize = GetSize(Pointer);
-	void* NewBlock = Allocate(Size, Alignment);
-	bit::Memcpy(NewBlock, Pointer, bit::Min(BlockSize, Size));
-	Free(Pointer);
+	void* NewBlock = Pointer;
+	size_t BlockSize = 0;
+	bool bAligned = bit::IsAddressAligned(Pointer, Alignment);
+	if (Pointer == nullptr)
+	{
+		NewBlock = AllocateBlock(Size, Alignment);
+	}
+	else if (SmallAllocator.OwnsAllocation(Pointer))
+	{
+		// Kept while the new size maps to the same size class
+		BlockSize = SmallAllocator.GetSize(Pointer);
+		if (!bAligned || !SmallAllocator.CanAllocate(Size, Alignment) || SmallAllocator.GetAllocationSize(Size, Alignment) != BlockSize) NewBlock = nullptr;
+	}
+	else if (MediumAllocator.OwnsAllocation(Pointer))
+	{
+		bit::ScopedLock<bit::StatsMutex> Lock(&AccessLock);
+		if (!bAligned || !MediumAllocator.CanAllocate(Size, Alignment) || !MediumAllocator.ResizeInPlace(Pointer, Size))
+		{
+			BlockSize = MediumAllocator.GetSize(Pointer);
+			NewBlock = nullptr;
+		}
+	}
+	else
+	{
+		// Kept while the mapped pages still hold it and it is too big for the medium allocator
+		bit::ScopedLock<bit::StatsMutex> Lock(&AccessLock);
+		BlockSize = LargeAllocator.GetSize(Pointer);
+		if (!bAligned || BlockSize < Size || MediumAllocator.CanAllocate(Size, Alignment)) NewBlock = nullptr;
+	}
+
+	if (NewBlock == nullptr && Pointer != nullptr)
+	{
+		NewBlock = AllocateBlock(Size, Alignment);
+		if (NewBlock != nullptr) bit::Memcpy(NewBlock, Pointer, bit::Min(BlockSize, Size));
+	}
+	// Recorded before the old block is released so its address can't show up in
+	// another thread's allocation event first
+	if (TraceRecorder.IsRecording())
+	{
+		TraceRecorder.Record(AllocationEventType::EVENT_REALLOCATE, NewBlock, Pointer, Size, Alignment, CallSite);
+	}
+	if (NewBlock != Pointer && NewBlock != nullptr)
+	{
+		FreeBlock(Pointer);
+	}
 	return NewBlock;
 }
-void bit::MemoryManager::Free(void* Pointer)
+void bit::MemoryManager::FreeBlock(void* Pointer)
 {
-	bit::ScopedLock<bit::Mutex> Lock(&AccessLock);
-	if (BaseAllocator.OwnsAllocation(Pointer))
+	if (SmallAllocator.OwnsAllocation(Pointer))
+	{
+		// Never create a heap just to free a block. Without a heap the block
+		// goes to the remote free list of the page owner.
+		SmallBlockAllocator::ThreadHeap* Heap = GCachedThreadHeap;
+		if (Heap == nullptr || Heap->GetContext() != this)
+		{
+			Heap = ThreadHeapSlot != INVALID_TLS_HANDLE ? (SmallBlockAllocator::ThreadHeap*)bit::TlsGetValue(ThreadHeapSlot) : nullptr;
+		}
+		SmallAllocator.Free(Heap, Pointer);
+	}
+	else if (MediumAllocator.OwnsAllocation(Pointer))
 	{
-		BaseAllocator.Free(Pointer);
+		bit::ScopedLock<bit::StatsMutex> Lock(&AccessLock);
+		MediumAllocator.Free(Pointer);
+	}
+	else if (Pointer != nullptr)
+	{
+		bit::ScopedLock<bit::StatsMutex> Lock(&AccessLock);
+		LargeAllocator.Free(Pointer);
 	}
 }
 size_t bit::MemoryManager::GetSize(void* Pointer)
 {
-	if (BaseAllocator.OwnsAllocation(Pointer)) return BaseAllocator.GetSize(Pointer);
-	return 0;
+	if (SmallAllocator.OwnsAllocation(Pointer)) return SmallAllocator.GetSize(Pointer);
+	if (MediumAllocator.OwnsAllocation(Pointer)) return MediumAllocator.GetSize(Pointer);
+	bit::ScopedLock<bit::StatsMutex> Lock(&AccessLock);
+	return LargeAllocator.GetSize(Pointer);
 }
 bit::AllocatorMemoryInfo bit::MemoryManager::GetMemoryUsageInfo()
 {
-	bit::ScopedLock<bit::Mutex> Lock(&AccessLock);
-	AllocatorMemoryInfo BaseUsage = BaseAllocator.GetMemoryUsageInfo();
+	bit::ScopedLock<bit::StatsMutex> Lock(&AccessLock);
+	AllocatorMemoryInfo SmallUsage = SmallAllocator.GetMemoryUsageInfo();
+	AllocatorMemoryInfo MediumUsage = MediumAllocator.GetMemoryUsageInfo();
+	AllocatorMemoryInfo LargeUsage = LargeAllocator.GetMemoryUsageInfo();
 	AllocatorMemoryInfo Usage = {};
-	Usage.AllocatedBytes = BaseUsage.AllocatedBytes;
-	Usage.CommittedBytes = BaseUsage.CommittedBytes;
-	Usage.ReservedBytes = BaseUsage.ReservedBytes;
-	//BIT_ALWAYS_LOG(
-	//	"Small Allocs: %u\n"
-	//	"Medium Allocs: %u\n"
-	//	"Heap Allocs: %u\n",
-	//	Small, Medium, Heap
-	//);
+	// Blocks sitting in remote free lists are reported as allocated until reclaimed
+	Usage.AllocatedBytes = SmallUsage.AllocatedBytes + MediumUsage.AllocatedBytes + LargeUsage.AllocatedBytes;
+	Usage.CommittedBytes = SmallUsage.CommittedBytes + MediumUsage.CommittedBytes + LargeUsage.CommittedBytes;
+	Usage.ReservedBytes = SmallUsage.ReservedBytes + MediumUsage.ReservedBytes + LargeUsage.ReservedBytes;
 	return Usage;
 }
 
 bool bit::MemoryManager::CanAllocate(size_t Size, size_t Alignment)
 {
-	return BaseAllocator.CanAllocate(Size, Alignment);
+	return SmallAllocator.CanAllocate(Size, Alignment) || 
+		MediumAllocator.CanAllocate(Size, Alignment) || 
+		LargeAllocator.CanAllocate(Size, Alignment);
 }
 
 bool bit::MemoryManager::OwnsAllocation(const void* Ptr)
 {
-	return BaseAllocator.OwnsAllocation(Ptr);
+	if (SmallAllocator.OwnsAllocation(Ptr) || MediumAllocator.OwnsAllocation(Ptr)) return true;
+	bit::ScopedLock<bit::StatsMutex> Lock(&AccessLock);
+	return LargeAllocator.OwnsAllocation(Ptr);
 }
 
 size_t bit::MemoryManager::Compact()
 {
-	return BaseAllocator.Compact();
+	CollectThreadHeap();
+	bit::ScopedLock<bit::StatsMutex> Lock(&AccessLock);
+	return SmallAllocator.Compact() + MediumAllocator.Compact() + LargeAllocator.Compact();
+}
+
+void bit::MemoryManager::GetStats(MemoryStats& OutStats)
+{
+	OutStats.bEnabled = BIT_ALLOCATOR_STATS != 0;
+	SmallAllocator.GetStats(OutStats.Small);
+	OutStats.SmallClassCount = SmallAllocator.GetSizeClassStats(OutStats.SmallClasses, MemoryStats::MAX_SIZE_CLASSES);
+	{
+		bit::ScopedLock<bit::StatsMutex> Lock(&AccessLock);
+		MediumAllocator.GetStats(OutStats.Medium);
+		OutStats.MediumClassCount = MediumAllocator.GetSizeClassStats(OutStats.MediumClasses, MemoryStats::MAX_SIZE_CLASSES);
+		LargeAllocator.GetStats(OutStats.Large);
+	}
+
+	const AllocatorStats* Allocators[] = { &OutStats.Small, &OutStats.Medium, &OutStats.Large };
+	AllocatorStats& Total = OutStats.Total;
+	Total = {};
+	for (const AllocatorStats* Stats : Allocators)
+	{
+		Total.MemoryInfo.AllocatedBytes += Stats->MemoryInfo.AllocatedBytes;
+		Total.MemoryInfo.CommittedBytes += Stats->MemoryInfo.CommittedBytes;
+		Total.MemoryInfo.ReservedBytes += Stats->MemoryInfo.ReservedBytes;
+		Total.AllocCount += Stats->AllocCount;
+		Total.FreeCount += Stats->FreeCount;
+		Total.PeakAllocatedBytes += Stats->PeakAllocatedBytes;
+		Total.CommitCount += Stats->CommitCount;
+		Total.DecommitCount += Stats->DecommitCount;
+		Total.LockWaitCount += Stats->LockWaitCount;
+		Total.LockWaitNanoseconds += Stats->LockWaitNanoseconds;
+	}
+	// The medium and large allocators share the MemoryManager lock
+	AccessLock.Read(Total);
+	Total.FragmentationRatio = GetFragmentationRatio(Total.MemoryInfo);
+}
+
+void bit::MemoryManager::CollectThreadHeap()
+{
+	if (ThreadHeapSlot == INVALID_TLS_HANDLE) return;
+	SmallBlockAllocator::ThreadHeap* Heap = (SmallBlockAllocator::ThreadHeap*)bit::TlsGetValue(ThreadHeapSlot);
+	if (Heap != nullptr)
+	{
+		SmallAllocator.CollectHeap(Heap);
+	}
+}
+
+/*static*/ void bit::MemoryManager::OnThreadExit(void* Heap)
+{
+	SmallBlockAllocator::ThreadHeap* ExitingHeap = (SmallBlockAllocator::ThreadHeap*)Heap;
+	((MemoryManager*)ExitingHeap->GetContext())->DestroyThreadHeap(ExitingHeap);
+}
+
+bit::SmallBlockAllocator::ThreadHeap* bit::MemoryManager::GetThreadHeap()
+{
+	SmallBlockAllocator::ThreadHeap* CachedHeap = GCachedThreadHeap;
+	if (CachedHeap != nullptr && CachedHeap->GetContext() == this) return CachedHeap;
+	if (ThreadHeapSlot == INVALID_TLS_HANDLE) return nullptr;
+	SmallBlockAllocator::ThreadHeap* Heap = (SmallBlockAllocator::ThreadHeap*)bit::TlsGetValue(ThreadHeapSlot);
+	if (Heap == nullptr)
+	{
+		void* HeapMemory = nullptr;
+		{
+			bit::ScopedLock<bit::StatsMutex> Lock(&AccessLock);
+			HeapMemory = MediumAllocator.Allocate(sizeof(SmallBlockAllocator::ThreadHeap), alignof(SmallBlockAllocator::ThreadHeap));
+		}
+		if (HeapMemory != nullptr)
+		{
+			Heap = BitPlacementNew(HeapMemory) SmallBlockAllocator::ThreadHeap(this);
+			bit::TlsSetValue(ThreadHeapSlot, Heap);
+		}
+	}
+	if (CachedHeap == nullptr) GCachedThreadHeap = Heap;
+	return Heap;
+}
+
+void bit::MemoryManager::DestroyThreadHeap(SmallBlockAllocator::ThreadHeap* Heap)
+{
+	// Runs on the exiting thread so the cache belongs to it
+	if (GCachedThreadHeap == Heap) GCachedThreadHeap = nullptr;
+	SmallAllocator.AbandonHeap(Heap);
+	bit::ScopedLock<bit::StatsMutex> Lock(&AccessLock);
+	MediumAllocator.Free(Heap);
 }
 
 namespace bit
@@ -87,3 +317,18 @@ bit::IAllocator& bit::GetGlobalAllocator()
 	}
 	return *GlobalAllocator;
 }
+
+void bit::GetMemoryStats(MemoryStats& OutStats)
+{
+	static_cast<MemoryManager&>(GetGlobalAllocator()).GetStats(OutStats);
+}
+
+bool bit::StartAllocationTrace(const char* Path)
+{
+	return static_cast<MemoryManager&>(GetGlobalAllocator()).StartTrace(Path);
+}
+
+void bit::StopAllocationTrace()
+{
+	static_cast<MemoryManager&>(GetGlobalAllocator()).StopTrace();
+}
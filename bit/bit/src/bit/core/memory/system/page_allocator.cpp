@@ -12,6 +12,7 @@ bit::PageAllocator::PageAllocator(const char* Name, void* StartAddress, size_t R
 	BIT_ASSERT(bit::IsPow2(VirtualAddress.GetReservedSize())); // ***  TotalSize is not a power of 2 value. TotalSize MUST be power of 2. *** 
 	BIT_ASSERT(bit::IsPow2(AllocationGranularity)); // ***  AllocationGranularity is not a power of 2 value. AllocationGranularity MUST be power of 2. *** 
 	LevelCount = bit::BitScanReverse(VirtualAddress.GetReservedSize() / PageGranularity) + 1;
+	BIT_ASSERT(LevelCount <= MAX_LEVEL_COUNT);
 	PageCount = bit::Pow2(LevelCount) - 1; // We subtract 1 because we can't have a block at the end of memory.
 	size_t PageBitCount = PageCount * BITS_PER_PAGE;
 	size_t PageByteCount = PageBitCount / 8;
@@ -34,11 +35,13 @@ bit::PageAllocator::~PageAllocator()
 
 void* bit::PageAllocator::CommitPage(void* Address, size_t Size)
 {
+	Counters.OnCommit();
 	return VirtualAddress.CommitPagesByAddress(Address, Size);
 }
 
 void bit::PageAllocator::DecommitPage(void* Address, size_t Size)
 {
+	Counters.OnDecommit();
 	VirtualAddress.DecommitPagesByAddress( Address, Size );
 }
 
@@ -174,6 +177,8 @@ void* bit::PageAllocator::Allocate(size_t Size, size_t Alignment)
 	ReservedPages Pages = Reserve(AlignedSize);
 	if (Pages.Address != nullptr)
 	{
+		Counters.OnAlloc((int64_t)Pages.ReservedSize);
+		LevelCounters[GetPageLevel(Pages.PageIndex)].OnAlloc((int64_t)Pages.ReservedSize);
 		return CommitPage(Pages.Address, Pages.ReservedSize);
 	}
 	BIT_PANIC(); // Out of memory ??
@@ -187,6 +192,8 @@ void bit::PageAllocator::Free(void* Address)
 	{
 		FreePage(PageIndex);
 		size_t PageSize = GetPageSize(PageIndex);
+		Counters.OnFree((int64_t)PageSize);
+		LevelCounters[GetPageLevel(PageIndex)].OnFree((int64_t)PageSize);
 		DecommitPage(Address, PageSize); // Maybe I should batch this, specially if I coalesce free pages
 	}
 }
@@ -249,6 +256,24 @@ size_t bit::PageAllocator::GetPageSize()
 	return PageGranularity;
 }
 
+void bit::PageAllocator::GetStats(AllocatorStats& OutStats)
+{
+	OutStats = {};
+	OutStats.MemoryInfo = GetMemoryUsageInfo();
+	OutStats.FragmentationRatio = GetFragmentationRatio(OutStats.MemoryInfo);
+	Counters.Read(OutStats);
+}
+
+size_t bit::PageAllocator::GetSizeClassStats(SizeClassStats* OutStats, size_t MaxCount)
+{
+	size_t Count = bit::Min(LevelCount, MaxCount);
+	for (size_t Level = 0; Level < Count; ++Level)
+	{
+		OutStats[Level] = LevelCounters[Level].Read(VirtualAddress.GetReservedSize() >> Level);
+	}
+	return Count;
+}
+
 size_t bit::PageAllocator::FindPageRecursive(size_t PageIndex, size_t MinSize)
 {
 	size_t PageSize = GetPageSize(PageIndex);
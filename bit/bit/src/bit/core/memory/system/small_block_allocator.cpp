@@ -1,50 +1,146 @@
 #include <bit/core/memory/system/small_block_allocator.h>
 #include <bit/core/os/atomics.h>
+#include <bit/utility/scope_lock.h>
+
+bit::SmallBlockAllocator::ThreadHeap::ThreadHeap(void* Context) :
+	Context(Context)
+{
+	Memset(Pages, 0, sizeof(Pages));
+}
 
 bit::SmallBlockAllocator::SmallBlockAllocator() :
+	SharedHeap(nullptr),
 	PageDecommitList(nullptr),
 	PageFreeList(nullptr),
 	BaseVirtualAddress(nullptr),
 	BaseVirtualAddressOffset(0),
 	PageFreeListBytes(0),
-	AllocatedBytes(0),
 	CommittedBytes(0)
 {
-	VirtualAllocateBlock(ADDRESS_SPACE_SIZE, Memory);
+	// Reserve an extra page so the base can be aligned to PAGE_SIZE. Page bases
+	// are found by masking the block address.
+	VirtualAllocateBlock(ADDRESS_SPACE_SIZE + PAGE_SIZE, Memory);
 	BIT_ASSERT(Memory.GetBaseAddress() != nullptr);
-	Memset(Blocks, 0, sizeof(Blocks));
 	Memset(Pages, 0, sizeof(Pages));
-	BaseVirtualAddress = Memory.GetBaseAddress();
-	for (int64_t Index = 0; Index < NUM_OF_PAGES; ++Index)
+	BaseVirtualAddress = AlignPtr(Memory.GetBaseAddress(), PAGE_SIZE);
+	for (int64_t Index = 0; Index < (int64_t)NUM_OF_PAGES; ++Index)
 	{
 		Pages[Index].PageIndex = Index;
 	}
 }
 
+bit::SmallBlockAllocator::~SmallBlockAllocator()
+{
+	VirtualFreeBlock(Memory);
+}
+
 void* bit::SmallBlockAllocator::Allocate(size_t Size, size_t Alignment)
+{
+	bit::ScopedLock<bit::StatsMutex> Lock(&SharedHeapLock);
+	return Allocate(&SharedHeap, Size, Alignment);
+}
+
+void bit::SmallBlockAllocator::Free(void* Pointer)
+{
+	Free(nullptr, Pointer);
+}
+
+void* bit::SmallBlockAllocator::Allocate(ThreadHeap* Heap, size_t Size, size_t Alignment)
 {
 	size_t AlignedSize = AlignUint(Size, Max(MIN_ALLOCATION_SIZE, Alignment));
 	size_t BlockIndex = GetBlockIndex(AlignedSize);
-	FreeBlockLink* Block = GetFreeBlock(BlockIndex);
-	if (Block == nullptr)
+	PageMetadata* PageData = Heap->Pages[BlockIndex];
+	if (PageData == nullptr || !HasFreeBlocks(PageData))
+	{
+		PageData = FindPageWithFreeBlocks(Heap, BlockIndex);
+		if (PageData == nullptr)
+		{
+			PageData = AcquirePage(Heap, BlockIndex);
+			if (PageData == nullptr) return nullptr; // Out of address space
+		}
+	}
+	BIT_ASSERT(PageData != nullptr && HasFreeBlocks(PageData));
+	FreeBlockLink* Block = PageData->LocalFreeList;
+	if (Block != nullptr)
 	{
-		Block = GetFreeBlockFromNewPage(BlockIndex);
+		PageData->LocalFreeList = Block->NextBlock;
 	}
+	else
+	{
+		Block = (FreeBlockLink*)GetPageBaseByAddressByIndex((size_t)PageData->PageIndex);
+		Block = (FreeBlockLink*)OffsetPtr(Block, PageData->BumpOffset);
+		PageData->BumpOffset += PageData->AssignedSize;
+	}
+	PageData->AllocatedBytes += PageData->AssignedSize;
+	OnAlloc(BlockIndex, 1);
 	BIT_ASSERT(OwnsAllocation(Block));
-	BIT_ASSERT(Block != nullptr);
-	OnAlloc(BlockIndex, GetPageDataIndex(Block));
 	return Block;
 }
 
-void bit::SmallBlockAllocator::Free(void* Pointer)
+void bit::SmallBlockAllocator::Free(ThreadHeap* Heap, void* Pointer)
 {
 	if (OwnsAllocation(Pointer))
 	{
-		size_t BlockSize = GetPageData(Pointer)->AssignedSize;
-		size_t BlockIndex = GetBlockIndex(BlockSize);
-		FreeBlockLink* FreeBlock = reinterpret_cast<FreeBlockLink*>(Pointer);
-		PushBlockToFreeList(BlockIndex, FreeBlock);
-		OnFree(BlockIndex, GetPageDataIndex(Pointer));
+		PageMetadata* PageData = GetPageData(Pointer);
+		// Owner only changes on the owner thread or when a heap is abandoned
+		// to the shared heap so this comparison is stable for the caller.
+		ThreadHeap* Owner = PageData->Owner;
+		if (Owner == Heap && Heap != nullptr)
+		{
+			FreeLocal(Heap, PageData, Pointer);
+		}
+		else if (Owner == &SharedHeap)
+		{
+			bit::ScopedLock<bit::StatsMutex> Lock(&SharedHeapLock);
+			FreeLocal(&SharedHeap, PageData, Pointer);
+		}
+		else
+		{
+			FreeRemote(PageData, Pointer);
+		}
+	}
+}
+
+void bit::SmallBlockAllocator::CollectHeap(ThreadHeap* Heap)
+{
+	for (size_t BlockIndex = 0; BlockIndex < NUM_OF_SIZES; ++BlockIndex)
+	{
+		PageMetadata* Head = Heap->Pages[BlockIndex];
+		if (Head == nullptr) continue;
+		PageMetadata* PageData = Head->NextHeapPage;
+		while (PageData != Head)
+		{
+			PageMetadata* NextPageData = PageData->NextHeapPage;
+			ReclaimRemoteFrees(PageData);
+			if (PageData->AllocatedBytes == 0)
+			{
+				ReleasePage(Heap, PageData);
+			}
+			PageData = NextPageData;
+		}
+		ReclaimRemoteFrees(Head);
+	}
+}
+
+void bit::SmallBlockAllocator::AbandonHeap(ThreadHeap* Heap)
+{
+	for (size_t BlockIndex = 0; BlockIndex < NUM_OF_SIZES; ++BlockIndex)
+	{
+		while (PageMetadata* PageData = Heap->Pages[BlockIndex])
+		{
+			ReclaimRemoteFrees(PageData);
+			if (PageData->AllocatedBytes == 0)
+			{
+				ReleasePage(Heap, PageData);
+			}
+			else
+			{
+				UnlinkHeapPage(Heap, BlockIndex, PageData);
+				bit::ScopedLock<bit::StatsMutex> Lock(&SharedHeapLock);
+				PageData->Owner = &SharedHeap;
+				LinkHeapPage(&SharedHeap, BlockIndex, PageData);
+			}
+		}
 	}
 }
 
@@ -60,11 +156,23 @@ size_t bit::SmallBlockAllocator::GetSize(void* Pointer)
 bit::AllocatorMemoryInfo bit::SmallBlockAllocator::GetMemoryUsageInfo()
 {
 	AllocatorMemoryInfo Info = {};
-	Info.AllocatedBytes = AllocatedBytes;
+	// Summed from the pages instead of a shared counter so allocations never touch a
+	// cache line written by other threads. Pages past the offset were never handed out.
+	size_t UsedPageCount = (size_t)BaseVirtualAddressOffset / PAGE_SIZE;
+	for (size_t PageIndex = 0; PageIndex < UsedPageCount; ++PageIndex)
+	{
+		Info.AllocatedBytes += (size_t)Pages[PageIndex].AllocatedBytes;
+	}
 	Info.CommittedBytes = CommittedBytes;
+	Info.ReservedBytes = Memory.GetReservedSize();
 	return Info;
 }
 
+size_t bit::SmallBlockAllocator::GetAllocationSize(size_t Size, size_t Alignment)
+{
+	return GetBlockSize(GetBlockIndex(AlignUint(Size, Max(MIN_ALLOCATION_SIZE, Alignment))));
+}
+
 bool bit::SmallBlockAllocator::CanAllocate(size_t Size, size_t Alignment)
 {
 	return AlignUint(Size, Max(MIN_ALLOCATION_SIZE, Alignment)) <= MAX_ALLOCATION_SIZE;
@@ -72,73 +180,206 @@ bool bit::SmallBlockAllocator::CanAllocate(size_t Size, size_t Alignment)
 
 bool bit::SmallBlockAllocator::OwnsAllocation(const void* Ptr)
 {
-	return PtrInRange(Ptr, Memory.GetBaseAddress(), OffsetPtr(Memory.GetBaseAddress(), ADDRESS_SPACE_SIZE));
+	return PtrInRange(Ptr, BaseVirtualAddress, OffsetPtr(BaseVirtualAddress, ADDRESS_SPACE_SIZE));
 }
 
 size_t bit::SmallBlockAllocator::Compact()
 {
+	{
+		// Abandoned pages only get remote frees so nobody else will reclaim them
+		bit::ScopedLock<bit::StatsMutex> Lock(&SharedHeapLock);
+		CollectHeap(&SharedHeap);
+	}
+	bit::ScopedLock<bit::StatsMutex> Lock(&PageLock);
 	return DecommitFreePages();
 }
 
-bit::SmallBlockAllocator::FreeBlockLink* bit::SmallBlockAllocator::UnlinkFreeBlock(size_t BlockIndex, FreeBlockLink* FreeBlock)
+void bit::SmallBlockAllocator::GetStats(AllocatorStats& OutStats)
+{
+	OutStats = {};
+	OutStats.MemoryInfo = GetMemoryUsageInfo();
+	OutStats.FragmentationRatio = GetFragmentationRatio(OutStats.MemoryInfo);
+	Counters.Read(OutStats);
+	SharedHeapLock.Read(OutStats);
+	PageLock.Read(OutStats);
+}
+
+size_t bit::SmallBlockAllocator::GetSizeClassStats(SizeClassStats* OutStats, size_t MaxCount)
 {
-	if (FreeBlock->PrevBlock == nullptr)
+	size_t Count = Min(NUM_OF_SIZES, MaxCount);
+	for (size_t BlockIndex = 0; BlockIndex < Count; ++BlockIndex)
 	{
-		Blocks[BlockIndex].FreeList = FreeBlock->NextBlock;
-		if (FreeBlock->NextBlock != nullptr) FreeBlock->NextBlock->PrevBlock = nullptr;
+		OutStats[BlockIndex] = ClassCounters[BlockIndex].Read(GetBlockSize(BlockIndex));
+	}
+	return Count;
+}
+
+bit::SmallBlockAllocator::PageMetadata* bit::SmallBlockAllocator::FindPageWithFreeBlocks(ThreadHeap* Heap, size_t BlockIndex)
+{
+	// Rotate through the owned pages so pages that received remote frees
+	// eventually become the head again.
+	PageMetadata* PageData = Heap->Pages[BlockIndex];
+	for (int64_t Index = 0; PageData != nullptr && Index < MAX_RECLAIM_SCAN; ++Index)
+	{
+		ReclaimRemoteFrees(PageData);
+		if (HasFreeBlocks(PageData))
+		{
+			Heap->Pages[BlockIndex] = PageData;
+			return PageData;
+		}
+		PageData = PageData->NextHeapPage;
+		if (PageData == Heap->Pages[BlockIndex]) break;
+	}
+	if (PageData != nullptr) Heap->Pages[BlockIndex] = PageData;
+	return nullptr;
+}
+
+bit::SmallBlockAllocator::PageMetadata* bit::SmallBlockAllocator::AcquirePage(ThreadHeap* Heap, size_t BlockIndex)
+{
+	FreePageLink* Page = nullptr;
+	{
+		bit::ScopedLock<bit::StatsMutex> Lock(&PageLock);
+		Page = GetFreePage();
+	}
+	if (Page == nullptr) return nullptr;
+	PageMetadata* PageData = GetPageData(Page);
+	PageData->AssignedSize = GetBlockSize(BlockIndex);
+	PageData->AllocatedBytes = 0;
+	PageData->BumpOffset = 0;
+	PageData->LocalFreeList = nullptr;
+	PageData->RemoteFreeList = nullptr;
+	PageData->Owner = Heap;
+	LinkHeapPage(Heap, BlockIndex, PageData);
+	Heap->Pages[BlockIndex] = PageData;
+	return PageData;
+}
+
+void bit::SmallBlockAllocator::ReleasePage(ThreadHeap* Heap, PageMetadata* PageData)
+{
+	BIT_ASSERT(PageData->AllocatedBytes == 0 && PageData->RemoteFreeList == nullptr);
+	UnlinkHeapPage(Heap, GetBlockIndex(PageData->AssignedSize), PageData);
+	PageData->Owner = nullptr;
+	PageData->LocalFreeList = nullptr;
+	bit::ScopedLock<bit::StatsMutex> Lock(&PageLock);
+	FreePage((size_t)PageData->PageIndex);
+}
+
+void bit::SmallBlockAllocator::LinkHeapPage(ThreadHeap* Heap, size_t BlockIndex, PageMetadata* PageData)
+{
+	PageMetadata* Head = Heap->Pages[BlockIndex];
+	if (Head == nullptr)
+	{
+		PageData->PrevHeapPage = PageData;
+		PageData->NextHeapPage = PageData;
+		Heap->Pages[BlockIndex] = PageData;
 	}
 	else
 	{
-		FreeBlock->PrevBlock->NextBlock = FreeBlock->NextBlock;
-		if (FreeBlock->NextBlock != nullptr) FreeBlock->NextBlock->PrevBlock = FreeBlock->PrevBlock;
+		PageData->PrevHeapPage = Head->PrevHeapPage;
+		PageData->NextHeapPage = Head;
+		Head->PrevHeapPage->NextHeapPage = PageData;
+		Head->PrevHeapPage = PageData;
 	}
-	FreeBlock->PrevBlock = nullptr;
-	FreeBlock->NextBlock = nullptr;
-	return FreeBlock;
 }
 
-void bit::SmallBlockAllocator::OnAlloc(size_t BlockIndex, size_t PageIndex)
+void bit::SmallBlockAllocator::UnlinkHeapPage(ThreadHeap* Heap, size_t BlockIndex, PageMetadata* PageData)
 {
-	int64_t BlockSize = (int64_t)GetBlockSize(BlockIndex);
-	AtomicAdd(&Blocks[BlockIndex].AllocatedBytes, BlockSize);
-	AtomicAdd(&Pages[PageIndex].AllocatedBytes, BlockSize);
-	AtomicAdd(&AllocatedBytes, BlockSize);
+	if (PageData->NextHeapPage == PageData)
+	{
+		Heap->Pages[BlockIndex] = nullptr;
+	}
+	else
+	{
+		PageData->PrevHeapPage->NextHeapPage = PageData->NextHeapPage;
+		PageData->NextHeapPage->PrevHeapPage = PageData->PrevHeapPage;
+		if (Heap->Pages[BlockIndex] == PageData) Heap->Pages[BlockIndex] = PageData->NextHeapPage;
+	}
+	PageData->PrevHeapPage = nullptr;
+	PageData->NextHeapPage = nullptr;
 }
 
-void bit::SmallBlockAllocator::OnFree(size_t BlockIndex, size_t PageIndex)
+void bit::SmallBlockAllocator::ReclaimRemoteFrees(PageMetadata* PageData)
 {
-	int64_t BlockSize = (int64_t)GetBlockSize(BlockIndex);
-	AtomicAdd(&Blocks[BlockIndex].AllocatedBytes, -BlockSize);
-	AtomicAdd(&Pages[PageIndex].AllocatedBytes, -BlockSize);
-	AtomicAdd(&AllocatedBytes, -BlockSize);
+	if (AtomicLoadInline(&PageData->RemoteFreeList) == nullptr) return;
+	FreeBlockLink* RemoteList = (FreeBlockLink*)AtomicExchange((void**)&PageData->RemoteFreeList, nullptr);
+	if (RemoteList == nullptr) return;
 
-	BIT_ASSERT(Pages[PageIndex].AllocatedBytes >= 0);
-	if (Pages[PageIndex].AllocatedBytes == 0)
+	int64_t Count = 1;
+	FreeBlockLink* Tail = RemoteList;
+	while (Tail->NextBlock != nullptr)
 	{
-		FreePage(PageIndex);
+		Tail = Tail->NextBlock;
+		Count += 1;
 	}
+	Tail->NextBlock = PageData->LocalFreeList;
+	PageData->LocalFreeList = RemoteList;
+	PageData->AllocatedBytes -= Count * (int64_t)PageData->AssignedSize;
+	BIT_ASSERT(PageData->AllocatedBytes >= 0);
+	OnFree(GetBlockIndex(PageData->AssignedSize), Count);
 }
 
-void bit::SmallBlockAllocator::FreePage(size_t PageIndex)
+void bit::SmallBlockAllocator::FreeLocal(ThreadHeap* Heap, PageMetadata* PageData, void* Pointer)
 {
-	FreePageLink* Page = (FreePageLink*)GetPageBaseByAddressByIndex(PageIndex);
-	PageMetadata* PageData = &Pages[PageIndex];
-	size_t BlockSize = PageData->AssignedSize;
-	size_t BlockIndex = GetBlockIndex(BlockSize);
-	size_t BlockCount = PAGE_SIZE / BlockSize;
-	BlockMetadata* BlockData = &Blocks[BlockIndex];
-	FreeBlockLink* BlockHead = reinterpret_cast<FreeBlockLink*>(Page);
-
-	for (size_t Index = 0; Index < BlockCount; ++Index)
+	FreeBlockLink* FreeBlock = reinterpret_cast<FreeBlockLink*>(Pointer);
+	FreeBlock->NextBlock = PageData->LocalFreeList;
+	PageData->LocalFreeList = FreeBlock;
+	PageData->AllocatedBytes -= PageData->AssignedSize;
+	BIT_ASSERT(PageData->AllocatedBytes >= 0);
+	size_t BlockIndex = GetBlockIndex(PageData->AssignedSize);
+	OnFree(BlockIndex, 1);
+
+	if (PageData->AllocatedBytes == 0)
 	{
-		UnlinkFreeBlock(BlockIndex, (FreeBlockLink*)OffsetPtr(BlockHead, Index * BlockSize));
+		// Keep the head page around even if empty to avoid thrashing on alloc/free pairs.
+		// Rewind it instead so carving restarts from the already touched blocks.
+		if (Heap->Pages[BlockIndex] != PageData)
+		{
+			ReleasePage(Heap, PageData);
+		}
+		else
+		{
+			PageData->LocalFreeList = nullptr;
+			PageData->BumpOffset = 0;
+		}
 	}
+}
+
+void bit::SmallBlockAllocator::FreeRemote(PageMetadata* PageData, void* Pointer)
+{
+	FreeBlockLink* FreeBlock = reinterpret_cast<FreeBlockLink*>(Pointer);
+	void** Target = (void**)&PageData->RemoteFreeList;
+	void* Head = nullptr;
+	void* CurrentHead = AtomicLoad(Target);
+	do
+	{
+		Head = CurrentHead;
+		FreeBlock->NextBlock = (FreeBlockLink*)Head;
+		CurrentHead = AtomicCompareExchange(Target, (void*)FreeBlock, Head);
+	} while (CurrentHead != Head);
+}
+
+void bit::SmallBlockAllocator::OnAlloc(size_t BlockIndex, int64_t Count)
+{
+	int64_t Bytes = (int64_t)GetBlockSize(BlockIndex) * Count;
+	ClassCounters[BlockIndex].OnAlloc(Bytes, Count);
+	Counters.OnAlloc(Bytes, Count);
+}
+
+void bit::SmallBlockAllocator::OnFree(size_t BlockIndex, int64_t Count)
+{
+	int64_t Bytes = (int64_t)GetBlockSize(BlockIndex) * Count;
+	ClassCounters[BlockIndex].OnFree(Bytes, Count);
+	Counters.OnFree(Bytes, Count);
+}
 
+void bit::SmallBlockAllocator::FreePage(size_t PageIndex)
+{
+	FreePageLink* Page = (FreePageLink*)GetPageBaseByAddressByIndex(PageIndex);
 	Page->NextPage = PageFreeList;
 	PageFreeList = Page;
 
 	AtomicAdd(&PageFreeListBytes, PAGE_SIZE);
-	if (PageFreeListBytes >= MIN_DECOMMIT_SIZE)
+	if (PageFreeListBytes >= (int64_t)MIN_DECOMMIT_SIZE)
 	{
 		DecommitFreePages();
 	}
@@ -151,6 +392,7 @@ size_t bit::SmallBlockAllocator::DecommitFreePages()
 	{
 		FreePageLink* NextFreePage = FreePage->NextPage;
 		Memory.DecommitPagesByAddress(FreePage, PAGE_SIZE);
+		Counters.OnDecommit();
 
 		PageMetadata* PageData = GetPageData(FreePage);
 		PageData->NextFreePage = PageDecommitList;
@@ -166,9 +408,14 @@ size_t bit::SmallBlockAllocator::DecommitFreePages()
 }
 
 
+bool bit::SmallBlockAllocator::HasFreeBlocks(const PageMetadata* PageData) const
+{
+	return PageData->LocalFreeList != nullptr || PageData->BumpOffset + PageData->AssignedSize <= PAGE_SIZE;
+}
+
 size_t bit::SmallBlockAllocator::GetBlockSize(size_t BlockIndex)
 {
-	return (BlockIndex + 1) * MIN_ALLOCATION_SIZE;
+	return SizeClasses_t::GetClassSize(BlockIndex);
 }
 
 void* bit::SmallBlockAllocator::GetPageBaseByAddressByIndex(size_t PageIndex)
@@ -197,38 +444,16 @@ bit::SmallBlockAllocator::PageMetadata* bit::SmallBlockAllocator::GetPageData(co
 
 size_t bit::SmallBlockAllocator::GetBlockIndex(size_t BlockSize)
 {
-	if (BlockSize <= MIN_ALLOCATION_SIZE) return 0;
-	else if ((BlockSize % MIN_ALLOCATION_SIZE) == 0) return BlockSize / MIN_ALLOCATION_SIZE - 1;
-	return ((BlockSize / MIN_ALLOCATION_SIZE + 1) * MIN_ALLOCATION_SIZE) / MIN_ALLOCATION_SIZE - 1;
-}
-
-void bit::SmallBlockAllocator::PushBlockToFreeList(size_t BlockIndex, FreeBlockLink* FreeBlock)
-{
-	if (Blocks[BlockIndex].FreeList != nullptr)
-	{
-		Blocks[BlockIndex].FreeList->PrevBlock = FreeBlock;
-	}
-	FreeBlock->NextBlock = Blocks[BlockIndex].FreeList;
-	Blocks[BlockIndex].FreeList = FreeBlock;
-	FreeBlock->PrevBlock = nullptr;
-}
-
-bit::SmallBlockAllocator::FreeBlockLink* bit::SmallBlockAllocator::GetFreeBlock(size_t BlockIndex)
-{
-	if (Blocks[BlockIndex].FreeList != nullptr)
-	{
-		FreeBlockLink* FreeBlock = UnlinkFreeBlock(BlockIndex, Blocks[BlockIndex].FreeList);
-		return FreeBlock;
-	}
-	return nullptr;
+	return SizeClasses_t::GetClassIndex(BlockSize);
 }
 
 bit::SmallBlockAllocator::FreePageLink* bit::SmallBlockAllocator::AllocateNewPage()
 {
-	BIT_ASSERT(BaseVirtualAddressOffset + PAGE_SIZE <= ADDRESS_SPACE_SIZE); // Out of virtual address space
+	if (BaseVirtualAddressOffset + PAGE_SIZE > ADDRESS_SPACE_SIZE) return nullptr; // Out of virtual address space
 	size_t PageDataIndex = (BaseVirtualAddressOffset) / PAGE_SIZE;
 	void* Page = OffsetPtr(BaseVirtualAddress, BaseVirtualAddressOffset);
-	Memory.CommitPagesByAddress(Page, PAGE_SIZE);
+	if (Memory.CommitPagesByAddress(Page, PAGE_SIZE) == nullptr) return nullptr;
+	Counters.OnCommit();
 	AtomicAdd(&BaseVirtualAddressOffset, PAGE_SIZE);
 	AtomicAdd(&CommittedBytes, PAGE_SIZE);
 	Pages[PageDataIndex].AllocatedBytes = 0;
@@ -253,26 +478,10 @@ bit::SmallBlockAllocator::FreePageLink* bit::SmallBlockAllocator::GetFreePage()
 		FreePage->NextFreePage = nullptr;
 		FreePageLink* Page = (FreePageLink*)GetPageBaseByAddressByIndex(FreePage->PageIndex);
 		Memory.CommitPagesByAddress(Page, PAGE_SIZE);
+		Counters.OnCommit();
 		AtomicAdd(&CommittedBytes, PAGE_SIZE);
 		return Page;
 	}
 
 	return AllocateNewPage();
 }
-
-bit::SmallBlockAllocator::FreeBlockLink* bit::SmallBlockAllocator::GetFreeBlockFromNewPage(size_t BlockIndex)
-{
-	FreePageLink* Page = GetFreePage();
-	PageMetadata* PageData = GetPageData(Page);
-	FreeBlockLink* BlockHead = reinterpret_cast<FreeBlockLink*>(Page);
-	size_t BlockSize = GetBlockSize(BlockIndex);
-	size_t BlockCount = PAGE_SIZE / BlockSize;
-
-	for (size_t Index = 0; Index < BlockCount; ++Index)
-	{
-		PushBlockToFreeList(BlockIndex, (FreeBlockLink*)OffsetPtr(BlockHead, Index * BlockSize));
-	}
-
-	PageData->AssignedSize = BlockSize;
-	return GetFreeBlock(BlockIndex);
-}
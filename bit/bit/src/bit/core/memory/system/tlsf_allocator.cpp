@@ -9,6 +9,7 @@
 bit::TLSFAllocator::TLSFAllocator() :
 	FLBitmap(0),
 	PagesInUse(nullptr),
+	FreeRangeCount(0),
 	VirtualMemoryBaseAddress(nullptr),
 	PagesInUseCount(0),
 	VirtualMemoryBaseOffset(0),
@@ -66,6 +67,7 @@ void* bit::TLSFAllocator::Allocate(size_t Size, size_t Alignment)
 		}
 
 		UsedSpaceInBytes += Block->GetSize();
+		OnBlockAllocated(Block->GetSize());
 	#if BIT_ENABLE_BLOCK_MARKING
 		FillBlock(Block, 0xAA);
 	#endif
@@ -109,6 +111,7 @@ void* bit::TLSFAllocator::AllocateAligned(uint64_t Size, uint64_t Alignment)
 		}
 
 		UsedSpaceInBytes += Block->GetSize();
+		OnBlockAllocated(Block->GetSize());
 	#if BIT_ENABLE_BLOCK_MARKING
 		FillBlock(Block, 0xAA);
 	#endif
@@ -121,14 +124,44 @@ void* bit::TLSFAllocator::AllocateAligned(uint64_t Size, uint64_t Alignment)
 void* bit::TLSFAllocator::Reallocate(void* Pointer, size_t Size, size_t Alignment)
 {
 	if (Pointer == nullptr) return Allocate(Size, Alignment);
-	size_t BlockSize = GetSize(Pointer);
-	if (BlockSize == Size) return Pointer;
+	if (bit::IsAddressAligned(Pointer, bit::Max(Alignment, alignof(BlockHeader))) && ResizeInPlace(Pointer, Size))
+	{
+		return Pointer;
+	}
+	uint64_t BlockSize = GetBlockHeaderFromPointer(Pointer)->GetSize();
 	void* NewBlock = Allocate(Size, Alignment);
-	bit::Memcpy(NewBlock, Pointer, bit::Min(BlockSize, Size));
-	Free(Pointer);
+	if (NewBlock != nullptr)
+	{
+		bit::Memcpy(NewBlock, Pointer, bit::Min(BlockSize, (uint64_t)Size));
+		Free(Pointer);
+	}
 	return NewBlock;
 }
 
+bool bit::TLSFAllocator::ResizeInPlace(void* Pointer, size_t Size)
+{
+	if (Pointer == nullptr) return false;
+	BlockFreeHeader* Block = GetBlockHeaderFromPointer(Pointer);
+	uint64_t BlockSize = Block->GetSize();
+	uint64_t RoundedSize = (uint64_t)bit::Max((uint64_t)RoundToSlotSize(Size), MIN_ALLOCATION_SIZE);
+	uint64_t AlignedSize = (uint64_t)bit::AlignUint(RoundedSize, alignof(BlockHeader));
+	// Resizes in place are counted as a free of the old block and an allocation of the new one
+	if (AlignedSize <= BlockSize)
+	{
+		ShrinkBlock(Block, AlignedSize);
+		OnBlockFreed(BlockSize);
+		OnBlockAllocated(Block->GetSize());
+		return true;
+	}
+	if (GrowBlock(Block, AlignedSize))
+	{
+		OnBlockFreed(BlockSize);
+		OnBlockAllocated(Block->GetSize());
+		return true;
+	}
+	return false;
+}
+
 void bit::TLSFAllocator::Free(void* Pointer)
 {
 	if (Pointer != nullptr)
@@ -138,6 +171,7 @@ void bit::TLSFAllocator::Free(void* Pointer)
 		FillBlock(FreeBlock, 0xDD);
 	#endif
 		UsedSpaceInBytes -= FreeBlock->GetSize();
+		OnBlockFreed(FreeBlock->GetSize());
 		BlockFreeHeader* MergedBlock = Merge(FreeBlock);
 
 		if (!FreeVirtualMemory(MergedBlock))
@@ -182,13 +216,49 @@ size_t bit::TLSFAllocator::Compact()
 	return Total;
 }
 
+void bit::TLSFAllocator::GetStats(AllocatorStats& OutStats)
+{
+	OutStats = {};
+	OutStats.MemoryInfo = GetMemoryUsageInfo();
+	OutStats.FragmentationRatio = GetFragmentationRatio(OutStats.MemoryInfo);
+	Counters.Read(OutStats);
+}
+
+size_t bit::TLSFAllocator::GetSizeClassStats(SizeClassStats* OutStats, size_t MaxCount)
+{
+	size_t Count = bit::Min((size_t)FL_COUNT, MaxCount);
+	for (size_t Index = 0; Index < Count; ++Index)
+	{
+		OutStats[Index] = ClassCounters[Index].Read(1ULL << (Index + COUNT_OFFSET - 1));
+	}
+	return Count;
+}
+
+void bit::TLSFAllocator::OnBlockAllocated(uint64_t BlockSize)
+{
+	BIT_IF_CONSTEXPR (BIT_ALLOCATOR_STATS != 0)
+	{
+		Counters.OnAlloc((int64_t)BlockSize);
+		ClassCounters[bit::Min(Mapping(BlockSize).FL, FL_COUNT - 1)].OnAlloc((int64_t)BlockSize);
+	}
+}
+
+void bit::TLSFAllocator::OnBlockFreed(uint64_t BlockSize)
+{
+	BIT_IF_CONSTEXPR (BIT_ALLOCATOR_STATS != 0)
+	{
+		Counters.OnFree((int64_t)BlockSize);
+		ClassCounters[bit::Min(Mapping(BlockSize).FL, FL_COUNT - 1)].OnFree((int64_t)BlockSize);
+	}
+}
+
 size_t bit::TLSFAllocator::RoundToSlotSize(size_t Size)
 {
 	BlockMap Map = MappingNoOffset(Size);
 	size_t MinSize = 1ULL << Map.FL;
 	size_t MaxSize = bit::NextPow2(MinSize+1);
 	size_t RangeDiff = MaxSize - MinSize;
-	size_t SlotStep = RangeDiff / SL_COUNT;
+	size_t SlotStep = bit::Max(RangeDiff / SL_COUNT, (size_t)alignof(BlockHeader)); // Ranges below 2^SLI are narrower than SL_COUNT bytes
 	size_t RoundedSize = bit::AlignUint(Size, SlotStep);
 	return RoundedSize;
 }
@@ -203,7 +273,7 @@ bit::TLSFAllocator::BlockMap bit::TLSFAllocator::MappingNoOffset(size_t Size) co
 	//       / |..|	
 	//    FL    SL
 	// FL = 8, SL = 12
-	uint64_t SL = ((Size ^ (1ULL << FL)) >> (FL - SLI));
+	uint64_t SL = FL >= SLI ? ((Size ^ (1ULL << FL)) >> (FL - SLI)) : ((Size ^ (1ULL << FL)) << (SLI - FL));
 	return { FL, SL };
 }
 
@@ -212,10 +282,16 @@ void bit::TLSFAllocator::AllocateVirtualMemory(size_t Size)
 	size_t PageSize = GetOSPageSize();
 	size_t AdjustedSize = Size + sizeof(BlockHeader) + sizeof(BlockFreeHeader) + sizeof(VirtualPage);
 	size_t AlignedSize = bit::RoundUp(bit::AlignUint(AdjustedSize, alignof(BlockHeader)), PageSize);
-	void* CommittedPages = Memory.CommitPagesByAddress(bit::OffsetPtr(VirtualMemoryBaseAddress, VirtualMemoryBaseOffset), AlignedSize);
-	if (CommittedPages != nullptr)
+	size_t PageOffset = 0;
+	if (!AcquireVirtualRange(AlignedSize, PageOffset)) return; // Out of address space
+	void* CommittedPages = Memory.CommitPagesByAddress(bit::OffsetPtr(VirtualMemoryBaseAddress, PageOffset), AlignedSize);
+	if (CommittedPages == nullptr)
+	{
+		ReleaseVirtualRange(PageOffset, AlignedSize);
+	}
+	else
 	{
-		VirtualMemoryBaseOffset += AlignedSize;
+		Counters.OnCommit();
 
 		VirtualPage* PageInfo = reinterpret_cast<VirtualPage*>(CommittedPages);
 		PageInfo->PageSize = AlignedSize;
@@ -258,6 +334,8 @@ bool bit::TLSFAllocator::FreeVirtualMemory(BlockFreeHeader* FreeBlock)
 	if (FreeBlock->PrevPhysicalBlock->IsLastPhysicalBlock() && GetNextBlock(FreeBlock)->IsLastPhysicalBlock())
 	{
 		VirtualPage* Page = reinterpret_cast<VirtualPage*>(FreeBlock->PrevPhysicalBlock);
+		// Keep the page committed if there's no room left to track its address range
+		if (!ReleaseVirtualRange(bit::PtrDiff(VirtualMemoryBaseAddress, Page), Page->PageSize)) return false;
 		if (Page->Prev != nullptr) Page->Prev->Next = Page->Next;
 		else PagesInUse = Page->Next;
 
@@ -267,6 +345,7 @@ bool bit::TLSFAllocator::FreeVirtualMemory(BlockFreeHeader* FreeBlock)
 		{
 			PagesInUseCount -= 1;
 		}
+		Counters.OnDecommit();
 		return true;
 	}
 	return false;
@@ -464,6 +543,36 @@ bit::TLSFAllocator::BlockFreeHeader* bit::TLSFAllocator::GetNextBlock(BlockFreeH
 	return bit::OffsetPtr<BlockFreeHeader>(Block, Block->GetSize() + sizeof(BlockHeader));
 }
 
+void bit::TLSFAllocator::ShrinkBlock(BlockFreeHeader* Block, uint64_t Size)
+{
+	uint64_t BlockSize = Block->GetSize();
+	// Only split if the tail can hold a header and a minimum sized block
+	if (BlockSize - Size >= sizeof(BlockHeader) + MIN_ALLOCATION_SIZE)
+	{
+		BlockFreeHeader* RemainingBlock = Split(Block, Size);
+		if (RemainingBlock != Block)
+		{
+			UsedSpaceInBytes -= BlockSize - Block->GetSize();
+			BlockFreeHeader* MergedBlock = Merge(RemainingBlock);
+			InsertBlock(MergedBlock, Mapping(MergedBlock->GetSize()));
+		}
+	}
+}
+
+bool bit::TLSFAllocator::GrowBlock(BlockFreeHeader* Block, uint64_t Size)
+{
+	BlockFreeHeader* Next = GetNextBlock(Block);
+	if (Next->GetSize() > 0 && Next->IsFree() && Block->GetSize() + Next->GetFullSize() >= Size)
+	{
+		RemoveBlock(Next, Mapping(Next->GetSize()));
+		UsedSpaceInBytes += Next->GetFullSize();
+		MergeBlocks(Block, Next);
+		ShrinkBlock(Block, Size);
+		return true;
+	}
+	return false;
+}
+
 size_t bit::TLSFAllocator::AdjustSize(size_t Size)
 {
 	return sizeof(BlockHeader) + Size;
@@ -474,3 +583,71 @@ void bit::TLSFAllocator::FillBlock(BlockHeader* Block, uint8_t Value) const
 	/* For debugging purpose */
 	bit::Memset(GetPointerFromBlockHeader(Block), Value, Block->GetSize());
 }
+
+bool bit::TLSFAllocator::AcquireVirtualRange(size_t Size, size_t& OutOffset)
+{
+	for (size_t Index = 0; Index < FreeRangeCount; ++Index)
+	{
+		VirtualRange& Range = FreeRanges[Index];
+		if (Range.Size >= Size)
+		{
+			OutOffset = Range.Offset;
+			Range.Offset += Size;
+			Range.Size -= Size;
+			if (Range.Size == 0) RemoveVirtualRange(Index);
+			return true;
+		}
+	}
+	if (VirtualMemoryBaseOffset + Size > ADDRESS_SPACE_SIZE) return false;
+	OutOffset = VirtualMemoryBaseOffset;
+	VirtualMemoryBaseOffset += Size;
+	return true;
+}
+
+bool bit::TLSFAllocator::ReleaseVirtualRange(size_t Offset, size_t Size)
+{
+	if (Offset + Size == VirtualMemoryBaseOffset)
+	{
+		// Hand the range back to the bump offset together with a free range right before it.
+		// Tracked ranges never reach the bump offset.
+		VirtualMemoryBaseOffset = Offset;
+		if (FreeRangeCount > 0 && FreeRanges[FreeRangeCount - 1].Offset + FreeRanges[FreeRangeCount - 1].Size == Offset)
+		{
+			VirtualMemoryBaseOffset = FreeRanges[FreeRangeCount - 1].Offset;
+			FreeRangeCount -= 1;
+		}
+		return true;
+	}
+	size_t Index = 0;
+	while (Index < FreeRangeCount && FreeRanges[Index].Offset < Offset) Index += 1;
+	bool bMergePrev = Index > 0 && FreeRanges[Index - 1].Offset + FreeRanges[Index - 1].Size == Offset;
+	bool bMergeNext = Index < FreeRangeCount && Offset + Size == FreeRanges[Index].Offset;
+	if (bMergePrev && bMergeNext)
+	{
+		FreeRanges[Index - 1].Size += Size + FreeRanges[Index].Size;
+		RemoveVirtualRange(Index);
+	}
+	else if (bMergePrev)
+	{
+		FreeRanges[Index - 1].Size += Size;
+	}
+	else if (bMergeNext)
+	{
+		FreeRanges[Index].Offset = Offset;
+		FreeRanges[Index].Size += Size;
+	}
+	else
+	{
+		if (FreeRangeCount == MAX_FREE_RANGES) return false;
+		for (size_t Move = FreeRangeCount; Move > Index; --Move) FreeRanges[Move] = FreeRanges[Move - 1];
+		FreeRanges[Index] = { Offset, Size };
+		FreeRangeCount += 1;
+	}
+	return true;
+}
+
+void bit::TLSFAllocator::RemoveVirtualRange(size_t Index)
+{
+	for (size_t Move = Index + 1; Move < FreeRangeCount; ++Move) FreeRanges[Move - 1] = FreeRanges[Move];
+	FreeRangeCount -= 1;
+}
@@ -0,0 +1,100 @@
+#include <bit/core/os/os.h>
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define BIT_HAS_CPUID 1
+#if BIT_PLATFORM_WINDOWS
+#include <intrin.h>
+#include <immintrin.h>
+#else
+#include <cpuid.h>
+#endif
+#else
+#define BIT_HAS_CPUID 0
+#endif
+
+#if BIT_HAS_CPUID
+static void BitCPUID(uint32_t Leaf, uint32_t SubLeaf, uint32_t Regs[4])
+{
+#if BIT_PLATFORM_WINDOWS
+	__cpuidex((int*)Regs, (int)Leaf, (int)SubLeaf);
+#else
+	__cpuid_count(Leaf, SubLeaf, Regs[0], Regs[1], Regs[2], Regs[3]);
+#endif
+}
+
+static uint64_t BitXGetBV()
+{
+#if BIT_PLATFORM_WINDOWS
+	return _xgetbv(0);
+#else
+	uint32_t Low = 0;
+	uint32_t High = 0;
+	__asm__ volatile("xgetbv" : "=a"(Low), "=d"(High) : "c"(0));
+	return ((uint64_t)High << 32) | Low;
+#endif
+}
+
+/* Deterministic cache parameters (leaf 4) on Intel, the legacy L2/L3 leaf on AMD */
+static size_t BitQueryLastLevelCacheSize(uint32_t MaxLeaf)
+{
+	uint32_t Regs[4];
+	size_t Largest = 0;
+	if (MaxLeaf >= 4)
+	{
+		for (uint32_t SubLeaf = 0; SubLeaf < 16; ++SubLeaf)
+		{
+			BitCPUID(4, SubLeaf, Regs);
+			uint32_t Type = Regs[0] & 0x1F;
+			if (Type == 0) break;
+			if (Type == 2) continue; // Instruction cache
+			size_t Ways = ((Regs[1] >> 22) & 0x3FF) + 1;
+			size_t Partitions = ((Regs[1] >> 12) & 0x3FF) + 1;
+			size_t LineSize = (Regs[1] & 0xFFF) + 1;
+			size_t Sets = (size_t)Regs[2] + 1;
+			size_t Size = Ways * Partitions * LineSize * Sets;
+			if (Size > Largest) Largest = Size;
+		}
+	}
+	if (Largest == 0)
+	{
+		BitCPUID(0x80000000, 0, Regs);
+		if (Regs[0] >= 0x80000006)
+		{
+			BitCPUID(0x80000006, 0, Regs);
+			size_t L2Size = (size_t)(Regs[2] >> 16) * 1024;
+			size_t L3Size = (size_t)(Regs[3] >> 18) * 512 * 1024;
+			Largest = L3Size > L2Size ? L3Size : L2Size;
+		}
+	}
+	return Largest;
+}
+#endif
+
+static bit::ProcessorFeatures BitQueryProcessorFeatures()
+{
+	bit::ProcessorFeatures Features = {};
+#if BIT_HAS_CPUID
+	uint32_t Regs[4];
+	BitCPUID(0, 0, Regs);
+	uint32_t MaxLeaf = Regs[0];
+	BitCPUID(1, 0, Regs);
+	Features.bSSE2 = ((Regs[3] >> 26) & 1) != 0;
+	Features.bSSE42 = ((Regs[2] >> 20) & 1) != 0;
+	bool bOSSavesYMM = ((Regs[2] >> 27) & 1) != 0 && ((Regs[2] >> 28) & 1) != 0 && (BitXGetBV() & 6) == 6;
+	if (MaxLeaf >= 7)
+	{
+		BitCPUID(7, 0, Regs);
+		Features.bAVX2 = bOSSavesYMM && ((Regs[1] >> 5) & 1) != 0;
+		Features.bERMS = ((Regs[1] >> 9) & 1) != 0;
+		Features.bFSRM = ((Regs[3] >> 4) & 1) != 0;
+	}
+	Features.LastLevelCacheSize = BitQueryLastLevelCacheSize(MaxLeaf);
+#endif
+	return Features;
+}
+
+const bit::ProcessorFeatures& bit::GetOSProcessorFeatures()
+{
+	static ProcessorFeatures Features = BitQueryProcessorFeatures();
+	return Features;
+}
@@ -0,0 +1,130 @@
+#include <bit/core/os/atomics.h>
+#include "../../posix_common.h"
+
+int64_t bit::AtomicExchange(int64_t* Target, int64_t Value)
+{
+	return __atomic_exchange_n(Target, Value, __ATOMIC_SEQ_CST);
+}
+
+int64_t bit::AtomicCompareExchange(int64_t* Target, int64_t Value, int64_t Comperand)
+{
+	__atomic_compare_exchange_n(Target, &Comperand, Value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return Comperand;
+}
+
+int64_t bit::AtomicAdd(int64_t* Target, int64_t Value)
+{
+	return __atomic_fetch_add(Target, Value, __ATOMIC_SEQ_CST);
+}
+
+int64_t bit::AtomicSubtract(int64_t* Target, int64_t Value)
+{
+	return __atomic_fetch_sub(Target, Value, __ATOMIC_SEQ_CST);
+}
+
+int64_t bit::AtomicIncrement(int64_t* Target)
+{
+	return __atomic_add_fetch(Target, 1, __ATOMIC_SEQ_CST);
+}
+
+int64_t bit::AtomicDecrement(int64_t* Target)
+{
+	return __atomic_sub_fetch(Target, 1, __ATOMIC_SEQ_CST);
+}
+
+int64_t bit::AtomicPostIncrement(int64_t* Target)
+{
+	return __atomic_fetch_add(Target, 1, __ATOMIC_SEQ_CST);
+}
+
+int64_t bit::AtomicPostDecrement(int64_t* Target)
+{
+	return __atomic_fetch_sub(Target, 1, __ATOMIC_SEQ_CST);
+}
+
+int64_t bit::AtomicLoad(const int64_t* Target)
+{
+	return __atomic_load_n(Target, __ATOMIC_ACQUIRE);
+}
+
+void bit::AtomicStore(int64_t* Target, int64_t Value)
+{
+	__atomic_store_n(Target, Value, __ATOMIC_RELEASE);
+}
+
+int32_t bit::AtomicExchange(int32_t* Target, int32_t Value)
+{
+	return __atomic_exchange_n(Target, Value, __ATOMIC_SEQ_CST);
+}
+
+int32_t bit::AtomicCompareExchange(int32_t* Target, int32_t Value, int32_t Comperand)
+{
+	__atomic_compare_exchange_n(Target, &Comperand, Value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return Comperand;
+}
+
+int32_t bit::AtomicAdd(int32_t* Target, int32_t Value)
+{
+	return __atomic_fetch_add(Target, Value, __ATOMIC_SEQ_CST);
+}
+
+int32_t bit::AtomicSubtract(int32_t* Target, int32_t Value)
+{
+	return __atomic_fetch_sub(Target, Value, __ATOMIC_SEQ_CST);
+}
+
+int32_t bit::AtomicIncrement(int32_t* Target)
+{
+	return __atomic_add_fetch(Target, 1, __ATOMIC_SEQ_CST);
+}
+
+int32_t bit::AtomicDecrement(int32_t* Target)
+{
+	return __atomic_sub_fetch(Target, 1, __ATOMIC_SEQ_CST);
+}
+
+int32_t bit::AtomicPostIncrement(int32_t* Target)
+{
+	return __atomic_fetch_add(Target, 1, __ATOMIC_SEQ_CST);
+}
+
+int32_t bit::AtomicPostDecrement(int32_t* Target)
+{
+	return __atomic_fetch_sub(Target, 1, __ATOMIC_SEQ_CST);
+}
+
+int32_t bit::AtomicLoad(const int32_t* Target)
+{
+	return __atomic_load_n(Target, __ATOMIC_ACQUIRE);
+}
+
+void bit::AtomicStore(int32_t* Target, int32_t Value)
+{
+	__atomic_store_n(Target, Value, __ATOMIC_RELEASE);
+}
+
+void* bit::AtomicExchange(void** Target, void* Value)
+{
+	return __atomic_exchange_n(Target, Value, __ATOMIC_SEQ_CST);
+}
+
+void* bit::AtomicCompareExchange(void** Target, void* Value, void* Comperand)
+{
+	__atomic_compare_exchange_n(Target, &Comperand, Value, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+	return Comperand;
+}
+
+void* bit::AtomicLoad(void* const* Target)
+{
+	return __atomic_load_n(Target, __ATOMIC_ACQUIRE);
+}
+
+void bit::AtomicStore(void** Target, void* Value)
+{
+	__atomic_store_n(Target, Value, __ATOMIC_RELEASE);
+}
+
+void bit::AtomicFence()
+{
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+}
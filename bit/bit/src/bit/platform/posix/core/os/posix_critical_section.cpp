@@ -0,0 +1,36 @@
+#include <bit/core/os/critical_section.h>
+#include <bit/core/memory.h>
+#include "../../posix_common.h"
+
+bit::CriticalSection::CriticalSection() :
+	Handle(nullptr)
+{
+	Handle = Malloc(sizeof(pthread_mutex_t), alignof(pthread_mutex_t));
+	pthread_mutexattr_t Attributes;
+	pthread_mutexattr_init(&Attributes);
+	/* Windows critical sections can be re-entered by the owning thread */
+	pthread_mutexattr_settype(&Attributes, PTHREAD_MUTEX_RECURSIVE);
+	pthread_mutex_init((pthread_mutex_t*)Handle, &Attributes);
+	pthread_mutexattr_destroy(&Attributes);
+}
+
+bit::CriticalSection::~CriticalSection()
+{
+	pthread_mutex_destroy((pthread_mutex_t*)Handle);
+	Free(Handle);
+}
+
+void bit::CriticalSection::Lock()
+{
+	pthread_mutex_lock((pthread_mutex_t*)Handle);
+}
+
+void bit::CriticalSection::Unlock()
+{
+	pthread_mutex_unlock((pthread_mutex_t*)Handle);
+}
+
+bool bit::CriticalSection::TryLock()
+{
+	return pthread_mutex_trylock((pthread_mutex_t*)Handle) == 0;
+}
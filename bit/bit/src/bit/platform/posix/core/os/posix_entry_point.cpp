@@ -0,0 +1,10 @@
+#include <bit/core/types.h>
+#include "../../posix_common.h"
+
+extern void BitOSInit();
+
+/* Shared objects don't get a DllMain, so we use a constructor that runs at load time. */
+__attribute__((constructor)) static void BitPosixEntryPoint()
+{
+	BitOSInit();
+}
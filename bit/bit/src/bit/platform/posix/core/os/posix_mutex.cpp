@@ -0,0 +1,56 @@
+#include <bit/core/os/mutex.h>
+#include "../../posix_common.h"
+
+/* Futex based mutex. The state lives in the handle itself so constructing a 
+   Mutex never allocates (MemoryManager owns one). 
+   0 = unlocked, 1 = locked, 2 = locked with waiters */
+
+static int32_t* BitGetMutexState(bit::Handle_t* Handle)
+{
+	return reinterpret_cast<int32_t*>(Handle);
+}
+
+bit::Mutex::Mutex()
+{
+	Handle = nullptr;
+}
+
+bit::Mutex::~Mutex()
+{
+}
+
+void bit::Mutex::Lock()
+{
+	int32_t* State = BitGetMutexState(&Handle);
+	int32_t Expected = 0;
+	if (__atomic_compare_exchange_n(State, &Expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+	{
+		return;
+	}
+	if (Expected != 2)
+	{
+		Expected = __atomic_exchange_n(State, 2, __ATOMIC_ACQUIRE);
+	}
+	while (Expected != 0)
+	{
+		BitFutexWait(State, 2);
+		Expected = __atomic_exchange_n(State, 2, __ATOMIC_ACQUIRE);
+	}
+}
+
+bool bit::Mutex::TryLock()
+{
+	int32_t* State = BitGetMutexState(&Handle);
+	int32_t Expected = 0;
+	return __atomic_compare_exchange_n(State, &Expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+void bit::Mutex::Unlock()
+{
+	int32_t* State = BitGetMutexState(&Handle);
+	if (__atomic_fetch_sub(State, 1, __ATOMIC_RELEASE) != 1)
+	{
+		__atomic_store_n(State, 0, __ATOMIC_RELEASE);
+		BitFutexWake(State, 1);
+	}
+}
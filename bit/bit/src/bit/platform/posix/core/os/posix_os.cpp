@@ -0,0 +1,154 @@
+#include <bit/core/os/debug.h>
+#include <bit/core/os/os.h>
+#include <bit/core/memory.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../../posix_common.h"
+#include <sys/resource.h>
+#if BIT_PLATFORM_LINUX
+#include <sys/sysinfo.h>
+#endif
+
+void BitOSInit()
+{
+	bit::GetGlobalAllocator();
+}
+
+size_t bit::GetOSPageSize()
+{
+	static size_t PageSize = (size_t)sysconf(_SC_PAGESIZE);
+	return PageSize;
+}
+
+size_t bit::GetOSAllocationGranularity()
+{
+	/* mmap works at page granularity, there's no 64 KiB reservation rule like on Windows */
+	return GetOSPageSize();
+}
+
+void* bit::GetOSMinAddress()
+{
+	return (void*)GetOSPageSize();
+}
+
+void* bit::GetOSMaxAddress()
+{
+#if BIT_PLATFORM_X64
+	return (void*)0x00007FFFFFFFFFFFULL;
+#else
+	return (void*)0xBFFFFFFFUL;
+#endif
+}
+
+int32_t bit::GetOSProcessorCount()
+{
+	static int32_t ProcessorCount = (int32_t)sysconf(_SC_NPROCESSORS_ONLN);
+	return ProcessorCount;
+}
+
+bit::ProcessorArch bit::GetOSProcessorArch()
+{
+#if defined(__x86_64__)
+	return bit::ProcessorArch::PROC_ARCH_X64;
+#elif defined(__i386__)
+	return bit::ProcessorArch::PROC_ARCH_X86;
+#elif defined(__aarch64__)
+	return bit::ProcessorArch::PROC_ARCH_ARM64;
+#elif defined(__arm__)
+	return bit::ProcessorArch::PROC_ARCH_ARM;
+#else
+	return bit::ProcessorArch::PROC_ARCH_UNKNOWN;
+#endif
+}
+
+#if BIT_PLATFORM_LINUX
+static size_t BitReadProcStatusKiB(const char* Status, const char* Field)
+{
+	const char* Line = strstr(Status, Field);
+	if (Line == nullptr) return 0;
+	return (size_t)strtoull(Line + strlen(Field), nullptr, 10) * 1024;
+}
+#endif
+
+bit::ProcessMemoryInfo bit::GetOSProcessMemoryInfo()
+{
+	ProcessMemoryInfo Info = {};
+	Info.PageSize = GetOSPageSize();
+	Info.AllocationGranularity = GetOSAllocationGranularity();
+
+#if BIT_PLATFORM_LINUX
+	FILE* StatusFile = fopen("/proc/self/status", "r");
+	if (StatusFile != nullptr)
+	{
+		char Status[4096] = {};
+		size_t ReadSize = fread(Status, 1, sizeof(Status) - 1, StatusFile);
+		Status[ReadSize] = 0;
+		fclose(StatusFile);
+		Info.PhysicalUsedInBytes = BitReadProcStatusKiB(Status, "VmRSS:");
+		Info.PhysicalPeakUsedInBytes = BitReadProcStatusKiB(Status, "VmHWM:");
+		Info.VirtualUsedInBytes = BitReadProcStatusKiB(Status, "VmSize:");
+		Info.VirtualPeakUsedInBytes = BitReadProcStatusKiB(Status, "VmPeak:");
+	}
+
+	struct sysinfo SysInfo = {};
+	if (sysinfo(&SysInfo) == 0)
+	{
+		Info.PhysicalTotalInBytes = (size_t)SysInfo.totalram * SysInfo.mem_unit;
+		Info.VirtualTotalInBytes = (size_t)(SysInfo.totalram + SysInfo.totalswap) * SysInfo.mem_unit;
+	}
+#else
+	struct rusage Usage = {};
+	if (getrusage(RUSAGE_SELF, &Usage) == 0)
+	{
+		Info.PhysicalPeakUsedInBytes = (size_t)Usage.ru_maxrss;
+	}
+#endif
+
+	return Info;
+}
+
+void bit::OutputLog(const char* Fmt, ...)
+{
+	static char Buffer[4096 * 3] = {};
+	static uint32_t Index = 0;
+	char* CurrBuffer = &Buffer[Index * 4096];
+	va_list VaArgs;
+	va_start(VaArgs, Fmt);
+	vsnprintf(CurrBuffer, 4096, Fmt, VaArgs);
+	printf("%s", CurrBuffer);
+	va_end(VaArgs);
+	Index = (Index + 1) % 3;
+}
+
+void bit::Alert(const char* Fmt, ...)
+{
+	static char Buffer[4096 * 3] = {};
+	static uint32_t Index = 0;
+	char* CurrBuffer = &Buffer[Index * 4096];
+	va_list VaArgs;
+	va_start(VaArgs, Fmt);
+	vsnprintf(CurrBuffer, 4096, Fmt, VaArgs);
+	fprintf(stderr, "Alert: %s", CurrBuffer);
+	fflush(stderr);
+	Index = (Index + 1) % 3;
+	va_end(VaArgs);
+}
+
+void bit::ExitProgram(int32_t ExitCode)
+{
+	_exit(ExitCode);
+}
+
+double bit::GetSeconds()
+{
+	struct timespec Time;
+	clock_gettime(CLOCK_MONOTONIC, &Time);
+	return (double)Time.tv_sec + (double)Time.tv_nsec / 1000000000.0;
+}
+
+int32_t bit::GetOSErrorCode()
+{
+	return (int32_t)errno;
+}
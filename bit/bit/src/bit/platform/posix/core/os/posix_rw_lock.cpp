@@ -0,0 +1,118 @@
+#include <bit/core/os/rw_lock.h>
+#include "../../posix_common.h"
+
+/* Futex based reader/writer lock. Like the SRWLOCK on Windows the whole
+   state fits in the handle. 
+   Bits 0-29 are the reader count, bit 30 flags waiters and bit 31 is the writer. */
+
+static constexpr uint32_t RW_WRITER_BIT = 0x80000000u;
+static constexpr uint32_t RW_WAITER_BIT = 0x40000000u;
+static constexpr uint32_t RW_READER_MASK = 0x3FFFFFFFu;
+
+static uint32_t* BitGetRWState(bit::Handle_t* Handle)
+{
+	return reinterpret_cast<uint32_t*>(Handle);
+}
+
+static void BitRWWait(uint32_t* State, uint32_t Observed)
+{
+	/* Flag that somebody is sleeping so the unlocking thread knows it has to wake us */
+	if ((Observed & RW_WAITER_BIT) == 0)
+	{
+		if (!__atomic_compare_exchange_n(State, &Observed, Observed | RW_WAITER_BIT, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+		{
+			return;
+		}
+		Observed |= RW_WAITER_BIT;
+	}
+	BitFutexWait((int32_t*)State, (int32_t)Observed);
+}
+
+static void BitRWWake(uint32_t* State)
+{
+	uint32_t Observed = __atomic_load_n(State, __ATOMIC_RELAXED);
+	while ((Observed & RW_WAITER_BIT) != 0 && (Observed & (RW_WRITER_BIT | RW_READER_MASK)) == 0)
+	{
+		if (__atomic_compare_exchange_n(State, &Observed, 0, false, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+		{
+			BitFutexWake((int32_t*)State, 0x7FFFFFFF);
+			return;
+		}
+	}
+}
+
+bit::RWLock::RWLock()
+{
+	Handle = nullptr;
+}
+
+bit::RWLock::~RWLock()
+{}
+
+void bit::RWLock::LockRead()
+{
+	uint32_t* State = BitGetRWState(&Handle);
+	while (!TryLockRead())
+	{
+		uint32_t Observed = __atomic_load_n(State, __ATOMIC_RELAXED);
+		if ((Observed & RW_WRITER_BIT) != 0)
+		{
+			BitRWWait(State, Observed);
+		}
+	}
+}
+
+void bit::RWLock::UnlockRead()
+{
+	uint32_t* State = BitGetRWState(&Handle);
+	__atomic_fetch_sub(State, 1, __ATOMIC_RELEASE);
+	BitRWWake(State);
+}
+
+void bit::RWLock::LockWrite()
+{
+	uint32_t* State = BitGetRWState(&Handle);
+	while (!TryLockWrite())
+	{
+		uint32_t Observed = __atomic_load_n(State, __ATOMIC_RELAXED);
+		if ((Observed & (RW_WRITER_BIT | RW_READER_MASK)) != 0)
+		{
+			BitRWWait(State, Observed);
+		}
+	}
+}
+
+void bit::RWLock::UnlockWrite()
+{
+	uint32_t* State = BitGetRWState(&Handle);
+	__atomic_fetch_and(State, ~RW_WRITER_BIT, __ATOMIC_RELEASE);
+	BitRWWake(State);
+}
+
+bool bit::RWLock::TryLockRead()
+{
+	uint32_t* State = BitGetRWState(&Handle);
+	uint32_t Observed = __atomic_load_n(State, __ATOMIC_RELAXED);
+	while ((Observed & RW_WRITER_BIT) == 0)
+	{
+		if (__atomic_compare_exchange_n(State, &Observed, Observed + 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool bit::RWLock::TryLockWrite()
+{
+	uint32_t* State = BitGetRWState(&Handle);
+	uint32_t Observed = __atomic_load_n(State, __ATOMIC_RELAXED);
+	while ((Observed & (RW_WRITER_BIT | RW_READER_MASK)) == 0)
+	{
+		if (__atomic_compare_exchange_n(State, &Observed, Observed | RW_WRITER_BIT, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+		{
+			return true;
+		}
+	}
+	return false;
+}
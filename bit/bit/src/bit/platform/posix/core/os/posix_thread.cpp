@@ -0,0 +1,140 @@
+#include <bit/core/os/thread.h>
+#include <bit/core/memory.h>
+#include "../../posix_common.h"
+
+struct ThreadPayload
+{
+	bit::Thread::ThreadFunc_t Func;
+	void* UserData;
+	pthread_t NativeThread;
+	int32_t ThreadId;
+	bool bJoined;
+};
+
+static void* BitThreadEntry(void* Data)
+{
+	ThreadPayload* Payload = (ThreadPayload*)Data;
+	__atomic_store_n(&Payload->ThreadId, bit::Thread::GetCurrentThreadId(), __ATOMIC_RELEASE);
+	if (Payload->Func != nullptr)
+	{
+		return (void*)(intptr_t)Payload->Func(Payload->UserData);
+	}
+	return nullptr;
+}
+
+bit::Thread::Thread(Thread&& MoveRef) :
+	Handle(MoveRef.Handle),
+	UserPayload(MoveRef.UserPayload)
+{
+	MoveRef.Handle = nullptr;
+	MoveRef.UserPayload = nullptr;
+}
+
+bit::Thread::Thread() :
+	Handle(nullptr),
+	UserPayload(nullptr)
+{
+}
+
+bit::Thread::~Thread()
+{
+	if (Handle != nullptr)
+	{
+		Join();
+		Handle = nullptr;
+	}
+	if (UserPayload != nullptr)
+	{
+		bit::Free(UserPayload);
+	}
+}
+
+void bit::Thread::Start(ThreadFunc_t Func, size_t StackSize, void* UserData)
+{
+	ThreadPayload* Payload = bit::Malloc<ThreadPayload>();
+	Payload->Func = Func;
+	Payload->UserData = UserData;
+	Payload->ThreadId = 0;
+	Payload->bJoined = false;
+	UserPayload = Payload;
+
+	pthread_attr_t Attributes;
+	pthread_attr_init(&Attributes);
+	if (StackSize > 0)
+	{
+		/* pthreads won't go below PTHREAD_STACK_MIN, Windows rounds up silently */
+		pthread_attr_setstacksize(&Attributes, bit::Max(StackSize, (size_t)PTHREAD_STACK_MIN));
+	}
+	if (pthread_create(&Payload->NativeThread, &Attributes, BitThreadEntry, Payload) == 0)
+	{
+		Handle = (Handle_t)Payload;
+	}
+	pthread_attr_destroy(&Attributes);
+}
+
+void bit::Thread::Join()
+{
+	ThreadPayload* Payload = (ThreadPayload*)Handle;
+	if (Payload != nullptr && !Payload->bJoined)
+	{
+		pthread_join(Payload->NativeThread, nullptr);
+		Payload->bJoined = true;
+	}
+}
+
+int32_t bit::Thread::GetId()
+{
+	ThreadPayload* Payload = (ThreadPayload*)Handle;
+	if (Payload == nullptr) return 0;
+	int32_t ThreadId = 0;
+	while ((ThreadId = __atomic_load_n(&Payload->ThreadId, __ATOMIC_ACQUIRE)) == 0)
+	{
+		sched_yield();
+	}
+	return ThreadId;
+}
+
+bool bit::Thread::IsValid()
+{
+	return Handle != nullptr;
+}
+
+bit::Handle_t bit::Thread::GetHandle()
+{
+	return Handle;
+}
+
+bit::Thread& bit::Thread::operator=(Thread&& MoveRef)
+{
+	Handle = MoveRef.Handle;
+	UserPayload = MoveRef.UserPayload;
+	MoveRef.Handle = nullptr;
+	MoveRef.UserPayload = nullptr;
+	return *this;
+}
+
+/*static*/ int32_t bit::Thread::GetCurrentThreadId()
+{
+#if BIT_PLATFORM_LINUX
+	return (int32_t)syscall(SYS_gettid);
+#else
+	return (int32_t)(intptr_t)pthread_self();
+#endif
+}
+
+/*static*/ void bit::Thread::YieldThread()
+{
+#if defined(__x86_64__) || defined(__i386__)
+	__builtin_ia32_pause();
+#else
+	sched_yield();
+#endif
+}
+
+void bit::Thread::SleepThread(uint32_t Milliseconds)
+{
+	struct timespec Time;
+	Time.tv_sec = Milliseconds / 1000;
+	Time.tv_nsec = (long)(Milliseconds % 1000) * 1000000L;
+	while (nanosleep(&Time, &Time) == -1 && errno == EINTR);
+}
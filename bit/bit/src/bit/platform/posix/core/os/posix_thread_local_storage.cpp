@@ -0,0 +1,30 @@
+#include <bit/core/os/debug.h>
+#include <bit/core/os/thread_local_storage.h>
+#include "../../posix_common.h"
+
+static_assert(sizeof(pthread_key_t) <= sizeof(bit::TlsHandle), "pthread_key_t doesn't fit in TlsHandle");
+
+bit::TlsHandle bit::TlsAllocSlot(TlsDestructor_t Destructor)
+{
+	pthread_key_t Key = 0;
+	if (pthread_key_create(&Key, Destructor) != 0)
+	{
+		return INVALID_TLS_HANDLE;
+	}
+	return (TlsHandle)Key;
+}
+
+void bit::TlsFreeSlot(TlsHandle Handle)
+{
+	pthread_key_delete((pthread_key_t)Handle);
+}
+
+void bit::TlsSetValue(TlsHandle Handle, void* Value)
+{
+	pthread_setspecific((pthread_key_t)Handle, Value);
+}
+
+void* bit::TlsGetValue(TlsHandle Handle)
+{
+	return pthread_getspecific((pthread_key_t)Handle);
+}
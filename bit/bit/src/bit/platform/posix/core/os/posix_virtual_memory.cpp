@@ -0,0 +1,306 @@
+#include <bit/core/os/virtual_memory.h>
+#include <bit/core/memory.h>
+#include <bit/core/os/debug.h>
+#include <bit/core/os/os.h>
+#include "../../posix_common.h"
+
+/* Reserved memory is mapped as PROT_NONE so it doesn't count against the commit
+   charge. Committing flips the protection and decommitting gives the physical
+   pages back to the kernel with MADV_DONTNEED. */
+
+static int BitGetProtection(bit::PageProtectionType ProtectionType)
+{
+	switch (ProtectionType)
+	{
+	case bit::PageProtectionType::PROTECTION_TYPE_READ_WRITE: return PROT_READ | PROT_WRITE;
+	case bit::PageProtectionType::PROTECTION_TYPE_READ_ONLY: return PROT_READ;
+	}
+	return PROT_READ;
+}
+
+static void* BitPageAlignDown(void* Address)
+{
+	return (void*)((uintptr_t)Address & ~((uintptr_t)bit::GetOSPageSize() - 1));
+}
+
+static size_t BitPageAlignSize(void* Address, void* AlignedAddress, size_t Size)
+{
+	return bit::RoundUp(Size + bit::PtrDiff(Address, AlignedAddress), bit::GetOSPageSize());
+}
+
+bit::VirtualMemoryBlock::VirtualMemoryBlock() :
+	BaseAddress(nullptr),
+	ReservedSize(0),
+	CommittedSize(0)
+{
+}
+
+bit::VirtualMemoryBlock::VirtualMemoryBlock(void* BaseAddress, size_t ReservedSize) :
+	BaseAddress(BaseAddress),
+	ReservedSize(ReservedSize),
+	CommittedSize(0)
+{}
+
+bit::VirtualMemoryBlock::VirtualMemoryBlock(VirtualMemoryBlock&& Move)
+{
+	BaseAddress = Move.BaseAddress;
+	ReservedSize = Move.ReservedSize;
+	CommittedSize = Move.CommittedSize;
+	Move.Invalidate();
+}
+
+bit::VirtualMemoryBlock& bit::VirtualMemoryBlock::operator=(VirtualMemoryBlock&& Move)
+{
+	BaseAddress = Move.BaseAddress;
+	ReservedSize = Move.ReservedSize;
+	CommittedSize = Move.CommittedSize;
+	Move.Invalidate();
+	return *this;
+}
+
+void* bit::VirtualMemoryBlock::CommitAll()
+{
+	if (mprotect(BaseAddress, ReservedSize, PROT_READ | PROT_WRITE) == 0)
+	{
+		CommittedSize = ReservedSize;
+		return BaseAddress;
+	}
+	return nullptr;
+}
+
+bool bit::VirtualMemoryBlock::DecommitAll()
+{
+	if (madvise(BaseAddress, ReservedSize, MADV_DONTNEED) == 0 &&
+		mprotect(BaseAddress, ReservedSize, PROT_NONE) == 0)
+	{
+		CommittedSize = 0;
+		return true;
+	}
+	return false;
+}
+
+void* bit::VirtualMemoryBlock::CommitPagesByAddress(void* Address, size_t Size)
+{
+	if (bit::PtrInRange(Address, BaseAddress, GetEndAddress()) && Size <= bit::PtrDiff(Address, GetEndAddress()))
+	{
+		void* PageAddress = BitPageAlignDown(Address);
+		if (mprotect(PageAddress, BitPageAlignSize(Address, PageAddress, Size), PROT_READ | PROT_WRITE) == 0)
+		{
+			CommittedSize += Size;
+			return Address;
+		}
+	}
+	return nullptr;
+}
+
+bool bit::VirtualMemoryBlock::DecommitPagesByAddress(void* Address, size_t Size)
+{
+	if (bit::PtrInRange(Address, BaseAddress, GetEndAddress()) && Size <= bit::PtrDiff(Address, GetEndAddress()))
+	{
+		void* PageAddress = BitPageAlignDown(Address);
+		size_t PageSize = BitPageAlignSize(Address, PageAddress, Size);
+		if (madvise(PageAddress, PageSize, MADV_DONTNEED) == 0 &&
+			mprotect(PageAddress, PageSize, PROT_NONE) == 0)
+		{
+			CommittedSize -= Size;
+			BIT_ASSERT(CommittedSize >= 0);
+			return true;
+		}
+		return false;
+	}
+	return false;
+}
+
+bool bit::VirtualMemoryBlock::ProtectPagesByAddress(void* Address, size_t Size, PageProtectionType Protection)
+{
+	if (bit::PtrInRange(Address, BaseAddress, GetEndAddress()) && Size <= bit::PtrDiff(Address, GetEndAddress()))
+	{
+		void* PageAddress = BitPageAlignDown(Address);
+		return mprotect(PageAddress, BitPageAlignSize(Address, PageAddress, Size), BitGetProtection(Protection)) == 0;
+	}
+	return false;
+}
+
+bool bit::VirtualMemoryBlock::ZeroPagesByAddress(void* Address, size_t Size)
+{
+	if (bit::PtrInRange(Address, BaseAddress, GetEndAddress()) && Size <= bit::PtrDiff(Address, GetEndAddress()))
+	{
+		uint8_t* Begin = (uint8_t*)Address;
+		uint8_t* End = Begin + Size;
+		uint8_t* PagesBegin = (uint8_t*)bit::AlignPtr(Begin, bit::GetOSPageSize());
+		uint8_t* PagesEnd = (uint8_t*)BitPageAlignDown(End);
+		if (Size < ZERO_PAGES_MIN_SIZE || PagesBegin >= PagesEnd)
+		{
+			bit::StreamZero(Begin, Size);
+			return true;
+		}
+		size_t PagesSize = bit::PtrDiff(PagesBegin, PagesEnd);
+		// Private anonymous pages read back as zero after MADV_DONTNEED
+		if (madvise(PagesBegin, PagesSize, MADV_DONTNEED) != 0)
+		{
+			return false;
+		}
+		bit::StreamZero(Begin, bit::PtrDiff(Begin, PagesBegin));
+		bit::StreamZero(PagesEnd, bit::PtrDiff(PagesEnd, End));
+		return true;
+	}
+	return false;
+}
+
+void* bit::VirtualMemoryBlock::CommitPagesByOffset(size_t Offset, size_t Size)
+{
+	return CommitPagesByAddress(GetAddress(Offset), Size);
+}
+
+bool bit::VirtualMemoryBlock::DecommitPagesByOffset(size_t Offset, size_t Size)
+{
+	return DecommitPagesByAddress(GetAddress(Offset), Size);
+}
+
+bool bit::VirtualMemoryBlock::ProtectPagesByOffset(size_t Offset, size_t Size, PageProtectionType Protection)
+{
+	return ProtectPagesByAddress(GetAddress(Offset), Size, Protection);
+}
+
+bool bit::VirtualMemoryBlock::ZeroPagesByOffset(size_t Offset, size_t Size)
+{
+	return ZeroPagesByAddress(GetAddress(Offset), Size);
+}
+
+void* bit::VirtualMemoryBlock::GetBaseAddress() const
+{
+	return BaseAddress;
+}
+
+void* bit::VirtualMemoryBlock::GetAddress(size_t Offset) const
+{
+	return bit::OffsetPtr(BaseAddress, Offset);
+}
+
+void* bit::VirtualMemoryBlock::GetEndAddress() const
+{
+	return bit::OffsetPtr(BaseAddress, ReservedSize);
+}
+
+size_t bit::VirtualMemoryBlock::GetReservedSize() const
+{
+	return ReservedSize;
+}
+
+size_t bit::VirtualMemoryBlock::GetCommittedSize() const
+{
+	return CommittedSize;
+}
+
+size_t bit::VirtualMemoryBlock::GetPageCount() const
+{
+	return ReservedSize / bit::GetOSPageSize();
+}
+
+bool bit::VirtualMemoryBlock::IsValid() const
+{ 
+	return BaseAddress != nullptr; 
+}
+
+void bit::VirtualMemoryBlock::Invalidate()
+{
+	BaseAddress = nullptr;
+	ReservedSize = 0;
+	CommittedSize = 0;
+}
+
+bool bit::VirtualMemoryBlock::OwnsAddress(const void* Ptr) const
+{
+	return bit::PtrInRange(Ptr, GetBaseAddress(), GetEndAddress());
+}
+
+bool bit::VirtualAllocateBlock(void* Address, size_t Size, VirtualMemoryBlock& OutVirtualMemoryBlock)
+{
+	size_t ReservedSize = bit::RoundUp(Size, bit::GetOSPageSize());
+	void* Ptr = mmap(Address, ReservedSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (Ptr == MAP_FAILED) return false;
+	BitPlacementNew(&OutVirtualMemoryBlock) VirtualMemoryBlock(Ptr, ReservedSize);
+	return true;
+}
+
+bool bit::VirtualAllocateBlock(size_t Size, VirtualMemoryBlock& OutVirtualMemoryBlock)
+{
+	return VirtualAllocateBlock(nullptr, Size, OutVirtualMemoryBlock);
+}
+
+void bit::VirtualFreeBlock(bit::VirtualMemoryBlock& VirtualMemoryRegion)
+{
+	if (VirtualMemoryRegion.IsValid())
+	{
+		munmap(VirtualMemoryRegion.GetBaseAddress(), VirtualMemoryRegion.GetReservedSize());
+	}
+}
+
+#if defined(MAP_HUGETLB) && !defined(MAP_HUGE_SHIFT)
+#define MAP_HUGE_SHIFT 26
+#endif
+
+static void* BitMapHugeTLB(size_t Size, size_t PageSizeLog2)
+{
+#if defined(MAP_HUGETLB)
+	/* Fails right away if the huge page pool can't back the whole mapping */
+	void* Ptr = mmap(nullptr, Size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (int)(PageSizeLog2 << MAP_HUGE_SHIFT), -1, 0);
+	if (Ptr != MAP_FAILED) return Ptr;
+#endif
+	return nullptr;
+}
+
+void* bit::VirtualAllocateLargePages(size_t Size, size_t& OutSize, LargePageType& OutPageType)
+{
+	constexpr size_t SIZE_2MIB = 2 MiB;
+	constexpr size_t SIZE_1GIB = 1 GiB;
+
+	// Only use 1 GiB pages if rounding up wastes less than an eighth of the request
+	size_t Size1GiB = bit::RoundUp(Size, SIZE_1GIB);
+	if (Size >= SIZE_1GIB && (Size1GiB - Size) <= Size / 8)
+	{
+		if (void* Ptr = BitMapHugeTLB(Size1GiB, 30))
+		{
+			OutSize = Size1GiB;
+			OutPageType = LargePageType::LARGE_PAGE_TYPE_1GIB;
+			return Ptr;
+		}
+	}
+
+	size_t Size2MiB = bit::RoundUp(Size, SIZE_2MIB);
+	if (void* Ptr = BitMapHugeTLB(Size2MiB, 21))
+	{
+		OutSize = Size2MiB;
+		OutPageType = LargePageType::LARGE_PAGE_TYPE_2MIB;
+		return Ptr;
+	}
+
+	// No huge page pool. Map 2 MiB aligned regular pages so transparent 
+	// huge pages can back the whole range.
+	size_t MapSize = Size2MiB + SIZE_2MIB;
+	void* Ptr = mmap(nullptr, MapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (Ptr == MAP_FAILED) return nullptr;
+	void* AlignedPtr = bit::AlignPtr(Ptr, SIZE_2MIB);
+	size_t HeadSize = bit::PtrDiff(Ptr, AlignedPtr);
+	size_t TailSize = MapSize - HeadSize - Size2MiB;
+	if (HeadSize > 0) munmap(Ptr, HeadSize);
+	if (TailSize > 0) munmap(bit::OffsetPtr(AlignedPtr, Size2MiB), TailSize);
+
+	OutSize = Size2MiB;
+	OutPageType = LargePageType::LARGE_PAGE_TYPE_NONE;
+#if defined(MADV_HUGEPAGE)
+	if (madvise(AlignedPtr, Size2MiB, MADV_HUGEPAGE) == 0)
+	{
+		OutPageType = LargePageType::LARGE_PAGE_TYPE_TRANSPARENT;
+	}
+#endif
+	return AlignedPtr;
+}
+
+void bit::VirtualFreeLargePages(void* Address, size_t Size)
+{
+	if (Address != nullptr)
+	{
+		munmap(Address, Size);
+	}
+}
@@ -0,0 +1,28 @@
+#include <bit/core/memory.h>
+#include <bit/core/memory/allocator.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "../posix_common.h"
+
+size_t bit::Fmt(char* Buffer, size_t BufferSize, const char* Fmt, ...)
+{
+	va_list VaArgs;
+	va_start(VaArgs, Fmt);
+	int32_t Written = vsnprintf(Buffer, BufferSize, Fmt, VaArgs);
+	va_end(VaArgs);
+	return (size_t)Written;
+}
+
+const char* bit::TempFmtString(const char* Fmt, ...)
+{
+	static char Buffer[4096 * 3] = {};
+	static uint32_t Index = 0;
+	char* CurrBuffer = &Buffer[Index * 4096];
+	va_list VaArgs;
+	va_start(VaArgs, Fmt);
+	vsnprintf(CurrBuffer, 4096, Fmt, VaArgs);
+	va_end(VaArgs);
+	Index = (Index + 1) % 3;
+	return CurrBuffer;
+}
@@ -0,0 +1,66 @@
+#include <bit/utility/utility.h>
+#include "../../posix_common.h"
+
+template<> uint64_t bit::BitScanReverse<uint64_t>(uint64_t Value) { return BitScanReverse64(Value); }
+template<> uint32_t bit::BitScanReverse<uint32_t>(uint32_t Value) { return BitScanReverse32(Value); }
+template<> uint16_t bit::BitScanReverse<uint16_t>(uint16_t Value) { return BitScanReverse32((uint32_t)Value); }
+template<> uint64_t bit::BitScanForward<uint64_t>(uint64_t Value) { return BitScanForward64(Value); }
+template<> uint32_t bit::BitScanForward<uint32_t>(uint32_t Value) { return BitScanForward32(Value); }
+template<> uint16_t bit::BitScanForward<uint16_t>(uint16_t Value) { return BitScanForward32((uint32_t)Value); }
+
+template<>
+uint16_t bit::Pow2<uint16_t>(uint16_t Exp)
+{
+	return 1 << Exp;
+}
+
+template<>
+uint32_t bit::Pow2<uint32_t>(uint32_t Exp)
+{
+	return 1 << Exp;
+}
+
+template<>
+uint64_t bit::Pow2<uint64_t>(uint64_t Exp)
+{
+	return 1ULL << Exp;
+}
+
+template<> int64_t bit::BitScanReverse<int64_t>(int64_t Value) { return BitScanReverse64((uint64_t)Value); }
+template<> int32_t bit::BitScanReverse<int32_t>(int32_t Value) { return BitScanReverse32((uint32_t)Value); }
+template<> int64_t bit::BitScanForward<int64_t>(int64_t Value) { return BitScanForward64((uint64_t)Value); }
+template<> int32_t bit::BitScanForward<int32_t>(int32_t Value) { return BitScanForward32((uint32_t)Value); }
+
+uint64_t bit::BitScanReverse64(uint64_t Value)
+{
+	if (Value == 0) return 64;
+	return 63 - (uint64_t)__builtin_clzll(Value);
+}
+
+uint32_t bit::BitScanReverse32(uint32_t Value)
+{
+	if (Value == 0) return 32;
+	return 31 - (uint32_t)__builtin_clz(Value);
+}
+
+uint64_t bit::BitScanForward64(uint64_t Value)
+{
+	if (Value == 0) return 64;
+	return (uint64_t)__builtin_ctzll(Value);
+}
+
+uint32_t bit::BitScanForward32(uint32_t Value)
+{
+	if (Value == 0) return 32;
+	return (uint32_t)__builtin_ctz(Value);
+}
+
+size_t bit::GetAddressAlignment(const void* Address)
+{
+	uintptr_t Value = (uintptr_t)Address;
+	if (Value > 1 && (Value & 0b1) == 0)
+	{
+		return (size_t)1 << __builtin_ctzll((unsigned long long)Value);
+	}
+	return 0;
+}
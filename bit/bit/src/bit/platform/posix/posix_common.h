@@ -0,0 +1,40 @@
+#pragma once
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif
+
+#include <bit/core/types.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#if BIT_PLATFORM_LINUX
+#include <linux/futex.h>
+
+static inline long BitFutexWait(int32_t* Address, int32_t Expected)
+{
+	return syscall(SYS_futex, Address, FUTEX_WAIT_PRIVATE, Expected, nullptr, nullptr, 0);
+}
+
+static inline long BitFutexWake(int32_t* Address, int32_t Count)
+{
+	return syscall(SYS_futex, Address, FUTEX_WAKE_PRIVATE, Count, nullptr, nullptr, 0);
+}
+#else
+static inline long BitFutexWait(int32_t* Address, int32_t Expected)
+{
+	sched_yield();
+	return 0;
+}
+
+static inline long BitFutexWake(int32_t* Address, int32_t Count)
+{
+	return 0;
+}
+#endif
@@ -41,6 +41,20 @@ int64_t bit::AtomicPostDecrement(int64_t* Target)
     return InterlockedExchangeAdd64(Target, -1);
 }
 
+// Aligned loads and stores are atomic on x86/x64. The barrier keeps the compiler from reordering around them.
+int64_t bit::AtomicLoad(const int64_t* Target)
+{
+    int64_t Value = *(const volatile int64_t*)Target;
+    _ReadWriteBarrier();
+    return Value;
+}
+
+void bit::AtomicStore(int64_t* Target, int64_t Value)
+{
+    _ReadWriteBarrier();
+    *(volatile int64_t*)Target = Value;
+}
+
 int32_t bit::AtomicExchange(int32_t* Target, int32_t Value)
 {
     return InterlockedExchange((LONG*)Target, Value);
@@ -80,3 +94,44 @@ int32_t bit::AtomicPostDecrement(int32_t* Target)
 {
     return InterlockedExchangeAdd((LONG*)Target, -1);
 }
+
+int32_t bit::AtomicLoad(const int32_t* Target)
+{
+    int32_t Value = *(const volatile int32_t*)Target;
+    _ReadWriteBarrier();
+    return Value;
+}
+
+void bit::AtomicStore(int32_t* Target, int32_t Value)
+{
+    _ReadWriteBarrier();
+    *(volatile int32_t*)Target = Value;
+}
+
+void* bit::AtomicExchange(void** Target, void* Value)
+{
+    return InterlockedExchangePointer(Target, Value);
+}
+
+void* bit::AtomicCompareExchange(void** Target, void* Value, void* Comperand)
+{
+    return InterlockedCompareExchangePointer(Target, Value, Comperand);
+}
+
+void* bit::AtomicLoad(void* const* Target)
+{
+    void* Value = *(void* const volatile*)Target;
+    _ReadWriteBarrier();
+    return Value;
+}
+
+void bit::AtomicStore(void** Target, void* Value)
+{
+    _ReadWriteBarrier();
+    *(void* volatile*)Target = Value;
+}
+
+void bit::AtomicFence()
+{
+    MemoryBarrier();
+}
@@ -3,6 +3,7 @@
 /* https://docs.microsoft.com/en-us/windows/win32/dlls/dynamic-link-library-entry-point-function */
 
 extern void BitOSInit();
+extern void BitTlsRunDestructors();
 
 BOOL WINAPI DllMain(
     HINSTANCE hinstDLL,  // handle to DLL module
@@ -25,6 +26,7 @@ BOOL WINAPI DllMain(
 
     case DLL_THREAD_DETACH:
         // Do thread-specific cleanup.
+        BitTlsRunDestructors();
         break;
 
     case DLL_PROCESS_DETACH:
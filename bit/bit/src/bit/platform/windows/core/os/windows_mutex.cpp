@@ -16,6 +16,11 @@ void bit::Mutex::Lock()
 	WaitForSingleObject((HANDLE)Handle, INFINITE);
 }
 
+bool bit::Mutex::TryLock()
+{
+	return WaitForSingleObject((HANDLE)Handle, 0) == WAIT_OBJECT_0;
+}
+
 void bit::Mutex::Unlock()
 {
 	ReleaseMutex((HANDLE)Handle);
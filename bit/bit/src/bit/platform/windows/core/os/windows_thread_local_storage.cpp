@@ -1,14 +1,62 @@
 #include <bit/core/os/debug.h>
 #include <bit/core/os/thread_local_storage.h>
+#include <bit/core/os/atomics.h>
 #include "../../windows_common.h"
 
-bit::TlsHandle bit::TlsAllocSlot()
+/* TlsAlloc doesn't support destructors so we keep track of them here and 
+   run them from DllMain on DLL_THREAD_DETACH. */
+struct TlsDestructorEntry
 {
-	return ::TlsAlloc();
+	bit::TlsHandle Handle;
+	bit::TlsDestructor_t Destructor;
+};
+
+static constexpr int32_t MAX_TLS_DESTRUCTORS = 64;
+static TlsDestructorEntry GTlsDestructors[MAX_TLS_DESTRUCTORS] = {};
+static int32_t GTlsDestructorCount = 0;
+
+void BitTlsRunDestructors()
+{
+	int32_t Count = bit::Min(GTlsDestructorCount, MAX_TLS_DESTRUCTORS);
+	for (int32_t Index = 0; Index < Count; ++Index)
+	{
+		TlsDestructorEntry& Entry = GTlsDestructors[Index];
+		if (Entry.Destructor == nullptr) continue;
+		void* Value = ::TlsGetValue((DWORD)Entry.Handle);
+		if (Value != nullptr)
+		{
+			::TlsSetValue((DWORD)Entry.Handle, nullptr);
+			Entry.Destructor(Value);
+		}
+	}
+}
+
+bit::TlsHandle bit::TlsAllocSlot(TlsDestructor_t Destructor)
+{
+	TlsHandle Handle = (TlsHandle)::TlsAlloc();
+	if (Handle != INVALID_TLS_HANDLE && Destructor != nullptr)
+	{
+		int32_t Index = bit::AtomicPostIncrement(&GTlsDestructorCount);
+		BIT_ASSERT_MSG(Index < MAX_TLS_DESTRUCTORS, "Too many TLS slots with destructors");
+		if (Index < MAX_TLS_DESTRUCTORS)
+		{
+			GTlsDestructors[Index].Handle = Handle;
+			GTlsDestructors[Index].Destructor = Destructor;
+		}
+	}
+	return Handle;
 }
 
 void bit::TlsFreeSlot(TlsHandle Handle)
 {
+	int32_t Count = bit::Min(GTlsDestructorCount, MAX_TLS_DESTRUCTORS);
+	for (int32_t Index = 0; Index < Count; ++Index)
+	{
+		if (GTlsDestructors[Index].Handle == Handle)
+		{
+			GTlsDestructors[Index].Destructor = nullptr;
+		}
+	}
 	::TlsFree((DWORD)Handle);
 }
 
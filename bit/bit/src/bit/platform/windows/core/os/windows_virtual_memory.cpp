@@ -1,6 +1,7 @@
 #include <bit/core/os/virtual_memory.h>
 #include <bit/core/memory.h>
 #include <bit/core/os/debug.h>
+#include <bit/core/os/os.h>
 #include "../../windows_common.h"
 
 static DWORD BitGetProtection(bit::PageProtectionType ProtectionType)
@@ -62,7 +63,7 @@ bool bit::VirtualMemoryBlock::DecommitAll()
 
 void* bit::VirtualMemoryBlock::CommitPagesByAddress(void* Address, size_t Size)
 {
-	if (bit::PtrInRange(Address, BaseAddress, GetEndAddress()) && Size <= ReservedSize)
+	if (bit::PtrInRange(Address, BaseAddress, GetEndAddress()) && Size <= bit::PtrDiff(Address, GetEndAddress()))
 	{
 		void* Pages = VirtualAlloc(Address, Size, MEM_COMMIT, PAGE_READWRITE);
 		if (Pages != nullptr) CommittedSize += Size;
@@ -73,7 +74,7 @@ void* bit::VirtualMemoryBlock::CommitPagesByAddress(void* Address, size_t Size)
 
 bool bit::VirtualMemoryBlock::DecommitPagesByAddress(void* Address, size_t Size)
 {
-	if (bit::PtrInRange(Address, BaseAddress, GetEndAddress()) && Size <= ReservedSize)
+	if (bit::PtrInRange(Address, BaseAddress, GetEndAddress()) && Size <= bit::PtrDiff(Address, GetEndAddress()))
 	{
 		if (VirtualFree(Address, Size, MEM_DECOMMIT))
 		{
@@ -88,7 +89,7 @@ bool bit::VirtualMemoryBlock::DecommitPagesByAddress(void* Address, size_t Size)
 
 bool bit::VirtualMemoryBlock::ProtectPagesByAddress(void* Address, size_t Size, PageProtectionType Protection)
 {
-	if (bit::PtrInRange(Address, BaseAddress, GetEndAddress()) && Size <= ReservedSize)
+	if (bit::PtrInRange(Address, BaseAddress, GetEndAddress()) && Size <= bit::PtrDiff(Address, GetEndAddress()))
 	{
 		DWORD OldProtection = 0;
 		return VirtualProtect(Address, Size, BitGetProtection(Protection), &OldProtection) == TRUE;
@@ -96,6 +97,33 @@ bool bit::VirtualMemoryBlock::ProtectPagesByAddress(void* Address, size_t Size,
 	return false;
 }
 
+bool bit::VirtualMemoryBlock::ZeroPagesByAddress(void* Address, size_t Size)
+{
+	if (bit::PtrInRange(Address, BaseAddress, GetEndAddress()) && Size <= bit::PtrDiff(Address, GetEndAddress()))
+	{
+		uint8_t* Begin = (uint8_t*)Address;
+		uint8_t* End = Begin + Size;
+		uint8_t* PagesBegin = (uint8_t*)bit::AlignPtr(Begin, bit::GetOSPageSize());
+		uint8_t* PagesEnd = (uint8_t*)((uintptr_t)End & ~((uintptr_t)bit::GetOSPageSize() - 1));
+		if (Size < ZERO_PAGES_MIN_SIZE || PagesBegin >= PagesEnd)
+		{
+			bit::StreamZero(Begin, Size);
+			return true;
+		}
+		size_t PagesSize = bit::PtrDiff(PagesBegin, PagesEnd);
+		// Recommitted pages are zero filled by the OS on first touch
+		if (!VirtualFree(PagesBegin, PagesSize, MEM_DECOMMIT) ||
+			VirtualAlloc(PagesBegin, PagesSize, MEM_COMMIT, PAGE_READWRITE) == nullptr)
+		{
+			return false;
+		}
+		bit::StreamZero(Begin, bit::PtrDiff(Begin, PagesBegin));
+		bit::StreamZero(PagesEnd, bit::PtrDiff(PagesEnd, End));
+		return true;
+	}
+	return false;
+}
+
 void* bit::VirtualMemoryBlock::CommitPagesByOffset(size_t Offset, size_t Size)
 {
 	return CommitPagesByAddress(GetAddress(Offset), Size);
@@ -111,6 +139,11 @@ bool bit::VirtualMemoryBlock::ProtectPagesByOffset(size_t Offset, size_t Size, P
 	return ProtectPagesByAddress(GetAddress(Offset), Size, Protection);
 }
 
+bool bit::VirtualMemoryBlock::ZeroPagesByOffset(size_t Offset, size_t Size)
+{
+	return ZeroPagesByAddress(GetAddress(Offset), Size);
+}
+
 void* bit::VirtualMemoryBlock::GetBaseAddress() const
 {
 	return BaseAddress;
@@ -183,3 +216,35 @@ void bit::VirtualFreeBlock(bit::VirtualMemoryBlock& VirtualMemoryRegion)
 		VirtualFree(Base, Size, MEM_RELEASE);
 	}
 }
+
+/* MEM_LARGE_PAGES requires the SeLockMemoryPrivilege. Without it we fall back to regular pages. */
+void* bit::VirtualAllocateLargePages(size_t Size, size_t& OutSize, LargePageType& OutPageType)
+{
+	size_t LargePageSize = GetLargePageMinimum();
+	if (LargePageSize > 0)
+	{
+		size_t LargeSize = bit::RoundUp(Size, LargePageSize);
+		void* Ptr = VirtualAlloc(nullptr, LargeSize, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+		if (Ptr != nullptr)
+		{
+			OutSize = LargeSize;
+			OutPageType = LargePageType::LARGE_PAGE_TYPE_2MIB;
+			return Ptr;
+		}
+	}
+
+	size_t RegularSize = bit::RoundUp(Size, bit::GetOSPageSize());
+	void* Ptr = VirtualAlloc(nullptr, RegularSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	if (Ptr == nullptr) return nullptr;
+	OutSize = RegularSize;
+	OutPageType = LargePageType::LARGE_PAGE_TYPE_NONE;
+	return Ptr;
+}
+
+void bit::VirtualFreeLargePages(void* Address, size_t Size)
+{
+	if (Address != nullptr)
+	{
+		VirtualFree(Address, 0, MEM_RELEASE);
+	}
+}
@@ -0,0 +1,202 @@
+#include <bit/utility/epoch_reclaimer.h>
+#include <bit/core/memory.h>
+#include <bit/core/memory/allocator.h>
+#include <bit/core/os/atomics.h>
+#include <bit/core/os/thread.h>
+#include <bit/core/os/thread_local_storage.h>
+#include <bit/utility/scope_lock.h>
+
+static constexpr int32_t EPOCH_LEASE_UNASSIGNED = -1;
+static constexpr int32_t EPOCH_LEASE_NONE = -2; // Every lease was taken or the thread is exiting
+
+static int32_t GEpochLeases[bit::EpochReclaimer::LEASED_SLOT_COUNT];
+static int32_t GEpochLeaseTlsSlot = (int32_t)bit::INVALID_TLS_HANDLE;
+static int64_t GEpochThreadCount = 0;
+static BIT_THREAD_LOCAL int32_t GEpochThreadLease = EPOCH_LEASE_UNASSIGNED;
+static BIT_THREAD_LOCAL int64_t GEpochThreadHint = 0;
+
+/* Runs on thread exit. The thread can't be inside any reclaimer anymore so its slots are all free. */
+static void BitReleaseEpochLease(void* Value)
+{
+	GEpochThreadLease = EPOCH_LEASE_NONE;
+	bit::AtomicStore(&GEpochLeases[(intptr_t)Value - 1], 0);
+}
+
+/* The TLS slot is only used to give the lease back when the thread exits */
+static int32_t BitAcquireEpochLease()
+{
+	int32_t TlsSlot = bit::AtomicLoad(&GEpochLeaseTlsSlot);
+	if (TlsSlot == (int32_t)bit::INVALID_TLS_HANDLE)
+	{
+		int32_t NewSlot = (int32_t)bit::TlsAllocSlot(&BitReleaseEpochLease);
+		TlsSlot = bit::AtomicCompareExchange(&GEpochLeaseTlsSlot, NewSlot, (int32_t)bit::INVALID_TLS_HANDLE);
+		if (TlsSlot == (int32_t)bit::INVALID_TLS_HANDLE)
+		{
+			TlsSlot = NewSlot;
+		}
+		else
+		{
+			bit::TlsFreeSlot((bit::TlsHandle)NewSlot);
+		}
+	}
+	if (TlsSlot == (int32_t)bit::INVALID_TLS_HANDLE) return EPOCH_LEASE_NONE;
+	for (int32_t Lease = 0; Lease < bit::EpochReclaimer::LEASED_SLOT_COUNT; ++Lease)
+	{
+		if (bit::AtomicLoad(&GEpochLeases[Lease]) == 0 && bit::AtomicCompareExchange(&GEpochLeases[Lease], 1, 0) == 0)
+		{
+			bit::TlsSetValue((bit::TlsHandle)TlsSlot, (void*)(intptr_t)(Lease + 1));
+			return Lease;
+		}
+	}
+	return EPOCH_LEASE_NONE;
+}
+
+bit::EpochReclaimer::EpochReclaimer(IAllocator& InAllocator) :
+	GlobalEpoch(0),
+	Retired(nullptr),
+	RetiredCount(0),
+	RetiredCapacity(0),
+	RetiresSinceCollect(0),
+	Allocator(&InAllocator)
+{
+	for (ReaderSlot& Slot : Slots)
+	{
+		Slot.State = 0;
+	}
+}
+
+bit::EpochReclaimer::~EpochReclaimer()
+{
+	Clear();
+	if (Retired != nullptr)
+	{
+		Allocator->Free(Retired);
+	}
+}
+
+int32_t bit::EpochReclaimer::Enter()
+{
+	int32_t Lease = GEpochThreadLease;
+	if (Lease == EPOCH_LEASE_UNASSIGNED)
+	{
+		Lease = BitAcquireEpochLease();
+		GEpochThreadLease = Lease;
+	}
+	// Only this thread writes its leased slot so a busy one means a nested reader
+	if (Lease >= 0 && Slots[Lease].State == 0)
+	{
+		int64_t Epoch = AtomicLoadInline(&GlobalEpoch);
+		for (;;)
+		{
+			// The exchange is a full barrier, it orders the announcement before any load of
+			// shared data and costs less than a store and a fence. Retrying when the epoch
+			// moved meanwhile keeps the announced epoch current.
+			AtomicExchange(&Slots[Lease].State, (Epoch << 1) | 1);
+			int64_t CurrentEpoch = AtomicLoadInline(&GlobalEpoch);
+			if (CurrentEpoch == Epoch) return Lease;
+			Epoch = CurrentEpoch;
+		}
+	}
+
+	// Every thread gets an ordinal so threads start probing at different shared slots
+	if (GEpochThreadHint == 0)
+	{
+		GEpochThreadHint = AtomicIncrement(&GEpochThreadCount);
+	}
+	const int32_t SHARED_SLOT_COUNT = READER_SLOT_COUNT - LEASED_SLOT_COUNT;
+	int32_t Slot = LEASED_SLOT_COUNT + (int32_t)(GEpochThreadHint % SHARED_SLOT_COUNT);
+	for (int32_t Probe = 1;; ++Probe)
+	{
+		int64_t Epoch = AtomicLoad(&GlobalEpoch);
+		if (AtomicLoad(&Slots[Slot].State) == 0 && AtomicCompareExchange(&Slots[Slot].State, (Epoch << 1) | 1, 0) == 0)
+		{
+			return Slot;
+		}
+		Slot = Slot + 1 < READER_SLOT_COUNT ? Slot + 1 : LEASED_SLOT_COUNT;
+		if (Probe % SHARED_SLOT_COUNT == 0)
+		{
+			Thread::YieldThread();
+		}
+	}
+}
+
+void bit::EpochReclaimer::Exit(int32_t Slot)
+{
+	AtomicStoreInline(&Slots[Slot].State, (int64_t)0);
+}
+
+void bit::EpochReclaimer::Retire(void* Pointer, Deleter_t Deleter, void* Context)
+{
+	bool bCollect = false;
+	{
+		ScopedLock<Mutex> Lock(&RetireLock);
+		if (RetiredCount == RetiredCapacity)
+		{
+			int64_t NewCapacity = RetiredCapacity > 0 ? RetiredCapacity * 2 : COLLECT_INTERVAL;
+			RetiredPointer* NewRetired = (RetiredPointer*)Allocator->Allocate(sizeof(RetiredPointer) * NewCapacity, alignof(RetiredPointer));
+			if (Retired != nullptr)
+			{
+				Memcpy(NewRetired, Retired, sizeof(RetiredPointer) * RetiredCount);
+				Allocator->Free(Retired);
+			}
+			Retired = NewRetired;
+			RetiredCapacity = NewCapacity;
+		}
+		// The read-modify-write orders the epoch read after the caller unlinked Pointer. A stale
+		// epoch would let Pointer be freed while a reader that found it is still inside.
+		Retired[RetiredCount++] = { Pointer, Deleter, Context, AtomicAdd(&GlobalEpoch, 0) };
+		bCollect = ++RetiresSinceCollect >= COLLECT_INTERVAL;
+	}
+	if (bCollect)
+	{
+		Collect();
+	}
+}
+
+size_t bit::EpochReclaimer::Collect()
+{
+	ScopedLock<Mutex> Lock(&RetireLock);
+	RetiresSinceCollect = 0;
+	TryAdvance();
+	return FreeRetired(AtomicLoad(&GlobalEpoch) - 2);
+}
+
+void bit::EpochReclaimer::Clear()
+{
+	ScopedLock<Mutex> Lock(&RetireLock);
+	FreeRetired(INT64_MAX);
+}
+
+bool bit::EpochReclaimer::TryAdvance()
+{
+	int64_t Epoch = AtomicLoad(&GlobalEpoch);
+	for (const ReaderSlot& Slot : Slots)
+	{
+		int64_t State = AtomicLoad(&Slot.State);
+		if (State != 0 && (State >> 1) != Epoch)
+		{
+			return false;
+		}
+	}
+	return AtomicCompareExchange(&GlobalEpoch, Epoch + 1, Epoch) == Epoch;
+}
+
+size_t bit::EpochReclaimer::FreeRetired(int64_t MaxEpoch)
+{
+	// Retired is sorted by epoch since entries are appended under the lock
+	int64_t FreeCount = 0;
+	while (FreeCount < RetiredCount && Retired[FreeCount].Epoch <= MaxEpoch)
+	{
+		RetiredPointer& Entry = Retired[FreeCount++];
+		Entry.Deleter(Entry.Context, Entry.Pointer);
+	}
+	if (FreeCount > 0)
+	{
+		for (int64_t Index = FreeCount; Index < RetiredCount; ++Index)
+		{
+			Retired[Index - FreeCount] = Retired[Index];
+		}
+		RetiredCount -= FreeCount;
+	}
+	return (size_t)FreeCount;
+}
@@ -0,0 +1,173 @@
+#include <bit/utility/wy_hash.h>
+#include <string.h>
+
+// Based on wyhash final version 4 by Wang Yi (public domain)
+// https://github.com/wangyi-fudan/wyhash
+
+static constexpr uint64_t WY_SECRET[4] = { 0x2D358DCCAA6C78A5ULL, 0x8BB84B93962EACC9ULL, 0x4B33A62ED433D4A3ULL, 0x4D5A2DA51DE1AA47ULL };
+
+static BIT_FORCEINLINE void BitWyMultiply(uint64_t& A, uint64_t& B)
+{
+#if defined(__SIZEOF_INT128__)
+	__uint128_t Product = (__uint128_t)A * B;
+	A = (uint64_t)Product;
+	B = (uint64_t)(Product >> 64);
+#elif BIT_PLATFORM_WINDOWS && BIT_PLATFORM_X64
+	A = _umul128(A, B, &B);
+#else
+	uint64_t Fold = bit::MultiplyFold(A, B);
+	uint64_t Low = A * B;
+	A = Low;
+	B = Fold ^ Low;
+#endif
+}
+
+static BIT_FORCEINLINE uint64_t BitWyMix(uint64_t A, uint64_t B)
+{
+	BitWyMultiply(A, B);
+	return A ^ B;
+}
+
+static BIT_FORCEINLINE uint64_t BitWyRead8(const uint8_t* Data)
+{
+	uint64_t Value;
+	memcpy(&Value, Data, sizeof(Value)); // Unaligned read, compiles to a single load
+	return Value;
+}
+
+static BIT_FORCEINLINE uint64_t BitWyRead4(const uint8_t* Data)
+{
+	uint32_t Value;
+	memcpy(&Value, Data, sizeof(Value));
+	return Value;
+}
+
+static BIT_FORCEINLINE uint64_t BitWyStart(uint64_t Seed)
+{
+	return Seed ^ BitWyMix(Seed ^ WY_SECRET[0], WY_SECRET[1]);
+}
+
+/* Mixes the last 1 to 48 bytes of an input longer than 16 bytes. At least 16 bytes
+   must be readable before Data + Left. */
+static size_t BitWyFinish(uint64_t State, const uint8_t* Data, size_t Left, size_t Len)
+{
+	while (Left > 16)
+	{
+		State = BitWyMix(BitWyRead8(Data) ^ WY_SECRET[1], BitWyRead8(Data + 8) ^ State);
+		Data += 16;
+		Left -= 16;
+	}
+	// The last 16 bytes, overlapping what was already mixed when Left < 16
+	uint64_t A = BitWyRead8(Data + Left - 16) ^ WY_SECRET[1];
+	uint64_t B = BitWyRead8(Data + Left - 8) ^ State;
+	BitWyMultiply(A, B);
+	return (size_t)BitWyMix(A ^ WY_SECRET[0] ^ Len, B ^ WY_SECRET[1]);
+}
+
+size_t bit::WyHash(const void* Key, size_t Len, size_t Seed)
+{
+	const uint8_t* Data = (const uint8_t*)Key;
+	uint64_t State = BitWyStart((uint64_t)Seed);
+	uint64_t A = 0;
+	uint64_t B = 0;
+	if (Len <= 16)
+	{
+		if (Len >= 4)
+		{
+			// Two overlapping 4 byte reads from each end cover every length from 4 to 16
+			size_t Middle = (Len >> 3) << 2;
+			A = (BitWyRead4(Data) << 32) | BitWyRead4(Data + Middle);
+			B = (BitWyRead4(Data + Len - 4) << 32) | BitWyRead4(Data + Len - 4 - Middle);
+		}
+		else if (Len > 0)
+		{
+			A = ((uint64_t)Data[0] << 16) | ((uint64_t)Data[Len >> 1] << 8) | Data[Len - 1];
+		}
+	}
+	else
+	{
+		size_t Left = Len;
+		if (Left > 48)
+		{
+			uint64_t Lane1 = State;
+			uint64_t Lane2 = State;
+			do
+			{
+				State = BitWyMix(BitWyRead8(Data) ^ WY_SECRET[1], BitWyRead8(Data + 8) ^ State);
+				Lane1 = BitWyMix(BitWyRead8(Data + 16) ^ WY_SECRET[2], BitWyRead8(Data + 24) ^ Lane1);
+				Lane2 = BitWyMix(BitWyRead8(Data + 32) ^ WY_SECRET[3], BitWyRead8(Data + 40) ^ Lane2);
+				Data += 48;
+				Left -= 48;
+			} while (Left > 48);
+			State ^= Lane1 ^ Lane2;
+		}
+		return BitWyFinish(State, Data, Left, Len);
+	}
+	A ^= WY_SECRET[1];
+	B ^= State;
+	BitWyMultiply(A, B);
+	return (size_t)BitWyMix(A ^ WY_SECRET[0] ^ Len, B ^ WY_SECRET[1]);
+}
+
+bit::WyHasher::WyHasher(size_t InSeed)
+{
+	Init(InSeed);
+}
+
+void bit::WyHasher::Init(size_t InSeed)
+{
+	Seed = (uint64_t)InSeed;
+	State = BitWyStart(Seed);
+	Lanes[0] = State;
+	Lanes[1] = State;
+	TotalLength = 0;
+	PendingLength = 0;
+}
+
+void bit::WyHasher::Update(const void* Data, size_t Len)
+{
+	const uint8_t* Input = (const uint8_t*)Data;
+	TotalLength += Len;
+	if (PendingLength + Len <= STRIPE_SIZE)
+	{
+		memcpy(Pending + PendingLength, Input, Len);
+		PendingLength += Len;
+		return;
+	}
+	// More data follows the pending bytes so they can be completed to a stripe and consumed
+	if (PendingLength > 0)
+	{
+		size_t Fill = STRIPE_SIZE - PendingLength;
+		memcpy(Pending + PendingLength, Input, Fill);
+		ConsumeStripe(Pending);
+		Input += Fill;
+		Len -= Fill;
+		PendingLength = 0;
+	}
+	while (Len > STRIPE_SIZE)
+	{
+		ConsumeStripe(Input);
+		Input += STRIPE_SIZE;
+		Len -= STRIPE_SIZE;
+	}
+	memcpy(Pending, Input, Len);
+	PendingLength = Len;
+}
+
+size_t bit::WyHasher::Final() const
+{
+	// Nothing was consumed yet, the whole input is still pending
+	if (TotalLength <= STRIPE_SIZE) return WyHash(Pending, TotalLength, (size_t)Seed);
+	uint8_t Window[HISTORY_SIZE + STRIPE_SIZE];
+	memcpy(Window, History, HISTORY_SIZE);
+	memcpy(Window + HISTORY_SIZE, Pending, PendingLength);
+	return BitWyFinish(State ^ Lanes[0] ^ Lanes[1], Window + HISTORY_SIZE, PendingLength, TotalLength);
+}
+
+void bit::WyHasher::ConsumeStripe(const uint8_t* Stripe)
+{
+	State = BitWyMix(BitWyRead8(Stripe) ^ WY_SECRET[1], BitWyRead8(Stripe + 8) ^ State);
+	Lanes[0] = BitWyMix(BitWyRead8(Stripe + 16) ^ WY_SECRET[2], BitWyRead8(Stripe + 24) ^ Lanes[0]);
+	Lanes[1] = BitWyMix(BitWyRead8(Stripe + 32) ^ WY_SECRET[3], BitWyRead8(Stripe + 40) ^ Lanes[1]);
+	memcpy(History, Stripe + STRIPE_SIZE - HISTORY_SIZE, HISTORY_SIZE);
+}
@@ -8,6 +8,7 @@
 #include <bit/core/os/debug.h>
 #include <bit/utility/prof_timer.h>
 #include <bit/container/hash_table.h>
+#include <bit/container/concurrent_hash_table.h>
 #include <bit/container/linked_list.h>
 #include <bit/container/intrusive_linked_list.h>
 #include <bit/core/memory/linear_allocator.h>
@@ -17,7 +18,6 @@
 #include <bit/container/string.h>
 #include <bit/utility/scope_lock.h>
 #include <bit/core/os/mutex.h>
-#include <bit/core/os/rw_lock.h>
 
 struct MyValue : public bit::IntrusiveLinkedList<MyValue>
 {
@@ -73,7 +73,7 @@ int main(int32_t Argc, const char* Argv[])
 			auto RandSize = [](size_t MaxSize)
 			{
 				double Rand = (double)rand() / (double)RAND_MAX;
-				return bit::Max((size_t)((double)MaxSize * Rand), 8ULL);
+				return bit::Max((size_t)((double)MaxSize * Rand), (size_t)8);
 			};
 
 			for (int32_t Index = 0; Index < 10000; ++Index)
@@ -165,13 +165,12 @@ int main(int32_t Argc, const char* Argv[])
 
 			bit::CriticalSection CS;
 			bit::Mutex Mtx;
-			bit::RWLock RWLock;
 			bit::Array<bit::Thread> Threads;
+			bit::ConcurrentHashTable<int32_t, int32_t> SharedTable;
 
 			struct Payload
 			{
-				bit::HashTable<int32_t, int32_t>* HashTable;
-				bit::RWLock* Lock;
+				bit::ConcurrentHashTable<int32_t, int32_t>* HashTable;
 				int32_t Value;
 			};
 
@@ -180,7 +179,7 @@ int main(int32_t Argc, const char* Argv[])
 			for (int32_t Value : MyArray)
 			{
 				Threads.Add(bit::Move(bit::Thread()));
-				PayloadData.Add({ &Table, &RWLock, Value });
+				PayloadData.Add({ &SharedTable, Value });
 				List.Insert(Value);
 			}
 
@@ -195,8 +194,6 @@ int main(int32_t Argc, const char* Argv[])
 				Threads[Index].Start([](void* UserData) -> int32_t
 				{
 					Payload& Data = *(Payload*)UserData;
-					//bit::TScopedLock<bit::CMutex> Lock(Data.Lock);
-					bit::ScopedRWLock Lock(Data.Lock, bit::RWLockType::LOCK_READ_WRITE);
 					BIT_LOG("Value = %d\n", Data.Value);
 					Data.HashTable->Insert(Data.Value, Data.Value);
 					return 0;
@@ -211,13 +208,14 @@ int main(int32_t Argc, const char* Argv[])
 			int32_t idx = 0;
 			int32_t LastKey = 0;
 			int32_t LastValue = 0;
-			for (auto Iter = Table.cbegin(); Iter != Table.cend(); ++Iter)
+			SharedTable.ForEach([&](const int32_t& Key, const int32_t& Value)
 			{
-				BIT_LOG("%d = %d\n", Iter->Key, Iter->Value);
-				LastKey = Iter->Key;
-				LastValue = Iter->Value;
+				BIT_LOG("%d = %d\n", Key, Value);
+				LastKey = Key;
+				LastValue = Value;
 				idx++;
-			}
+			});
+			BIT_ASSERT(idx == SharedTable.GetCount());
 
 			if (TestIndex == IterCount - 1)
 			{